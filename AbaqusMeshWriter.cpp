@@ -1,5 +1,5 @@
 #include "Global.h"
-#include "Node.h"
+#include "NodeStore.h"
 #include "Element.h"
 
 
@@ -38,23 +38,21 @@ void                     writeAbaqusMesh
   const int elemCount    = globdat.elemSet.size      ();
   const int bndElemCount = globdat.bndElementSet.size();
 
-  NodePointer np;
+  const NodeStore& nodes = globdat.newNodeSet;
 
   for ( int in = 0; in < nodeCount; in ++ )
   {
-    np = globdat.newNodeSet[in];
- 
     if ( !globdat.is3D )
     {
-      file << np->getIndex() 
-           << ", " << np->getX() << ", " << np->getY() << "\n";
+      file << nodes.getIndex(in) 
+           << ", " << nodes.getX(in) << ", " << nodes.getY(in) << "\n";
     }
     else
     {
-      file << np->getIndex() << ", " 
-	   << np->getX() << ", " 
-	   << np->getY() << ", "
-	   << np->getZ() << "\n";
+      file << nodes.getIndex(in) << ", " 
+	   << nodes.getX(in) << ", " 
+	   << nodes.getY(in) << ", "
+	   << nodes.getZ(in) << "\n";
     }
   }
 
@@ -93,7 +91,6 @@ void                     writeAbaqusMesh
   const int   ieCount = globdat.interfaceSet.size ();
   const int   inCount = globdat.nodeSet.     size ();
 
-  IntVector   connec;
   IntVector   dupNodes;
 
   int         index;
@@ -105,7 +102,7 @@ void                     writeAbaqusMesh
 
     file << ep->getIndex() << ", "; 
 
-    ep->getConnectivity ( connec );
+    const IntSpan connec = ep->getNodes ();
 
     copy ( connec.begin(), 
 	   connec.end()-1, 
@@ -1,219 +1,684 @@
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
 #include "Global.h"
-#include "Node.h"
+#include "NodeStore.h"
 #include "Element.h"
+#include "MeshReader.h"
+#include "TextScanner.h"
+
+/*
+ * Keyword driven reader for Abaqus input files. The file is read in
+ * large chunks and handled line by line; only the keywords *NODE,
+ * *ELEMENT, *ELSET and *NSET are used, the data lines of all other
+ * keywords are skipped. No counts are needed and blocks may come in
+ * any number and order.
+ *
+ * Every element set becomes a domain (dom2Elems, elem2Domain), every
+ * node set a group of bndNodesMap. A set named by an integer gets that
+ * number, other names are numbered after the largest integer name in
+ * the order they appear. If an element is in several sets, the set it
+ * was added to last wins, so that material sets given after the
+ * elements override the ELSET parameter of *ELEMENT.
+ *
+ * Elements are numbered 0,1,... in file order. Element types that are
+ * not 2D or 3D continuum elements (user elements, beams, shells, ...)
+ * are skipped.
+ */
+
+typedef map<string,string>   Str2StrMap;
+typedef map<string,int>      Str2IntMap;
+typedef set<string>          StrSet;
+
+// ---------------------------------------------------------------------
+//     class InpLineReader
+// ---------------------------------------------------------------------
+
+// gives the lines of a file read in chunks of CHUNK_SIZE bytes;
+// a line stays valid until the next call of nextLine
+
+class InpLineReader
+{
+  public:
 
+    explicit       InpLineReader ( const char* fileName )
 
-#include <boost/algorithm/string.hpp>
+      : file_(fileName, std::ios::in | std::ios::binary),
+        buffer_(CHUNK_SIZE), first_(0), last_(0) {}
 
+    bool           isOpen   () const { return file_.is_open (); }
 
-void                     readAbaqusMesh 
+    bool           nextLine
 
-    ( Global&     globdat,
-      const char* fileName )
+      ( const char*&  first,
+        const char*&  last )
+    {
+      const char* end;
+
+      while ( ( end = (const char*) memchr ( &buffer_[first_], '\n',
+                                             last_ - first_ ) ) == 0 )
+      {
+        if ( !fill_ () )
+        {
+          if ( first_ == last_ ) return false;
+
+          end = &buffer_[0] + last_;   // last line without line break
+          break;
+        }
+      }
+
+      first  = &buffer_[first_];
+      last   = end;
+      first_ = min ( size_t( end - &buffer_[0] ) + 1, last_ );
+
+      if ( last > first && last[-1] == '\r' ) last--;
+
+      return true;
+    }
+
+  private:
+
+    // move the incomplete line to the front and read the next chunk
+
+    bool           fill_    ()
+    {
+      if ( !file_ ) return false;
+
+      memmove ( &buffer_[0], &buffer_[first_], last_ - first_ );
+
+      last_ -= first_;
+      first_ = 0;
+
+      if ( buffer_.size () - last_ < CHUNK_SIZE / 2 )
+      {
+        buffer_.resize ( buffer_.size () + CHUNK_SIZE );
+      }
+
+      file_.read ( &buffer_[last_], buffer_.size () - last_ );
+
+      last_ += file_.gcount ();
+
+      return file_.gcount () > 0;
+    }
+
+  private:
+
+    static const size_t  CHUNK_SIZE = 1 << 20;
+
+    ifstream       file_;
+    vector<char>   buffer_;
+    size_t         first_;    // start of the next line in buffer_
+    size_t         last_;     // end of the data in buffer_
+};
+
+// ---------------------------------------------------------------------
+//     class InpSets
+// ---------------------------------------------------------------------
+
+// named sets in the order of their first appearance
+
+class InpSets
 {
-  ifstream file ( fileName, std::ios::in );
+  public:
+
+    int            getIndex ( const string& name )
+    {
+      Str2IntMap::iterator it = index_.find ( name );
+
+      if ( it != index_.end () ) return it->second;
+
+      names.push_back   ( name );
+      members.push_back ( IntVector() );
+
+      return index_[name] = names.size () - 1;
+    }
+
+    const IntVector*  find  ( const string& name ) const
+    {
+      Str2IntMap::const_iterator it = index_.find ( name );
+
+      return it == index_.end () ? 0 : &members[it->second];
+    }
+
+    // group number of every set, see the comment at the top
+
+    void           getNumbers ( IntVector& numbers ) const
+    {
+      int next = 0;
+
+      numbers.assign ( names.size (), -1 );
+
+      for ( size_t is = 0; is < names.size (); is++ )
+      {
+        const char* first = names[is].c_str ();
+        char*       end;
+
+        long number = strtol ( first, &end, 10 );
+
+        if ( *first != '\0' && *end == '\0' )
+        {
+          numbers[is] = number;
+          next        = max ( next, int( number ) );
+        }
+      }
+
+      for ( size_t is = 0; is < names.size (); is++ )
+      {
+        if ( numbers[is] < 0 )
+        {
+          numbers[is] = ++next;
+
+          cout << "Set " << names[is] << " => group " << next << endl;
+        }
+      }
+    }
+
+  public:
+
+    StrVector           names;
+    vector<IntVector>   members;
+
+  private:
+
+    Str2IntMap          index_;
+};
+
+// ---------------------------------------------------------------------
+//     line parsing
+// ---------------------------------------------------------------------
 
-  if ( !file ) 
+// upper case copy of [first,last) without surrounding blanks
+
+static string            trimUpper
+
+    ( const char*  first,
+      const char*  last )
+{
+  while ( first < last && isspace ( first[0] ) ) first++;
+  while ( last > first && isspace ( last[-1] ) ) last--;
+
+  string word ( first, last );
+
+  for ( size_t i = 0; i < word.size (); i++ )
   {
-    cout << "Unable to open mesh file!!!\n\n";
-    exit(1);
+    word[i] = toupper ( word[i] );
   }
 
-  int             id;
-  int             length;
-  int             matId;
-  int             elemNode;
-  int             elemType, paraElemType;
+  return word;
+}
 
-  double          x,y,z;
+// splits "*KEYWORD, PARAM=VALUE, FLAG" into the keyword and
+// its parameters (flags get an empty value)
 
-  StrVector       splitLine;
-  IntVector       connectivity;
+static string            readKeyword
 
-  string  line;
+    ( Str2StrMap&  params,
+      const char*  first,
+      const char*  last )
+{
+  const char* comma = (const char*) memchr ( first, ',', last - first );
 
-  cout << "Reading Abaqus mesh file ...\n";
-  cout << "Reading nodes...\n";
+  string keyword = trimUpper ( first + 1, comma ? comma : last );
+
+  params.clear ();
+
+  while ( comma )
+  {
+    const char* begin = comma + 1;
+
+    comma = (const char*) memchr ( begin, ',', last - begin );
+
+    const char* end   = comma ? comma : last;
+    const char* equal = (const char*) memchr ( begin, '=', end - begin );
+
+    if ( equal )
+    {
+      params[trimUpper ( begin, equal )] = trimUpper ( equal + 1, end );
+    }
+    else
+    {
+      params[trimUpper ( begin, end )] = "";
+    }
+  }
+
+  return keyword;
+}
+
+// appends the comma separated integers of a line to values;
+// a trailing comma is allowed
 
-  for (int i = 0; i < 9; i++)
+static void              readIntLine
+
+    ( IntVector&   values,
+      const char*  first,
+      const char*  last )
+{
+  TextScanner scanner ( first, last );
+
+  do
   {
-	  getline(file, line);
+    if ( scanner.atEndOfLine () ) break;
+
+    values.push_back ( scanner.readInt () );
   }
+  while ( scanner.skipChar ( ',' ) );
+}
 
-  getline ( file, line );
+// appends the members given on a data line of *ELSET or *NSET:
+// ids or names of sets defined before, or start, end, increment
+// if generate is true
 
-  const int nodeCount = boost::lexical_cast<int> ( line );
+static void              readSetLine
 
-  for ( int in = 0; in < nodeCount; in++ )
+    ( IntVector&      members,
+      const InpSets&  sets,
+      bool            generate,
+      const char*     first,
+      const char*     last )
+{
+  IntVector  ids;
+
+  while ( first < last )
   {
-	  getline(file, line);
-	  boost::erase_all(line, " ");
+    const char* comma = (const char*) memchr ( first, ',', last - first );
+    const char* end   = comma ? comma : last;
 
-	  boost::split(splitLine, line, boost::is_any_of(","));
+    string      token = trimUpper ( first, end );
 
-	  length = splitLine.size();
+    if ( token.empty () )
+    {
+    }
+    else if ( isdigit ( token[0] ) || token[0] == '-' || token[0] == '+' )
+    {
+      TextScanner scanner ( token.data(), token.data() + token.size() );
 
-	  id = boost::lexical_cast<int> (splitLine[0]);
-	  x = boost::lexical_cast<double> (splitLine[1]);
-	  y = boost::lexical_cast<double> (splitLine[2]);
-	  if (length > 3)
-	  {
-		  z = boost::lexical_cast<double> (splitLine[3]);
-		  globdat.is3D = true;
-	  }
+      ids.push_back ( scanner.readInt () );
+    }
+    else
+    {
+      const IntVector* set = sets.find ( token );
 
+      if ( set == 0 || generate )
+      {
+        cerr << "unknown set " << token << " in Abaqus file!!!\n";
+        exit(1);
+      }
 
-    globdat.nodeSet.push_back ( NodePointer( new Node(x,y,z,id) ) );
+      members.insert ( members.end(), set->begin(), set->end() );
+    }
 
-    globdat.nodeId2Position[id] = globdat.nodeSet.size()-1;
+    first = end + 1;
   }
 
+  if ( !generate )
+  {
+    members.insert ( members.end(), ids.begin(), ids.end() );
+    return;
+  }
 
-  cout << "Reading nodes...done!\n\n";
+  if ( ids.size () < 2 )
+  {
+    cerr << "invalid GENERATE line in Abaqus file!!!\n";
+    exit(1);
+  }
 
-  cout << "Reading elements...\n";
+  const int inc = ids.size () > 2 ? ids[2] : 1;
 
-  getline(file, line);
-  std::size_t found = line.find("type=");
-  elemNode = boost::lexical_cast<int> (line[found + 8]);
-  if (elemNode == 3)
+  for ( int id = ids[0]; inc > 0 && id <= ids[1]; id += inc )
   {
-	  elemType = 2;
+    members.push_back ( id );
   }
-  else if (elemNode == 4)
+}
+
+// ---------------------------------------------------------------------
+//     element types
+// ---------------------------------------------------------------------
+
+// Gmsh type of an Abaqus element (CPS4R, CAX8, C3D10, ...), -1 if it
+// is not a 2D or 3D continuum element of the supported kinds
+
+static int               abaqusElemType
+
+    ( int&           nodeCount,
+      bool&          is3D,
+      const string&  name )
+{
+  size_t pos = 0;
+
+  is3D = name.compare ( 0, 3, "C3D" ) == 0;
+
+  if ( is3D )
   {
-	  elemType = 3;
+    pos = 3;
   }
-  else if (elemNode == 8)
+  else if ( name.compare ( 0, 2, "CP" ) == 0 ||   // CPS, CPE
+            name.compare ( 0, 2, "CA" ) == 0 ||   // CAX
+            name.compare ( 0, 3, "CGA" ) == 0 )   // CGAX
   {
-	  elemType = 5;
+    while ( pos < name.size () && isalpha ( name[pos] ) ) pos++;
   }
   else
   {
-	  cerr << "element type is not supported!\n";
-	  exit(1);
+    return -1;
   }
-  matId = 1;
 
-  getline(file, line);
-  const int elemCount = boost::lexical_cast<int> (line);
+  nodeCount = atoi ( name.c_str () + pos );
 
-  for ( int ie = 0; ie < elemCount; ie++ )
+  if ( is3D )
   {
-    getline ( file, line );
-	boost::erase_all(line, " ");
+    switch ( nodeCount )
+    {
+      case  4: return  4;
+      case  8: return  5;
+      case 10: return 11;
+      case 20: return 17;
+    }
+  }
+  else
+  {
+    switch ( nodeCount )
+    {
+      case  3: return  2;
+      case  4: return  3;
+      case  6: return  9;
+      case  8: return 16;
+    }
+  }
+
+  return -1;
+}
 
-    boost::split ( splitLine, line, boost::is_any_of(",") );
+// the node numbering of Abaqus and Gmsh differs for the quadratic
+// solids: Gmsh node i is Abaqus node order[i]
 
-    length       = splitLine.size ();
-   
-    // material => elements
-    // element  => material (domain)
+static void              toGmshOrder
 
-    globdat.dom2Elems[matId].push_back ( ie );
-    globdat.elem2Domain[ie] = matId;
+    ( IntVector&  connectivity,
+      int         elemType )
+{
+  static const int TET10[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 9, 8 };
 
-    // the rest are solid elements 
-    // either 2D solid elements or 3D solid elements
+  static const int HEX20[20] = { 0,  1,  2,  3,  4,  5,  6,  7,
+                                 8, 11, 16,  9, 17, 10, 18, 19,
+                                12, 15, 13, 14 };
 
-    // read connectivity 
+  const int* order;
 
-    connectivity.clear ();
+  if      ( elemType == 11 ) order = TET10;
+  else if ( elemType == 17 ) order = HEX20;
+  else    return;
 
-    transform ( splitLine.begin()+1, 
-	        splitLine.end  (), 
-		back_inserter(connectivity), 
-		Str2IntFunctor() );
+  IntVector abaqus ( connectivity );
 
-    globdat.elemSet.push_back ( ElemPointer ( new Element ( ie, elemType, connectivity ) )  );
+  for ( size_t in = 0; in < connectivity.size (); in++ )
+  {
+    connectivity[in] = abaqus[order[in]];
+  }
+}
+
+// =====================================================================
+//     readAbaqusMesh
+// =====================================================================
+
+void                     readAbaqusMesh
+
+    ( Global&     globdat,
+      const char* fileName )
+{
+  InpLineReader   file ( fileName );
 
-    globdat.elemId2Position[ie] = globdat.elemSet.size() - 1;
+  if ( !file.isOpen () )
+  {
+    cout << "Unable to open mesh file!!!\n\n";
+    exit(1);
   }
 
-  cout << "Reading elements...done!\n\n";
+  enum            Block { OTHER, NODE, ELEMENT, ELSET, NSET };
+
+  Block           block     = OTHER;
+
+  int             id;
+  int             elemType  = -1;
+  int             elemNode  = 0;
+  int             setIndex  = -1;
+  int             nodeElemCount = 0;
+
+  bool            generate  = false;
+  bool            is3D      = false;
+  bool            is2D      = false;
+  bool            elemIs3D  = false;
+
+  double          x,y,z;
+
+  const char*     first;
+  const char*     last;
+
+  Str2StrMap      params;
+  StrSet          skippedTypes;
+
+  IntVector       values;
+  IntVector       connectivity;
+
+  Int2IntMap      elemIndex;      // Abaqus element id => ie
+  IntVector       elemTypes;      // Gmsh type of every ie
 
-  file.close ();
+  InpSets         elsets;
+  InpSets         nsets;
 
-  // check validity of input
+  // (element id, set) pairs in the order elements are added to sets
 
-  if ( globdat.isDomain )
+  IntVector       setElems;
+  IntVector       elemSets;
+
+  cout << "Reading Abaqus mesh file ...\n";
+  cout << "Reading nodes and elements...\n";
+
+  while ( file.nextLine ( first, last ) )
   {
-    Int2IntVectMap::const_iterator it;
-    Int2IntVectMap::const_iterator eit = globdat.dom2Elems.end   ();
+    if ( first == last ) continue;
+
+    // keyword or comment line
+
+    if ( *first == '*' )
+    {
+      if ( last - first > 1 && first[1] == '*' ) continue;
+
+      string keyword = readKeyword ( params, first, last );
+
+      block    = OTHER;
+      setIndex = -1;
+      generate = params.count ( "GENERATE" ) > 0;
+
+      if      ( keyword == "NODE" )
+      {
+        block = NODE;
+
+        if ( params.count ( "NSET" ) )
+        {
+          setIndex = nsets.getIndex ( params["NSET"] );
+        }
+      }
+      else if ( keyword == "ELEMENT" )
+      {
+        block    = ELEMENT;
+        elemType = abaqusElemType ( elemNode, elemIs3D, params["TYPE"] );
+
+        if ( elemType < 0 )
+        {
+          skippedTypes.insert ( params["TYPE"] );
+          continue;
+        }
+
+        ( elemIs3D ? is3D : is2D ) = true;
+
+        if ( params.count ( "ELSET" ) )
+        {
+          setIndex = elsets.getIndex ( params["ELSET"] );
+        }
+      }
+      else if ( keyword == "ELSET" )
+      {
+        block    = ELSET;
+        setIndex = elsets.getIndex ( params["ELSET"] );
+      }
+      else if ( keyword == "NSET" )
+      {
+        block    = NSET;
+        setIndex = nsets.getIndex ( params["NSET"] );
+      }
+
+      continue;
+    }
+
+    // data line of the current keyword
+
+    if      ( block == NODE )
+    {
+      TextScanner scanner ( first, last );
+
+      id = scanner.readInt ();
+      x  = y = z = 0.;
 
-    it = globdat.dom2Elems.find ( globdat.rigidDomain );
+      if ( scanner.skipChar ( ',' ) ) x = scanner.readDouble ();
+      if ( scanner.skipChar ( ',' ) ) y = scanner.readDouble ();
 
-    if ( it == eit )
+      if ( scanner.skipChar ( ',' ) && !scanner.atEndOfLine () )
+      {
+        z = scanner.readDouble ();
+      }
+
+      globdat.nodeSet.add ( x, y, z, id );
+
+      globdat.nodeId2Position.set ( id, globdat.nodeSet.size()-1 );
+
+      if ( setIndex >= 0 ) nsets.members[setIndex].push_back ( id );
+    }
+    else if ( block == ELEMENT && elemType >= 0 )
+    {
+      // id, node list, continued on the next lines if it is long
+
+      values.clear ();
+
+      readIntLine ( values, first, last );
+
+      while ( values.size () < size_t( elemNode + 1 ) &&
+              file.nextLine ( first, last ) )
+      {
+        readIntLine ( values, first, last );
+      }
+
+      if ( values.size () != size_t( elemNode + 1 ) )
+      {
+        cerr << "invalid number of nodes for element " << values[0]
+             << " in Abaqus file!!!\n";
+        exit(1);
+      }
+
+      id = values[0];
+
+      connectivity.assign ( values.begin() + 1, values.end() );
+
+      toGmshOrder ( connectivity, elemType );
+
+      const int ie = globdat.elemSet.size ();
+
+      globdat.elemSet.push_back ( globdat.elemArena.create<Element> ( globdat.elemStore, ie, elemType, connectivity )  );
+
+      globdat.elemId2Position.set ( ie, ie );
+
+      elemIndex[id]  = ie;
+      nodeElemCount  = elemNode;
+
+      if ( setIndex >= 0 )
+      {
+        elsets.members[setIndex].push_back ( id );
+
+        setElems.push_back ( id );
+        elemSets.push_back ( setIndex );
+      }
+    }
+    else if ( block == ELSET )
     {
-      cerr << "invalid number of rigid domain!!!\n";
-      exit(1);
+      IntVector& members = elsets.members[setIndex];
+      size_t     count   = members.size ();
+
+      readSetLine ( members, elsets, generate, first, last );
+
+      for ( ; count < members.size (); count++ )
+      {
+        setElems.push_back ( members[count] );
+        elemSets.push_back ( setIndex );
+      }
+    }
+    else if ( block == NSET )
+    {
+      readSetLine ( nsets.members[setIndex], nsets, generate, first, last );
     }
   }
 
-  if ( globdat.isInterface )
+  cout << "Reading nodes and elements...done!\n\n";
+
+  for ( StrSet::const_iterator it = skippedTypes.begin ();
+        it != skippedTypes.end (); ++it )
   {
+    cout << "Elements of type " << *it << " are ignored\n";
   }
 
-  if ( globdat.isNotch )
+  if ( globdat.elemSet.empty () )
   {
-    cout << "Existing notch segment is: "; // << globdat.segment << endl;
+    cerr << "no supported elements in Abaqus file!!!\n";
+    exit(1);
   }
 
-  if ( globdat.isIgSegment )
+  if ( is2D && is3D )
   {
-    cout << "Do not treat nodes on this segment: "<< globdat.ignoredSegment << endl;
+    cerr << "mixed 2D and 3D elements in Abaqus file!!!\n";
+    exit(1);
   }
 
-  cout << endl;
+  globdat.is3D = is3D;
 
-  globdat.nodeElemCount = connectivity.size ();
+  cout << "Reading element and node sets...\n";
 
-  string elemTypeStr = "linear";
+  // element sets => domains, the last set of an element wins
 
-  elemType = globdat.elemSet[0]->getElemType ();
+  const int  elemCount = globdat.elemSet.size ();
 
-  if ( !globdat.is3D )
+  IntVector  numbers;
+  IntVector  setOfElem ( elemCount, -1 );
+
+  elsets.getNumbers ( numbers );
+
+  for ( size_t i = 0; i < setElems.size (); i++ )
   {
-    if ( elemType == 2 || elemType == 3 )
-    {
-      globdat.nodeICount  = globdat.isContinuum ? 4 : 2;
-      globdat.isQuadratic = false;
-      elemTypeStr         = "linear";
-    }
-    else
-    {
-      globdat.nodeICount  = 6;
-      globdat.isQuadratic = true;
-      elemTypeStr         = "quadratic";
-    }
+    Int2IntMap::const_iterator it = elemIndex.find ( setElems[i] );
+
+    if ( it != elemIndex.end () ) setOfElem[it->second] = elemSets[i];
   }
-  else
+
+  for ( int ie = 0; ie < elemCount; ie++ )
   {
-    // hex8 or tet4 elements 
-    if ( elemType == 4 || elemType == 5 ) 
-    {
-      globdat.nodeICount  = elemType == 4 ? 6 : 8;
-      globdat.isQuadratic = false; 
-      elemTypeStr = "linear";
-    }
-    // hex20 or tet10 elements 
-    else
-    {
-      globdat.nodeICount  = elemType == 11 ? 12 : 16;
-      globdat.isQuadratic = true;
-      elemTypeStr = "quadratic";
-    }
+    const int matId = setOfElem[ie] < 0 ? 0 : numbers[setOfElem[ie]];
 
-    // build faces for 3D elements
-  
-    cout << "Building initial faces of 3D elements...\n\n"; 
+    // material => elements
+    // element  => material (domain)
 
-    for ( unsigned int ie = 0; ie < globdat.elemSet.size (); ie++ )
-    {
-      globdat.elemSet[ie]->buildFaces0 ();
-    }
-    cout << "Building initial faces of 3D elements...done\n\n"; 
+    globdat.dom2Elems[matId].push_back ( ie );
+    globdat.elem2Domain.set ( ie, matId );
+  }
+
+  // node sets => node groups
+
+  nsets.getNumbers ( numbers );
+
+  for ( size_t is = 0; is < nsets.names.size (); is++ )
+  {
+    globdat.bndNodesMap[numbers[is]].insert ( nsets.members[is].begin(),
+                                              nsets.members[is].end() );
   }
 
+  cout << "Reading element and node sets...done!\n\n";
 
+  finishMesh ( globdat, nodeElemCount );
 }
@@ -0,0 +1,81 @@
+#include "Adjacency.h"
+
+
+// ------------------------------------------------------------
+//    startCount
+// ------------------------------------------------------------
+
+void Adjacency::startCount ( int rowCount )
+{
+  offsets_.assign ( rowCount + 1, 0 );
+  values_ .clear  ();
+  next_   .clear  ();
+}
+
+// ------------------------------------------------------------
+//    startFill
+// ------------------------------------------------------------
+
+// turns the counts into offsets
+
+void Adjacency::startFill ()
+{
+  const int rowCount = size ();
+
+  for ( int i = 0; i < rowCount; i++ )
+  {
+    offsets_[i+1] += offsets_[i];
+  }
+
+  values_.resize ( offsets_[rowCount] );
+  next_  .assign ( offsets_.begin(), offsets_.end() - 1 );
+}
+
+// ------------------------------------------------------------
+//    clear
+// ------------------------------------------------------------
+
+void Adjacency::clear ()
+{
+  offsets_.clear ();
+  values_ .clear ();
+  next_   .clear ();
+}
+
+// ------------------------------------------------------------
+//    swap
+// ------------------------------------------------------------
+
+void Adjacency::swap ( Adjacency& rhs )
+{
+  offsets_.swap ( rhs.offsets_ );
+  values_ .swap ( rhs.values_  );
+  next_   .swap ( rhs.next_    );
+}
+
+void Adjacency::swap
+
+  ( IntVector&  offsets,
+    IntVector&  values )
+
+{
+  offsets_.swap  ( offsets );
+  values_ .swap  ( values  );
+  next_   .clear ();
+}
+
+// ------------------------------------------------------------
+//    assign
+// ------------------------------------------------------------
+
+void Adjacency::assign
+
+  ( const int*  offsets,
+    int         rowCount,
+    const int*  values )
+
+{
+  offsets_.assign ( offsets, offsets + rowCount + 1 );
+  values_ .assign ( values,  values  + offsets[rowCount] );
+  next_   .clear  ();
+}
@@ -0,0 +1,111 @@
+#ifndef ADJACENCY_H
+#define ADJACENCY_H
+
+#include "typedefs.h"
+#include "Span.h"
+
+// =====================================================================
+//     class Adjacency
+// =====================================================================
+
+/*
+ * A map from row numbers (node ids, element positions) to lists of
+ * ints in compressed row form: row i is entries offsets[i],...,
+ * offsets[i+1]-1 of one value array. Rows are read as spans, rows
+ * beyond size() are empty.
+ *
+ * It is built in two passes over the data:
+ *
+ *   adj.startCount ( rowCount );
+ *   for ( ... ) adj.count ( row );
+ *   adj.startFill  ();
+ *   for ( ... ) adj.add   ( row, value );    // same sequence again
+ *
+ * Each row keeps its values in the order they were added.
+ */
+
+class Adjacency
+{
+  public:
+
+    inline int           size       () const;
+
+    // row i, empty if there is no such row
+
+    inline IntSpan       operator [] ( int row ) const;
+
+    void                 startCount ( int rowCount );
+    inline void          count      ( int row );
+    void                 startFill  ();
+    inline void          add        ( int row, int value );
+
+    void                 clear      ();
+    void                 swap       ( Adjacency& rhs );
+
+    // exchanges the arrays with ready made ones, e.g. built by
+    // several threads
+
+    void                 swap
+
+      ( IntVector&         offsets,
+        IntVector&         values );
+
+    // the arrays themselves (offsets has size()+1 entries)
+
+    inline const IntVector&
+                         getOffsets () const;
+    inline const IntVector&
+                         getValues  () const;
+
+    void                 assign
+
+      ( const int*         offsets,
+        int                rowCount,
+        const int*         values );
+
+  private:
+
+    IntVector            offsets_;
+    IntVector            values_;
+    IntVector            next_;      // fill position of each row
+};
+
+// =====================================================================
+//   implementation of inline functions
+// =====================================================================
+
+inline int Adjacency::size () const
+{
+  return offsets_.empty () ? 0 : offsets_.size () - 1;
+}
+
+inline IntSpan Adjacency::operator [] ( int row ) const
+{
+  if ( row < 0 || row >= size () ) return IntSpan ();
+
+  const int* data = values_.data ();
+
+  return IntSpan ( data + offsets_[row], data + offsets_[row+1] );
+}
+
+inline void Adjacency::count ( int row )
+{
+  offsets_[row+1]++;
+}
+
+inline void Adjacency::add ( int row, int value )
+{
+  values_[next_[row]++] = value;
+}
+
+inline const IntVector& Adjacency::getOffsets () const
+{
+  return offsets_;
+}
+
+inline const IntVector& Adjacency::getValues () const
+{
+  return values_;
+}
+
+#endif
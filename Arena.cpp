@@ -0,0 +1,50 @@
+#include "Arena.h"
+
+
+// =====================================================================
+//   class Arena
+// =====================================================================
+
+Arena::Arena ( size_t blockSize )
+
+  : top_(0), end_(0), blockSize_(blockSize), capacity_(0)
+
+{}
+
+Arena::~Arena ()
+{
+  for ( size_t ib = 0; ib < blocks_.size (); ib++ )
+  {
+    ::operator delete ( blocks_[ib] );
+  }
+}
+
+// ---------------------------------------------------------------------
+//   allocateBlock_
+// ---------------------------------------------------------------------
+
+// Requests larger than a block get a block of their own, so that the
+// rest of the current block is not wasted.
+
+void* Arena::allocateBlock_ ( size_t size )
+{
+  if ( size > blockSize_ / 4 )
+  {
+    char* block = static_cast<char*> ( ::operator new ( size ) );
+
+    blocks_.push_back ( block );
+    capacity_ += size;
+
+    return block;
+  }
+
+  char* block = static_cast<char*> ( ::operator new ( blockSize_ ) );
+
+  blocks_.push_back ( block );
+  capacity_ += blockSize_;
+
+  top_ = block + size;
+  end_ = block + blockSize_;
+
+  return block;
+}
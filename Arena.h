@@ -0,0 +1,116 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+#include <type_traits>
+
+// =====================================================================
+//     class Arena
+// =====================================================================
+
+/*
+ * A monotonic allocator: memory is carved out of large blocks and is
+ * only given back, all at once, when the arena is destroyed. The
+ * elements of globdat live in one, so building a mesh does not make a
+ * heap allocation per element and there is no reference count to keep
+ * up. Objects are never destroyed one by one, so only types with a
+ * trivial destructor can be created in an arena.
+ *
+ * An arena is not thread safe. A parallel loop takes the room for all
+ * its objects in one call to allocate before it starts and constructs
+ * them in place with placement new.
+ */
+
+class Arena
+{
+  public:
+
+    explicit             Arena
+
+      ( size_t             blockSize = 1 << 20 );
+
+                        ~Arena ();
+
+    // size bytes, aligned for any type
+
+    inline void*         allocate
+
+      ( size_t             size );
+
+    // room for count objects of type T, not constructed
+
+    template <class T>
+    inline T*            allocate
+
+      ( int                count );
+
+    // a new object of type T, constructed from args
+
+    template <class T, class... Args>
+    inline T*            create
+
+      ( Args&&...          args );
+
+    // bytes taken from the system so far
+
+    size_t               capacity () const { return capacity_; }
+
+  private:
+
+                         Arena ( const Arena& );
+    Arena&               operator = ( const Arena& );
+
+    void*                allocateBlock_
+
+      ( size_t             size );
+
+  private:
+
+    static const size_t  ALIGN_ = alignof ( std::max_align_t );
+
+    std::vector<char*>   blocks_;
+    char*                top_;
+    char*                end_;
+    size_t               blockSize_;
+    size_t               capacity_;
+};
+
+// =====================================================================
+//   implementation of inline functions
+// =====================================================================
+
+inline void* Arena::allocate ( size_t size )
+{
+  size = ( size + ALIGN_ - 1 ) & ~( ALIGN_ - 1 );
+
+  if ( size_t( end_ - top_ ) < size )
+  {
+    return allocateBlock_ ( size );
+  }
+
+  void* p = top_;
+
+  top_ += size;
+
+  return p;
+}
+
+template <class T>
+inline T* Arena::allocate ( int count )
+{
+  static_assert ( std::is_trivially_destructible<T>::value,
+                  "objects in an arena are never destroyed" );
+
+  return static_cast<T*> ( allocate ( count * sizeof(T) ) );
+}
+
+template <class T, class... Args>
+inline T* Arena::create ( Args&&... args )
+{
+  return new ( allocate<T> ( 1 ) ) T ( std::forward<Args> ( args )... );
+}
+
+#endif
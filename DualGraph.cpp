@@ -0,0 +1,80 @@
+#include "DualGraph.h"
+
+
+// ------------------------------------------------------------
+//    constructor
+// ------------------------------------------------------------
+
+DualGraph::DualGraph () : offsets_(1, 0)
+{}
+
+// ------------------------------------------------------------
+//    startCount
+// ------------------------------------------------------------
+
+void DualGraph::startCount ( int elemCount )
+{
+  offsets_  .assign ( elemCount + 1, 0 );
+  neighbors_.clear  ();
+  sides_    .clear  ();
+}
+
+// ------------------------------------------------------------
+//    startFill
+// ------------------------------------------------------------
+
+// turns the side counts into offsets
+
+void DualGraph::startFill ()
+{
+  const int elemCount = size ();
+
+  for ( int ie = 0; ie < elemCount; ie++ )
+  {
+    offsets_[ie+1] += offsets_[ie];
+  }
+
+  neighbors_.assign ( offsets_[elemCount], int( NONE ) );
+  sides_    .assign ( offsets_[elemCount], 0 );
+}
+
+// ------------------------------------------------------------
+//    clear
+// ------------------------------------------------------------
+
+void DualGraph::clear ()
+{
+  offsets_  .assign ( 1, 0 );
+  neighbors_.clear  ();
+  sides_    .clear  ();
+}
+
+// ------------------------------------------------------------
+//    swap
+// ------------------------------------------------------------
+
+void DualGraph::swap ( DualGraph& rhs )
+{
+  offsets_  .swap ( rhs.offsets_   );
+  neighbors_.swap ( rhs.neighbors_ );
+  sides_    .swap ( rhs.sides_     );
+}
+
+// ------------------------------------------------------------
+//    assign
+// ------------------------------------------------------------
+
+void DualGraph::assign
+
+  ( const int*            offsets,
+    int                   elemCount,
+    const int*            neighbors,
+    const unsigned char*  sides )
+
+{
+  const int sideCount = offsets[elemCount];
+
+  offsets_  .assign ( offsets,   offsets   + elemCount + 1 );
+  neighbors_.assign ( neighbors, neighbors + sideCount     );
+  sides_    .assign ( sides,     sides     + sideCount     );
+}
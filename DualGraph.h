@@ -0,0 +1,141 @@
+#ifndef DUAL_GRAPH_H
+#define DUAL_GRAPH_H
+
+#include "typedefs.h"
+
+// =====================================================================
+//     class DualGraph
+// =====================================================================
+
+/*
+ * The dual graph of a mesh: for every element (a position in elemSet)
+ * and every side of it, the element on the other side and the local
+ * number of that side in it. Sides are the corner edges of 2D elements
+ * (edge k runs from corner k to corner k+1) and the faces of 3D
+ * elements (in the order of getFaces0). A side on the boundary has no
+ * neighbor (NONE).
+ *
+ * The sides of element ie are entries offsets[ie],...,offsets[ie+1]-1
+ * of the neighbor arrays. It is built in two passes, which may both be
+ * shared among threads as every element writes its own entries only:
+ *
+ *   graph.startCount   ( elemCount );
+ *   graph.setSideCount ( ie, sideCount );            // all elements
+ *   graph.startFill    ();
+ *   graph.setNeighbor  ( ie, side, je, jside );      // interior sides
+ */
+
+class DualGraph
+{
+  public:
+
+    static const int     NONE = -1;
+
+                         DualGraph       ();
+
+    inline int           size            () const;
+
+    void                 startCount      ( int elemCount );
+    inline void          setSideCount    ( int ie, int sideCount );
+
+    // all sides are on the boundary until setNeighbor is called
+
+    void                 startFill       ();
+
+    void                 clear           ();
+    void                 swap            ( DualGraph& rhs );
+
+    inline void          setNeighbor
+
+      ( int                ie,
+        int                side,
+        int                je,
+        int                jside );
+
+    inline int           getSideCount    ( int ie ) const;
+
+    // element across side of ie, NONE on the boundary
+
+    inline int           getNeighbor     ( int ie, int side ) const;
+    inline int           getNeighborSide ( int ie, int side ) const;
+
+    // the arrays themselves (offsets has size()+1 entries)
+
+    inline const IntVector&
+                         getOffsets      () const;
+    inline const IntVector&
+                         getNeighbors    () const;
+    inline const vector<unsigned char>&
+                         getSides        () const;
+
+    void                 assign
+
+      ( const int*           offsets,
+        int                  elemCount,
+        const int*           neighbors,
+        const unsigned char* sides );
+
+  private:
+
+    IntVector               offsets_;
+    IntVector               neighbors_;
+    vector<unsigned char>   sides_;      // local side in the neighbor
+};
+
+// =====================================================================
+//   implementation of inline functions
+// =====================================================================
+
+inline int DualGraph::size () const
+{
+  return offsets_.size () - 1;
+}
+
+inline void DualGraph::setSideCount ( int ie, int sideCount )
+{
+  offsets_[ie+1] = sideCount;
+}
+
+inline void DualGraph::setNeighbor
+
+  ( int  ie,
+    int  side,
+    int  je,
+    int  jside )
+
+{
+  neighbors_[offsets_[ie] + side] = je;
+  sides_    [offsets_[ie] + side] = jside;
+}
+
+inline int DualGraph::getSideCount ( int ie ) const
+{
+  return offsets_[ie+1] - offsets_[ie];
+}
+
+inline int DualGraph::getNeighbor ( int ie, int side ) const
+{
+  return neighbors_[offsets_[ie] + side];
+}
+
+inline int DualGraph::getNeighborSide ( int ie, int side ) const
+{
+  return sides_[offsets_[ie] + side];
+}
+
+inline const IntVector& DualGraph::getOffsets () const
+{
+  return offsets_;
+}
+
+inline const IntVector& DualGraph::getNeighbors () const
+{
+  return neighbors_;
+}
+
+inline const vector<unsigned char>& DualGraph::getSides () const
+{
+  return sides_;
+}
+
+#endif
@@ -0,0 +1,158 @@
+#include "EdgeIndex.h"
+
+
+// ------------------------------------------------------------
+//    constructor
+// ------------------------------------------------------------
+
+EdgeIndex::EdgeIndex ()
+{
+  rehash_ ( 16 );
+}
+
+// ------------------------------------------------------------
+//    reserve
+// ------------------------------------------------------------
+
+void EdgeIndex::reserve ( int edgeCount )
+{
+  first_ .reserve ( edgeCount );
+  second_.reserve ( edgeCount );
+  owners_.reserve ( 2 * edgeCount );
+  locals_.reserve ( 2 * edgeCount );
+  tags_  .reserve ( edgeCount );
+
+  // the table is kept at most half full
+
+  int slotCount = slots_.size ();
+
+  while ( slotCount < 2 * edgeCount ) slotCount *= 2;
+
+  if ( slotCount > int( slots_.size () ) ) rehash_ ( slotCount );
+}
+
+// ------------------------------------------------------------
+//    clear
+// ------------------------------------------------------------
+
+void EdgeIndex::clear ()
+{
+  first_ .clear ();
+  second_.clear ();
+  owners_.clear ();
+  locals_.clear ();
+  tags_  .clear ();
+
+  rehash_ ( 16 );
+}
+
+// ------------------------------------------------------------
+//    find
+// ------------------------------------------------------------
+
+int EdgeIndex::find ( int n1, int n2 ) const
+{
+  const int lo   = min ( n1, n2 );
+  const int hi   = max ( n1, n2 );
+  const int mask = slots_.size () - 1;
+
+  // linear probing, an empty slot ends the search
+
+  for ( int is = slot_ ( lo, hi ); ; is = ( is + 1 ) & mask )
+  {
+    const int edge = slots_[is];
+
+    if ( edge == NONE ) return NONE;
+
+    if ( first_[edge] == lo && second_[edge] == hi ) return edge;
+  }
+}
+
+// ------------------------------------------------------------
+//    insert
+// ------------------------------------------------------------
+
+int EdgeIndex::insert ( int n1, int n2 )
+{
+  if ( 2 * ( size () + 1 ) > int( slots_.size () ) )
+  {
+    rehash_ ( 2 * slots_.size () );
+  }
+
+  const int lo   = min ( n1, n2 );
+  const int hi   = max ( n1, n2 );
+  const int mask = slots_.size () - 1;
+
+  int is = slot_ ( lo, hi );
+
+  for ( ; slots_[is] != NONE; is = ( is + 1 ) & mask )
+  {
+    const int edge = slots_[is];
+
+    if ( first_[edge] == lo && second_[edge] == hi ) return edge;
+  }
+
+  slots_[is] = size ();
+
+  first_ .push_back ( lo   );
+  second_.push_back ( hi   );
+  owners_.push_back ( int( NONE ) );
+  owners_.push_back ( int( NONE ) );
+  locals_.push_back ( 0    );
+  locals_.push_back ( 0    );
+  tags_  .push_back ( int( NONE ) );
+
+  return size () - 1;
+}
+
+// ------------------------------------------------------------
+//    addOwner
+// ------------------------------------------------------------
+
+// owners beyond the second (non manifold meshes) are ignored, as
+// the neighbor search this replaces stopped at the first match
+
+void EdgeIndex::addOwner
+
+  ( int  edge,
+    int  elem,
+    int  localEdge )
+
+{
+  for ( int i = 2*edge; i < 2*edge+2; i++ )
+  {
+    if ( owners_[i] == NONE )
+    {
+      owners_[i] = elem;
+      locals_[i] = localEdge;
+      return;
+    }
+  }
+}
+
+// ------------------------------------------------------------
+//    rehash_
+// ------------------------------------------------------------
+
+// slotCount is a power of two
+
+void EdgeIndex::rehash_ ( int slotCount )
+{
+  slots_.assign ( slotCount, int( NONE ) );
+
+  shift_ = 64;
+
+  for ( int count = slotCount; count > 1; count /= 2 ) shift_--;
+
+  const int mask      = slotCount - 1;
+  const int edgeCount = size ();
+
+  for ( int edge = 0; edge < edgeCount; edge++ )
+  {
+    int is = slot_ ( first_[edge], second_[edge] );
+
+    while ( slots_[is] != NONE ) is = ( is + 1 ) & mask;
+
+    slots_[is] = edge;
+  }
+}
@@ -0,0 +1,163 @@
+#ifndef EDGE_INDEX_H
+#define EDGE_INDEX_H
+
+#include "typedefs.h"
+
+// =====================================================================
+//     class EdgeIndex
+// =====================================================================
+
+/*
+ * A hash table of the edges of a 2D mesh, keyed by the node pair of
+ * the edge regardless of its orientation: (n1,n2) and (n2,n1) are the
+ * same edge. Edges are numbered 0,...,size()-1 in the order they are
+ * inserted. For each edge it records the elements sharing it (their
+ * position in elemSet and the local number of the edge in them; an
+ * interior edge has two, the first two are kept) and, for an edge on
+ * the external boundary, the physical tag of its line element.
+ *
+ * Without owners and tags it serves as a set of node pairs.
+ */
+
+class EdgeIndex
+{
+  public:
+
+    static const int     NONE = -1;
+
+                         EdgeIndex      ();
+
+    inline int           size           () const;
+
+    void                 reserve        ( int edgeCount );
+    void                 clear          ();
+
+    // number of the edge (n1,n2), NONE if there is no such edge
+
+    int                  find
+
+      ( int                n1,
+        int                n2 ) const;
+
+    inline bool          contains
+
+      ( int                n1,
+        int                n2 ) const;
+
+    // number of the edge (n1,n2), added if it is new
+
+    int                  insert
+
+      ( int                n1,
+        int                n2 );
+
+    // element elem has the edge as its local edge localEdge
+
+    void                 addOwner
+
+      ( int                edge,
+        int                elem,
+        int                localEdge );
+
+    // i = 0,1; NONE if the edge has less owners
+
+    inline int           getOwner       ( int edge, int i ) const;
+    inline int           getLocalEdge   ( int edge, int i ) const;
+
+    // the owner of the edge that is not elem, NONE if none
+
+    inline int           getOtherOwner  ( int edge, int elem ) const;
+
+    // local number of the edge in owner elem (which must own it)
+
+    inline int           getLocalEdgeOf ( int edge, int elem ) const;
+
+    // edges on the external boundary
+
+    inline bool          isOnBoundary   ( int edge ) const;
+    inline int           getBoundaryTag ( int edge ) const;
+    inline void          setBoundaryTag ( int edge, int tag );
+
+  private:
+
+    inline int           slot_
+
+      ( int                lo,
+        int                hi ) const;
+
+    void                 rehash_        ( int slotCount );
+
+  private:
+
+    IntVector               first_;     // smaller node of each edge
+    IntVector               second_;    // larger node of each edge
+    IntVector               owners_;    // two per edge
+    vector<unsigned char>   locals_;    // two per edge
+    IntVector               tags_;      // NONE if not on the boundary
+
+    IntVector               slots_;     // edge number or NONE
+    int                     shift_;     // 64 - log2 ( slots_.size() )
+};
+
+// =====================================================================
+//   implementation of inline functions
+// =====================================================================
+
+inline int EdgeIndex::size () const
+{
+  return first_.size ();
+}
+
+inline bool EdgeIndex::contains ( int n1, int n2 ) const
+{
+  return find ( n1, n2 ) != NONE;
+}
+
+inline int EdgeIndex::getOwner ( int edge, int i ) const
+{
+  return owners_[2*edge+i];
+}
+
+inline int EdgeIndex::getLocalEdge ( int edge, int i ) const
+{
+  return locals_[2*edge+i];
+}
+
+inline int EdgeIndex::getOtherOwner ( int edge, int elem ) const
+{
+  const int first = owners_[2*edge];
+
+  return first != elem ? first : owners_[2*edge+1];
+}
+
+inline int EdgeIndex::getLocalEdgeOf ( int edge, int elem ) const
+{
+  return locals_[ owners_[2*edge] == elem ? 2*edge : 2*edge+1 ];
+}
+
+inline bool EdgeIndex::isOnBoundary ( int edge ) const
+{
+  return tags_[edge] != NONE;
+}
+
+inline int EdgeIndex::getBoundaryTag ( int edge ) const
+{
+  return tags_[edge];
+}
+
+inline void EdgeIndex::setBoundaryTag ( int edge, int tag )
+{
+  tags_[edge] = tag;
+}
+
+// Fibonacci hashing of the sorted pair, the top bits select the slot
+
+inline int EdgeIndex::slot_ ( int lo, int hi ) const
+{
+  unsigned long long key = ( (unsigned long long) (unsigned) lo << 32 ) |
+                             (unsigned long long) (unsigned) hi;
+
+  return int ( ( key * 0x9E3779B97F4A7C15ULL ) >> shift_ );
+}
+
+#endif
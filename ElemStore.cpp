@@ -0,0 +1,84 @@
+#include "ElemStore.h"
+
+
+ElemStore::ElemStore ()
+
+  : offsets_(1, 0)
+{
+}
+
+// ------------------------------------------------------------
+//    reserve
+// ------------------------------------------------------------
+
+void ElemStore::reserve
+
+  ( int  elemCount,
+    int  nodeCount )
+
+{
+  index_  .reserve ( elemCount     );
+  types_  .reserve ( elemCount     );
+  offsets_.reserve ( elemCount + 1 );
+  connec0_.reserve ( nodeCount     );
+  connec_ .reserve ( nodeCount     );
+}
+
+// ------------------------------------------------------------
+//    clear
+// ------------------------------------------------------------
+
+void ElemStore::clear ()
+{
+  index_  .clear  ();
+  types_  .clear  ();
+  offsets_.assign ( 1, 0 );
+  connec0_.clear  ();
+  connec_ .clear  ();
+}
+
+// ------------------------------------------------------------
+//    add
+// ------------------------------------------------------------
+
+int ElemStore::add
+
+  ( int               index,
+    int               elemType,
+    const IntVector&  connec )
+
+{
+  index_  .push_back ( index    );
+  types_  .push_back ( elemType );
+
+  connec0_.insert    ( connec0_.end(), connec.begin(), connec.end() );
+  connec_ .insert    ( connec_ .end(), connec.begin(), connec.end() );
+
+  offsets_.push_back ( connec0_.size () );
+
+  return index_.size () - 1;
+}
+
+// ------------------------------------------------------------
+//    append
+// ------------------------------------------------------------
+
+void ElemStore::append
+
+  ( int  count,
+    int  nodeCount )
+
+{
+  const int first = size ();
+
+  index_  .resize  ( first + count, 0 );
+  types_  .resize  ( first + count, 0 );
+
+  for ( int ie = 0; ie < count; ie++ )
+  {
+    offsets_.push_back ( offsets_.back () + nodeCount );
+  }
+
+  connec0_.resize  ( offsets_.back (), 0 );
+  connec_ .resize  ( offsets_.back (), 0 );
+}
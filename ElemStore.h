@@ -0,0 +1,189 @@
+#ifndef ELEM_STORE_H
+#define ELEM_STORE_H
+
+#include "typedefs.h"
+
+// =====================================================================
+//     class ElemStore
+// =====================================================================
+
+/*
+ * The connectivity of a set of elements in compressed row form: the
+ * nodes of element ie are entries offsets[ie],...,offsets[ie+1]-1 of
+ * one index array. Two index arrays share the offsets, the original
+ * connectivity and the modified one (nodes replaced by their
+ * duplicates when the mesh is torn). Element ids and Gmsh type codes
+ * are stored per element; an Element is a view on one row.
+ */
+
+class ElemStore
+{
+  public:
+
+                         ElemStore      ();
+
+    inline int           size           () const;
+
+    void                 reserve
+
+      ( int                elemCount,
+        int                nodeCount );
+
+    void                 clear          ();
+
+    // adds an element (modified = original connectivity), returns
+    // its position
+
+    int                  add
+
+      ( int                index,
+        int                elemType,
+        const IntVector&   connec );
+
+    // adds count elements of nodeCount nodes each (type 0), whose id
+    // and connectivity are given later by set; several threads may
+    // then set different elements
+
+    void                 append
+
+      ( int                count,
+        int                nodeCount );
+
+    inline void          set
+
+      ( int                ie,
+        int                index,
+        const IntVector&   connec );
+
+    // the same with the getNodeCount(ie) nodes at connec
+
+    inline void          set
+
+      ( int                ie,
+        int                index,
+        const int*         connec );
+
+    inline int           getIndex       ( int ie ) const;
+    inline int           getElemType    ( int ie ) const;
+    inline void          setElemType    ( int ie, int type );
+    inline int           getNodeCount   ( int ie ) const;
+
+    // first node of the original and of the modified connectivity
+
+    inline const int*    getConnectivity0 ( int ie ) const;
+    inline const int*    getConnectivity  ( int ie ) const;
+    inline int*          getConnectivity  ( int ie );
+
+    // whole columns
+
+    inline const IntVector&
+                         getIndices     () const;
+    inline const IntVector&
+                         getOffsets     () const;
+    inline const IntVector&
+                         getConnectivities0 () const;
+
+  private:
+
+    // elements refer to their store, which is therefore not copied
+
+                         ElemStore      ( const ElemStore& );
+    ElemStore&           operator =     ( const ElemStore& );
+
+  private:
+
+    IntVector               index_;
+    vector<unsigned char>   types_;      // Gmsh element type, 0 = none
+    IntVector               offsets_;
+    IntVector               connec0_;    // original connectivity
+    IntVector               connec_;     // modified connectivity
+};
+
+// =====================================================================
+//   implementation of inline functions
+// =====================================================================
+
+inline int ElemStore::size () const
+{
+  return index_.size ();
+}
+
+inline void ElemStore::set
+
+  ( int               ie,
+    int               index,
+    const IntVector&  connec )
+
+{
+  index_[ie] = index;
+
+  copy ( connec.begin(), connec.end(), connec0_.begin() + offsets_[ie] );
+  copy ( connec.begin(), connec.end(), connec_ .begin() + offsets_[ie] );
+}
+
+inline void ElemStore::set
+
+  ( int               ie,
+    int               index,
+    const int*        connec )
+
+{
+  const int nodeCount = getNodeCount ( ie );
+
+  index_[ie] = index;
+
+  copy ( connec, connec + nodeCount, connec0_.begin() + offsets_[ie] );
+  copy ( connec, connec + nodeCount, connec_ .begin() + offsets_[ie] );
+}
+
+inline int ElemStore::getIndex ( int ie ) const
+{
+  return index_[ie];
+}
+
+inline int ElemStore::getElemType ( int ie ) const
+{
+  return types_[ie];
+}
+
+inline void ElemStore::setElemType ( int ie, int type )
+{
+  types_[ie] = type;
+}
+
+inline int ElemStore::getNodeCount ( int ie ) const
+{
+  return offsets_[ie+1] - offsets_[ie];
+}
+
+inline const int* ElemStore::getConnectivity0 ( int ie ) const
+{
+  return connec0_.data () + offsets_[ie];
+}
+
+inline const int* ElemStore::getConnectivity ( int ie ) const
+{
+  return connec_.data () + offsets_[ie];
+}
+
+inline int* ElemStore::getConnectivity ( int ie )
+{
+  return connec_.data () + offsets_[ie];
+}
+
+inline const IntVector& ElemStore::getIndices () const
+{
+  return index_;
+}
+
+inline const IntVector& ElemStore::getOffsets () const
+{
+  return offsets_;
+}
+
+inline const IntVector& ElemStore::getConnectivities0 () const
+{
+  return connec0_;
+}
+
+#endif
@@ -1,124 +1,84 @@
 #include <boost/algorithm/minmax_element.hpp>
 
 #include "Element.h"
-#include "Node.h"
+#include "ElementTraits.h"
+#include "NodeStore.h"
 #include "Global.h"
 
 
 typedef vector<double>::const_iterator   iter;
 
-
 // ------------------------------------------------------------
-//    constructors
+//    toJemOrder_
 // ------------------------------------------------------------
 
-Element::Element ( int index, int elemType,
-                   const IntVector& connec )
+// Jemjive format: nodes (corner and midside) are continuous
 
-  : index_(index), elemType_(elemType),
-    connectivity_(connec), connectivity0_(connec), 
-    done_(false), isQuadratic_(connec.size() > 4 ? true : false),
-    isChanged_(false), isNURBS_(false)
-{
-  nodePerFace_ = 3;
-}
+template <class Traits>
+static void              toJemOrder_
 
-Element::Element ( int index, int elemType,
-                   const IntVector& connec, bool isNURBS )
+  ( IntVector&             connec,
+    const int*             conn )
 
-  : index_(index), elemType_(elemType),
-    connectivity_(connec), connectivity0_(connec), 
-    done_(false), isQuadratic_(connec.size() > 4 ? true : false),
-    isChanged_(false), isNURBS_(isNURBS)
 {
-  nodePerFace_ = 3;
+  connec.resize ( Traits::NODE_COUNT );
+
+  for ( int in = 0; in < Traits::NODE_COUNT; in++ )
+  {
+    connec[in] = conn[Traits::JEM_ORDER[in]];
+  }
 }
 
-Element::Element ( int index,
+
+// ------------------------------------------------------------
+//    constructors
+// ------------------------------------------------------------
+
+Element::Element ( ElemStore& store, int index, int elemType,
                    const IntVector& connec )
 
-  : index_(index), 
-    connectivity_(connec), connectivity0_(connec)
-{
-}
+  : store_(&store), pos_(store.add ( index, elemType, connec )),
+    faceTable_(faceTableOf ( elemType )), done_(false), isChanged_(false), isNURBS_(false),
+    bulk1_(-1), bulk2_(-1),
+    cornerCount_(cornerCountOf ( elemType, connec.size() ))
+{}
 
+Element::Element ( ElemStore& store, int index, int elemType,
+                   const IntVector& connec, bool isNURBS )
 
-Element::Element ( int index, int elemType,
-                   const IntVector& connec, int bulk1, int bulk2 )
+  : store_(&store), pos_(store.add ( index, elemType, connec )),
+    faceTable_(faceTableOf ( elemType )), done_(false), isChanged_(false), isNURBS_(isNURBS),
+    bulk1_(-1), bulk2_(-1),
+    cornerCount_(cornerCountOf ( elemType, connec.size() ))
+{}
 
-  : index_(index), elemType_(elemType),
-    connectivity_(connec), connectivity0_(connec), 
-    done_(false), isQuadratic_(connec.size() > 4 ? true : false),
-    isChanged_(false), bulk1_(bulk1), bulk2_(bulk2)
-{
-  nodePerFace_ = 3;
-}
+Element::Element ( ElemStore& store, int index,
+                   const IntVector& connec )
 
-// ------------------------------------------------------------
-//    buildFaces
-// ------------------------------------------------------------
-//
-// attention: the faces must be oriented properly
-// so that the normals are outward.
+  : store_(&store), pos_(store.add ( index, 0, connec )),
+    faceTable_(0), done_(false), isChanged_(false), isNURBS_(false),
+    bulk1_(-1), bulk2_(-1),
+    cornerCount_(cornerCountOf ( 0, connec.size() ))
+{}
 
-void Element::buildFaces ()
-{
-  if       ( elemType_ == 4 )   // 4 node tetrahedron
-  {
-    buildFacesForTet4_ ();
-  }
-  else if  ( elemType_ == 11 )  // 10 node tetrahedron
-  {
-    buildFacesForTet10_ ();
-  }
-  else if  ( elemType_ == 5 )   // 8 node hexahedron
-  {
-    buildFacesForHex8_ ();
-  }
-  else if  ( elemType_ == 17 )  // 20 node hexahedron
-  {
-    buildFacesForHex20_ ();
-  }
-  else
-  {
-    cerr << "Unsupported element type\n";
-    exit(1);
-  }
-}
 
-// ------------------------------------------------------------
-//    buildFaces0
-// ------------------------------------------------------------
-//
-// attention: the faces must be oriented properly
-// so that the normals are outward.
+Element::Element ( ElemStore& store, int index, int elemType,
+                   const IntVector& connec, int bulk1, int bulk2 )
 
-void Element::buildFaces0 ()
-{
+  : store_(&store), pos_(store.add ( index, elemType, connec )),
+    faceTable_(faceTableOf ( elemType )), done_(false), isChanged_(false), isNURBS_(false),
+    bulk1_(bulk1), bulk2_(bulk2),
+    cornerCount_(cornerCountOf ( elemType, connec.size() ))
+{}
 
-  if       ( elemType_ == 4 )   // 4 node tetrahedron
-  {
-    buildFaces0ForTet4_ ();
-  }
-  else if  ( elemType_ == 11 )  // 10 node tetrahedron
-  {
-    buildFaces0ForTet10_ ();
-  }
-  else if  ( elemType_ == 5 )   // 8 node hexahedron
-  {
-    buildFaces0ForHex8_ ();
-  }
-  else if  ( elemType_ == 17 )  // 20 node hexahedron
-  {
-    buildFaces0ForHex20_ ();
-  }
-  else
-  {
-    cerr << "Unsupported element type\n";
-    exit(1);
-  }
-}
+Element::Element ( ElemStore& store, int pos, int bulk1, int bulk2 )
 
+  : store_(&store), pos_(pos),
+    faceTable_(faceTableOf ( store.getElemType ( pos ) )), done_(false), isChanged_(false), isNURBS_(false),
+    bulk1_(bulk1), bulk2_(bulk2),
+    cornerCount_(cornerCountOf ( store.getElemType  ( pos ),
+                                 store.getNodeCount ( pos ) ))
+{}
 
 // ------------------------------------------------------------
 //     isOnExternalBoundary
@@ -130,13 +90,10 @@ bool Element::isOnExternalBoundary
    ( int       faceId,
      Global&   globdat ) const
 {
-  int         nodeCount = faces_[0].size ( );
-  int         id, pos, mat;
-  int         count;
-
-  IntVector   vertices(nodeCount);
+  const FaceView  vertices = getFace0 ( faceId );
+  const int       nodeCount = vertices.size ();
 
-  vertices = faces0_[faceId];
+  int             id, pos, mat;
 
   // loop over nodes of face jf
 
@@ -144,7 +101,7 @@ bool Element::isOnExternalBoundary
   {
       id  = vertices[in];
       pos = globdat.nodeId2Position[id];
-      mat = globdat.nodeSet[pos]->getDuplicity ();
+      mat = globdat.nodeSet.getDuplicity ( pos );
 
       // if this node is interfacial
 
@@ -164,11 +121,10 @@ bool Element::isOnInterface
    ( IntVector&        face,
      int&              oppVertex,
      int&              fIndex,
-     const NodeSet&    nodeSet,
-           Int2IntMap& position ) const
+     const NodeStore&  nodeSet,
+     const IdMap&      position ) const
 {
-  int         faceCount = faces_.   size ( );
-  int         nodeCount = faces_[0].size ( );
+  int         faceCount = getFaceCount ();
   int         id, pos, mat;
   int         count;
 
@@ -177,13 +133,12 @@ bool Element::isOnInterface
     return false;
   }
 
-  IntVector   vertices(nodeCount);
-
   // loop over faces of 3D element
 
   for ( int jf = 0; jf < faceCount; jf++ )
   {
-    vertices = faces_[jf];
+    const FaceView vertices  = getFace0 ( jf );
+    const int      nodeCount = vertices.size ();
 
     count    = 0;
 
@@ -194,7 +149,11 @@ bool Element::isOnInterface
       id  = vertices[in];
       pos = position[id];
 
-      mat = nodeSet[pos]->getDuplicity ();
+      // a node the mesh does not know is never interfacial
+
+      if ( pos == IdMap::NONE ) break;
+
+      mat = nodeSet.getDuplicity ( pos );
 
       // if this node is interfacial
 
@@ -206,9 +165,8 @@ bool Element::isOnInterface
 
     if ( count == nodeCount ) 
     {
-      face.resize ( count );
-      face      = vertices;
-      oppVertex = oppositeVertices_[jf];
+      vertices.get ( face );
+      oppVertex = getOppVertex ( jf );
 
       fIndex    = jf;
 
@@ -226,23 +184,17 @@ bool Element::isOnInterface
 
 bool Element::isInterfaceElement 
 
-         ( const NodeSet& nodeSet,
-	   Int2IntMap& position ) const
+         ( const NodeStore& nodeSet,
+	   const IdMap&     position ) const
 {
-  int nodeCount  = connectivity0_.size ();
-      nodeCount *= isQuadratic_ ? 0.5 : 1;
-
-  if ( elemType_ == 17 ) nodeCount = 8;
-	 
-  int nodeFace   = nodePerFace_;    
-      //nodeFace  *= isQuadratic_ ? 0.5 : 1;
+  int nodeFace   = interfaceCornersOf ( getElemType () );
 
   int index, mat, count = 0;
 
-  for ( int in = 0; in < nodeCount; in++ )
+  for ( int in = 0; in < cornerCount_; in++ )
   {
-    index = connectivity0_[in];
-    mat   = nodeSet[position[index]]->getDuplicity ();
+    index = conn0_()[in];
+    mat   = nodeSet.getDuplicity ( position[index] );
     if ( mat > 1 ) count++;
   }
 
@@ -260,14 +212,15 @@ bool Element::isInterfaceElement
 
 void Element::getSortedFaces ( vector<IntVector>& faces ) const
 {
-  int facesCount =  faces_.size () ;
+  int facesCount =  getFaceCount () ;
   faces.resize ( facesCount );
-  faces = faces_;
 
   // sort faces
 
   for ( int jf = 0; jf < facesCount; jf++ )
   {
+    getFace ( jf ).get ( faces[jf] );
+
     sort ( faces[jf].begin(), faces[jf].end() );
   }
 }
@@ -278,14 +231,15 @@ void Element::getSortedFaces ( vector<IntVector>& faces ) const
 
 void Element::getSortedFaces0 ( vector<IntVector>& faces ) const
 {
-  int facesCount =  faces0_.size ();
+  int facesCount =  getFaceCount ();
   faces.resize ( facesCount );
-  faces = faces0_;
 
   // sort faces
 
   for ( int jf = 0; jf < facesCount; jf++ )
   {
+    getFace0 ( jf ).get ( faces[jf] );
+
     sort ( faces[jf].begin(), faces[jf].end() );
   }
 }
@@ -298,8 +252,28 @@ void Element::getFaces
       
          ( vector<IntVector>& faces ) const
 {
-  faces.resize ( faces_.size () );
-  faces = faces_;
+  faces.resize ( getFaceCount () );
+
+  for ( int jf = 0; jf < getFaceCount (); jf++ )
+  {
+    getFace ( jf ).get ( faces[jf] );
+  }
+}
+
+// -------------------------------------------------------
+//   getFaces0
+// -------------------------------------------------------
+
+void Element::getFaces0 
+      
+         ( vector<IntVector>& faces ) const
+{
+  faces.resize ( getFaceCount () );
+
+  for ( int jf = 0; jf < getFaceCount (); jf++ )
+  {
+    getFace0 ( jf ).get ( faces[jf] );
+  }
 }
 
 // -------------------------------------------------------
@@ -310,8 +284,12 @@ void Element::getFFaces
       
          ( vector<IntVector>& faces ) const
 {
-  faces.resize ( ffaces_.size () );
-  faces = ffaces_;
+  faces.resize ( getFaceCount () );
+
+  for ( int jf = 0; jf < getFaceCount (); jf++ )
+  {
+    getFullFace ( faces[jf], jf );
+  }
 }
 
 
@@ -325,40 +303,14 @@ void  Element::getCornerConnectivity0
 
     ( IntVector& connec ) const
 {
-  if ( !isQuadratic_ )
-  {
-    getConnectivity0 ( connec );  
-  }
-  else
-  {
-    int count = connectivity0_.size () / 2;
-    connec.resize ( count );
-
-    for ( int i = 0; i < count; i++ )
-    {
-      connec[i] = connectivity0_[i];
-    }
-  }
+  connec.assign ( conn0_(), conn0_() + cornerCount_ );
 }
 
 void  Element::getCornerConnectivity
 
     ( IntVector& connec ) const
 {
-  if ( !isQuadratic_ )
-  {
-    getConnectivity ( connec );  
-  }
-  else
-  {
-    int count = connectivity_.size () / 2;
-    connec.resize ( count );
-
-    for ( int i = 0; i < count; i++ )
-    {
-      connec[i] = connectivity_[i];
-    }
-  }
+  connec.assign ( conn_(), conn_() + cornerCount_ );
 }
 
 // -------------------------------------------------------
@@ -373,22 +325,22 @@ void Element::getBoundsOfFace
 	   int                  fIndex,
 	   Global&              globdat) const
 {
-  IntVector      vertices ( nodePerFace_ );
+  const FaceView vertices  = getFace ( fIndex );
+  const int      nodeCount = vertices.size ();
+
   vector<double> xCoord, yCoord, zCoord;
 
   double         x,y,z;
   int            id, pos;
 
-  vertices = faces_[fIndex];
-
-  for ( int in = 0; in < nodePerFace_; in++ )
+  for ( int in = 0; in < nodeCount; in++ )
   {
     id  = vertices[in];
     pos = globdat.nodeId2Position[id];
 
-    x = globdat.nodeSet[pos]->getX();
-    y = globdat.nodeSet[pos]->getY();
-    z = globdat.nodeSet[pos]->getZ();
+    x = globdat.nodeSet.getX ( pos );
+    y = globdat.nodeSet.getY ( pos );
+    z = globdat.nodeSet.getZ ( pos );
 
     xCoord.push_back ( x );
     yCoord.push_back ( y );
@@ -424,26 +376,28 @@ void Element::getJemConnectivity
 
          ( IntVector& connec )            const
 {
-  connec.resize ( connectivity_.size() );
-
-  if      ( !isQuadratic_ || isNURBS_ )
+  if ( isNURBS_ )
   {
-    getJemConnectLinear_ ( connec );
+    getConnectivity ( connec );
+    return;
   }
-  else 
+
+  switch ( getElemType () )
   {
-    if      ( elemType_ == 11 )
-    {
-      getJemConnectTet10_ ( connec );
-    }
-    else if ( elemType_ == 17 )
-    {
-      getJemConnectHex20_ ( connec );
-    }
-    else
-    {
-      getJemConnect2DQuadratic_ ( connec );
-    }
+    case Tri6Traits::TYPE:
+      toJemOrder_<Tri6Traits>  ( connec, conn_() );
+      break;
+    case Quad8Traits::TYPE:
+      toJemOrder_<Quad8Traits> ( connec, conn_() );
+      break;
+    case Tet10Traits::TYPE:
+      toJemOrder_<Tet10Traits> ( connec, conn_() );
+      break;
+    case Hex20Traits::TYPE:
+      toJemOrder_<Hex20Traits> ( connec, conn_() );
+      break;
+    default:
+      getConnectivity ( connec );   // linear elements
   }
 }
 
@@ -457,8 +411,7 @@ struct PrintElement : public unary_function<ElemPointer,void>
 
   void   operator () ( const ElemPointer ep ) const
   {
-    IntVector connec;
-    ep->getConnectivity ( connec );
+    const IntSpan connec = ep->getNodes ();
 
     copy ( connec.begin(), connec.end(), 
 	   ostream_iterator<int> (of, " ") );
@@ -481,45 +434,35 @@ int Element::getIndexElementContainsEdge
         int                    node1,
         int                    node2 ) const
 {
-  IntVector   neighbors, jnodes;
-  int         neiCount;
-  int         jelem;
-  int         res;
-  IntVector::const_iterator it1, it2;
-  ElemPointer jp;
+  const DualGraph& graph = globdat.elemNeighbors;
 
-  // loop over neighbors of current element and find the one contains edge (node1,node2)
-  // using the modified connectivity not the original one!!!
+  const int   ielem = globdat.elemId2Position[getIndex ()];
+  const int   sideCount = graph.getSideCount ( ielem );
 
-  //cout << index_ << " " << endl;
-  neighbors = globdat.elemNeighbors[globdat.elemId2Position[index_]];
-  neiCount  = neighbors.size();
+  int         jelem, ncorner;
+  const int*  jnodes;
 
-  //print(neighbors.begin(),neighbors.end());
-  //cout << "node1,2: " << node1 << " " << node2 << endl;
+  // loop over the elements across the edges of the current element and
+  // find the one contains edge (node1,node2), using the modified
+  // connectivity not the original one!!!
 
-  for(int je = 0; je < neiCount; je++)
+  for ( int is = 0; is < sideCount; is++ )
   {
-    jelem = globdat.elemId2Position[neighbors[je]];
-    jp    = globdat.elemSet[jelem];
+    jelem = graph.getNeighbor ( ielem, is );
 
-    if ( jp->getIndex() == index_ ) continue;
+    if ( jelem == DualGraph::NONE ) continue;
 
-    jp->getCornerConnectivity (jnodes);
-  
-    //print(jnodes.begin(),jnodes.end());
-
-    it1 = find ( jnodes.begin(), jnodes.end(), node1 );
-    it2 = find ( jnodes.begin(), jnodes.end(), node2 );
+    jnodes  = globdat.elemStore.getConnectivity ( jelem );
+    ncorner = globdat.elemSet[jelem]->getCornerCount ();
 
-    if ( it1 != jnodes.end() && it2 != jnodes.end() )
+    if ( find ( jnodes, jnodes + ncorner, node1 ) != jnodes + ncorner &&
+         find ( jnodes, jnodes + ncorner, node2 ) != jnodes + ncorner )
     {
-       res = jp->getIndex();
-       break;
+      return globdat.elemSet[jelem]->getIndex ();
     }
   }
 
-  return res;
+  return -1;
 }
 
 
@@ -532,38 +475,34 @@ int Element::getIndexElementContainsFace
       ( Global&                globdat,
         const IntVector&       face ) const
 {
-  IntVector         neighbors, jnodes, sface;
-  int               neiCount;
+  const DualGraph&  graph = globdat.elemNeighbors;
+
+  const int         ielem = globdat.elemId2Position[getIndex ()];
+  const int         sideCount = graph.getSideCount ( ielem );
+
   int               jelem;
-  int               res;
   ElemPointer       jp;
   vector<IntVector> jfaces;
 
-  //cout << index_ << " " << endl;
-  neighbors = globdat.elemNeighbors[globdat.elemId2Position[index_]];
-  neiCount  = neighbors.size();
+  // loop over the elements across the faces of the current element
 
-  //print(neighbors.begin(),neighbors.end());
+  for ( int is = 0; is < sideCount; is++ )
+  {
+    jelem = graph.getNeighbor ( ielem, is );
 
-  //sface = face;
-  //sort(sface.begin(),sface.end());
+    if ( jelem == DualGraph::NONE ) continue;
 
-  for(int je = 0; je < neiCount; je++)
-  {
-    jelem = globdat.elemId2Position[neighbors[je]];
     jp    = globdat.elemSet[jelem];
 
-    if ( jp->getIndex() == index_ ) continue;
-
     jp->getSortedFaces (jfaces);
 
     if ( find (jfaces.begin(), jfaces.end(), face) != jfaces.end() )
     {
-       res = jp->getIndex();
-       break;
+       return jp->getIndex();
     }
   }
-  return res;
+
+  return -1;
 }
 
 // ----------------------------------------------------
@@ -575,576 +514,25 @@ double Element::computeElementSize ( Global&  globdat ) const
    return computeElementSizeTriangle_ ( globdat );
 }
 
-// ----------------------------------------------------------
-//   buildFacesForTet4
-// ----------------------------------------------------------
-
-void Element::buildFacesForTet4_ ()
-{
-  faces_ .resize ( 4 );
-  ffaces_.resize ( 4 );
-  oppositeVertices_.resize ( 4 );
-
-  faces_[0].resize ( 3 );
-  faces_[1].resize ( 3 );
-  faces_[2].resize ( 3 );
-  faces_[3].resize ( 3 );
-
-  faces_[0][0] = connectivity_[0];
-  faces_[0][1] = connectivity_[1];
-  faces_[0][2] = connectivity_[3];
-  oppositeVertices_[0] = connectivity_[2];
-
-  faces_[1][0] = connectivity_[1];
-  faces_[1][1] = connectivity_[2];
-  faces_[1][2] = connectivity_[3];
-  oppositeVertices_[1] = connectivity_[0];
-
-  faces_[2][0] = connectivity_[0];
-  faces_[2][1] = connectivity_[2];
-  faces_[2][2] = connectivity_[3];
-  oppositeVertices_[2] = connectivity_[1];
-
-  faces_[3][0] = connectivity_[0];
-  faces_[3][1] = connectivity_[1];
-  faces_[3][2] = connectivity_[2];
-  oppositeVertices_[3] = connectivity_[3];
-  
-  ffaces_ = faces_;
-
-  nodePerFace_ = 3;
-}
-
-
-// ----------------------------------------------------------
-//   buildFaces0ForTet4
-// ----------------------------------------------------------
-
-void Element::buildFaces0ForTet4_ ()
-{
-  faces0_ .resize ( 4 );
-  ffaces0_.resize ( 4 );
-  oppositeVertices_.resize ( 4 );
-
-  faces0_[0].resize ( 3 );
-  faces0_[1].resize ( 3 );
-  faces0_[2].resize ( 3 );
-  faces0_[3].resize ( 3 );
-
-  faces0_[0][0] = connectivity0_[0];
-  faces0_[0][1] = connectivity0_[1];
-  faces0_[0][2] = connectivity0_[3];
-  oppositeVertices_[0] = connectivity0_[2];
-
-  faces0_[1][0] = connectivity0_[1];
-  faces0_[1][1] = connectivity0_[2];
-  faces0_[1][2] = connectivity0_[3];
-  oppositeVertices_[1] = connectivity0_[0];
-
-  faces0_[2][0] = connectivity0_[0];
-  faces0_[2][1] = connectivity0_[2];
-  faces0_[2][2] = connectivity0_[3];
-  oppositeVertices_[2] = connectivity0_[1];
-
-  faces0_[3][0] = connectivity0_[0];
-  faces0_[3][1] = connectivity0_[1];
-  faces0_[3][2] = connectivity0_[2];
-  oppositeVertices_[3] = connectivity0_[3];
-
-  ffaces0_ = faces0_;
-
-  nodePerFace_ = 3;
-}
-
-// ----------------------------------------------------------
-//   buildFacesForTet10
-// ----------------------------------------------------------
-
-void Element::buildFacesForTet10_ ()
-{
-  faces_. resize ( 4 );
-  ffaces_.resize ( 4 );
-  oppositeVertices_.resize ( 4 );
-
-  faces_[0].resize ( 3 ); faces_[1].resize ( 3 );
-  faces_[2].resize ( 3 ); faces_[3].resize ( 3 );
-
-  faces_[0][0] = connectivity_[0];
-  faces_[0][1] = connectivity_[1];
-  faces_[0][2] = connectivity_[3];
-  oppositeVertices_[0] = connectivity_[2];
-
-  ffaces_[0].resize ( 6 );
-  ffaces_[0][0] = connectivity_[0]; ffaces_[0][3] = connectivity_[4];
-  ffaces_[0][1] = connectivity_[1]; ffaces_[0][4] = connectivity_[9];
-  ffaces_[0][2] = connectivity_[3]; ffaces_[0][5] = connectivity_[7];
-
-  faces_[1][0] = connectivity_[1];
-  faces_[1][1] = connectivity_[2];
-  faces_[1][2] = connectivity_[3];
-  oppositeVertices_[1] = connectivity_[0];
-
-  ffaces_[1].resize ( 6 );
-  ffaces_[1][0] = connectivity_[1]; ffaces_[1][3] = connectivity_[5];
-  ffaces_[1][1] = connectivity_[2]; ffaces_[1][4] = connectivity_[8];
-  ffaces_[1][2] = connectivity_[3]; ffaces_[1][5] = connectivity_[9];
-
-  faces_[2][0] = connectivity_[0];
-  faces_[2][1] = connectivity_[2];
-  faces_[2][2] = connectivity_[3];
-  oppositeVertices_[2] = connectivity_[1];
-
-  ffaces_[2].resize ( 6 );
-  ffaces_[2][0] = connectivity_[0]; ffaces_[2][3] = connectivity_[6];
-  ffaces_[2][1] = connectivity_[2]; ffaces_[2][4] = connectivity_[8];
-  ffaces_[2][2] = connectivity_[3]; ffaces_[2][5] = connectivity_[7];
-
-  faces_[3][0] = connectivity_[0];
-  faces_[3][1] = connectivity_[1];
-  faces_[3][2] = connectivity_[2];
-  oppositeVertices_[3] = connectivity_[3];
-
-  ffaces_[3].resize ( 6 );
-  ffaces_[3][0] = connectivity_[0]; ffaces_[3][3] = connectivity_[4];
-  ffaces_[3][1] = connectivity_[1]; ffaces_[3][4] = connectivity_[5];
-  ffaces_[3][2] = connectivity_[2]; ffaces_[3][5] = connectivity_[6];
-
-  nodePerFace_ = 3;
-}
-
-
-// ----------------------------------------------------------
-//   buildFaces0ForTet10
-// ----------------------------------------------------------
-
-void Element::buildFaces0ForTet10_ ()
-{
-  faces0_. resize ( 4 );
-  ffaces0_.resize ( 4 );
-  oppositeVertices_.resize ( 4 );
-
-  faces0_[0].resize ( 3 ); faces0_[1].resize ( 3 );
-  faces0_[2].resize ( 3 ); faces0_[3].resize ( 3 );
-
-  faces0_[0][0] = connectivity0_[0];
-  faces0_[0][1] = connectivity0_[1];
-  faces0_[0][2] = connectivity0_[3];
-  oppositeVertices_[0] = connectivity0_[2];
-
-  ffaces0_[0].resize ( 6 );
-  ffaces0_[0][0] = connectivity0_[0]; ffaces0_[0][3] = connectivity0_[4];
-  ffaces0_[0][1] = connectivity0_[1]; ffaces0_[0][4] = connectivity0_[9];
-  ffaces0_[0][2] = connectivity0_[3]; ffaces0_[0][5] = connectivity0_[7];
-
-  faces0_[1][0] = connectivity0_[1];
-  faces0_[1][1] = connectivity0_[2];
-  faces0_[1][2] = connectivity0_[3];
-  oppositeVertices_[1] = connectivity0_[0];
-
-  ffaces0_[1].resize ( 6 );
-  ffaces0_[1][0] = connectivity0_[1]; ffaces0_[1][3] = connectivity0_[5];
-  ffaces0_[1][1] = connectivity0_[2]; ffaces0_[1][4] = connectivity0_[8];
-  ffaces0_[1][2] = connectivity0_[3]; ffaces0_[1][5] = connectivity0_[9];
-
-  faces0_[2][0] = connectivity0_[0];
-  faces0_[2][1] = connectivity0_[2];
-  faces0_[2][2] = connectivity0_[3];
-  oppositeVertices_[2] = connectivity0_[1];
-
-  ffaces0_[2].resize ( 6 );
-  ffaces0_[2][0] = connectivity0_[0]; ffaces0_[2][3] = connectivity0_[6];
-  ffaces0_[2][1] = connectivity0_[2]; ffaces0_[2][4] = connectivity0_[8];
-  ffaces0_[2][2] = connectivity0_[3]; ffaces0_[2][5] = connectivity0_[7];
-
-  faces0_[3][0] = connectivity0_[0];
-  faces0_[3][1] = connectivity0_[1];
-  faces0_[3][2] = connectivity0_[2];
-  oppositeVertices_[3] = connectivity0_[3];
-
-  ffaces0_[3].resize ( 6 );
-  ffaces0_[3][0] = connectivity0_[0]; ffaces0_[3][3] = connectivity0_[4];
-  ffaces0_[3][1] = connectivity0_[1]; ffaces0_[3][4] = connectivity0_[5];
-  ffaces0_[3][2] = connectivity0_[2]; ffaces0_[3][5] = connectivity0_[6];
-
-  nodePerFace_ = 3;
-}
-
-// ----------------------------------------------------------
-//   buildFacesForHex8
-// ----------------------------------------------------------
-
-void Element::buildFacesForHex8_ ()
-{
-  isQuadratic_ = false;
-
-  faces_.           resize ( 6 );
-  ffaces_.          resize ( 6 );
-  oppositeVertices_.resize ( 6 );
-
-  faces_[0].resize ( 4 ); faces_[1].resize ( 4 ); faces_[2].resize ( 4 );
-  faces_[3].resize ( 4 ); faces_[4].resize ( 4 ); faces_[5].resize ( 4 );
-
-  faces_[0][0] = connectivity_[0];
-  faces_[0][1] = connectivity_[3];
-  faces_[0][2] = connectivity_[2];
-  faces_[0][3] = connectivity_[1];
-  oppositeVertices_[0] = connectivity_[4];
-
-  faces_[1][0] = connectivity_[4];
-  faces_[1][1] = connectivity_[7];
-  faces_[1][2] = connectivity_[6];
-  faces_[1][3] = connectivity_[5];
-  oppositeVertices_[1] = connectivity_[0];
-
-  faces_[2][0] = connectivity_[4];
-  faces_[2][1] = connectivity_[0];
-  faces_[2][2] = connectivity_[1];
-  faces_[2][3] = connectivity_[5];
-  oppositeVertices_[2] = connectivity_[7];
-
-  faces_[3][0] = connectivity_[7];
-  faces_[3][1] = connectivity_[6];
-  faces_[3][2] = connectivity_[2];
-  faces_[3][3] = connectivity_[3];
-  oppositeVertices_[3] = connectivity_[4];
-
-  faces_[4][0] = connectivity_[1];
-  faces_[4][1] = connectivity_[5];
-  faces_[4][2] = connectivity_[6];
-  faces_[4][3] = connectivity_[2];
-  oppositeVertices_[4] = connectivity_[0];
-
-  faces_[5][0] = connectivity_[3];
-  faces_[5][1] = connectivity_[0];
-  faces_[5][2] = connectivity_[4];
-  faces_[5][3] = connectivity_[7];
-  oppositeVertices_[5] = connectivity_[2];
-
-  ffaces_ = faces_;
-
-  nodePerFace_ = 4;
-}
-
-// ----------------------------------------------------------
-//   buildFaces0ForHex8
-// ----------------------------------------------------------
-
-void Element::buildFaces0ForHex8_ ()
-{
-  isQuadratic_ = false;
-
-  faces0_.          resize ( 6 );
-  ffaces0_.         resize ( 6 );
-  oppositeVertices_.resize ( 6 );
-
-  faces0_[0].resize ( 4 ); faces0_[1].resize ( 4 ); faces0_[2].resize ( 4 );
-  faces0_[3].resize ( 4 ); faces0_[4].resize ( 4 ); faces0_[5].resize ( 4 );
-
-  faces0_[0][0] = connectivity0_[0];
-  faces0_[0][1] = connectivity0_[3];
-  faces0_[0][2] = connectivity0_[2];
-  faces0_[0][3] = connectivity0_[1];
-  oppositeVertices_[0] = connectivity_[4];
-
-  faces0_[1][0] = connectivity0_[4];
-  faces0_[1][1] = connectivity0_[7];
-  faces0_[1][2] = connectivity0_[6];
-  faces0_[1][3] = connectivity0_[5];
-  oppositeVertices_[1] = connectivity_[0];
-
-  faces0_[2][0] = connectivity0_[4];
-  faces0_[2][1] = connectivity0_[0];
-  faces0_[2][2] = connectivity0_[1];
-  faces0_[2][3] = connectivity0_[5];
-  oppositeVertices_[2] = connectivity_[7];
-
-  faces0_[3][0] = connectivity0_[7];
-  faces0_[3][1] = connectivity0_[6];
-  faces0_[3][2] = connectivity0_[2];
-  faces0_[3][3] = connectivity0_[3];
-  oppositeVertices_[3] = connectivity_[4];
-
-  faces0_[4][0] = connectivity0_[1];
-  faces0_[4][1] = connectivity0_[5];
-  faces0_[4][2] = connectivity0_[6];
-  faces0_[4][3] = connectivity0_[2];
-  oppositeVertices_[4] = connectivity_[0];
-
-  faces0_[5][0] = connectivity0_[3];
-  faces0_[5][1] = connectivity0_[0];
-  faces0_[5][2] = connectivity0_[4];
-  faces0_[5][3] = connectivity0_[7];
-  oppositeVertices_[5] = connectivity_[2];
-
-  ffaces0_ = faces0_;
-
-  nodePerFace_ = 4;
-}
-
-// ----------------------------------------------------------
-//   buildFacesForHex20
-// ----------------------------------------------------------
-
-void Element::buildFacesForHex20_ ()
-{
-  faces_.           resize ( 6 );
-  ffaces_.          resize ( 6 );
-  oppositeVertices_.resize ( 6 );
-
-  faces_[0].resize ( 4 ); faces_[1].resize ( 4 ); faces_[2].resize ( 4 );
-  faces_[3].resize ( 4 ); faces_[4].resize ( 4 ); faces_[5].resize ( 4 );
-
-  faces_[0][0] = connectivity_[0];
-  faces_[0][1] = connectivity_[3];
-  faces_[0][2] = connectivity_[2];
-  faces_[0][3] = connectivity_[1];
-  oppositeVertices_[0] = connectivity_[4];
-
-  ffaces_[0].resize ( 8 );
-  ffaces_[0][0] = connectivity_[0]; ffaces_[0][4] = connectivity_[8];
-  ffaces_[0][1] = connectivity_[1]; ffaces_[0][5] = connectivity_[11];
-  ffaces_[0][2] = connectivity_[2]; ffaces_[0][6] = connectivity_[13];
-  ffaces_[0][3] = connectivity_[3]; ffaces_[0][7] = connectivity_[9];
-
-  faces_[1][0] = connectivity_[4];
-  faces_[1][1] = connectivity_[7];
-  faces_[1][2] = connectivity_[6];
-  faces_[1][3] = connectivity_[5];
-  oppositeVertices_[1] = connectivity_[0];
-
-  ffaces_[1].resize ( 8 );
-  ffaces_[1][0] = connectivity_[4]; ffaces_[1][4] = connectivity_[16];
-  ffaces_[1][1] = connectivity_[5]; ffaces_[1][5] = connectivity_[18];
-  ffaces_[1][2] = connectivity_[6]; ffaces_[1][6] = connectivity_[19];
-  ffaces_[1][3] = connectivity_[7]; ffaces_[1][7] = connectivity_[17];
-
-  faces_[2][0] = connectivity_[4];
-  faces_[2][1] = connectivity_[0];
-  faces_[2][2] = connectivity_[1];
-  faces_[2][3] = connectivity_[5];
-  oppositeVertices_[2] = connectivity_[7];
-
-  ffaces_[2].resize ( 8 );
-  ffaces_[2][0] = connectivity_[4]; ffaces_[2][4] = connectivity_[16];
-  ffaces_[2][1] = connectivity_[5]; ffaces_[2][5] = connectivity_[12];
-  ffaces_[2][2] = connectivity_[1]; ffaces_[2][6] = connectivity_[8];
-  ffaces_[2][3] = connectivity_[0]; ffaces_[2][7] = connectivity_[10];
-
-  faces_[3][0] = connectivity_[7];
-  faces_[3][1] = connectivity_[6];
-  faces_[3][2] = connectivity_[2];
-  faces_[3][3] = connectivity_[3];
-  oppositeVertices_[3] = connectivity_[4];
-
-  ffaces_[3].resize ( 8 );
-  ffaces_[3][0] = connectivity_[7];  ffaces_[3][4] = connectivity_[19];
-  ffaces_[3][1] = connectivity_[6];  ffaces_[3][5] = connectivity_[14];
-  ffaces_[3][2] = connectivity_[2];  ffaces_[3][6] = connectivity_[13];
-  ffaces_[3][3] = connectivity_[3];  ffaces_[3][7] = connectivity_[15];
-
-  faces_[4][0] = connectivity_[1];
-  faces_[4][1] = connectivity_[5];
-  faces_[4][2] = connectivity_[6];
-  faces_[4][3] = connectivity_[2];
-  oppositeVertices_[4] = connectivity_[0];
-
-  ffaces_[4].resize ( 8 );
-  ffaces_[4][0] = connectivity_[1]; ffaces_[4][4] = connectivity_[11];
-  ffaces_[4][1] = connectivity_[2]; ffaces_[4][5] = connectivity_[14];
-  ffaces_[4][2] = connectivity_[6]; ffaces_[4][6] = connectivity_[18];
-  ffaces_[4][3] = connectivity_[5]; ffaces_[4][7] = connectivity_[12];
-
-  faces_[5][0] = connectivity_[3];
-  faces_[5][1] = connectivity_[0];
-  faces_[5][2] = connectivity_[4];
-  faces_[5][3] = connectivity_[7];
-  oppositeVertices_[5] = connectivity_[2];
-
-  ffaces_[5].resize ( 8 );
-  ffaces_[5][0] = connectivity_[3]; ffaces_[5][4] = connectivity_[15];
-  ffaces_[5][1] = connectivity_[7]; ffaces_[5][5] = connectivity_[17];
-  ffaces_[5][2] = connectivity_[4]; ffaces_[5][6] = connectivity_[10];
-  ffaces_[5][3] = connectivity_[0]; ffaces_[5][7] = connectivity_[9];
-
-  nodePerFace_ = 4;
-}
-
-
-// ----------------------------------------------------------
-//   buildFaces0ForHex20
-// ----------------------------------------------------------
-
-void Element::buildFaces0ForHex20_ ()
-{
-  faces0_.           resize ( 6 );
-  ffaces0_.          resize ( 6 );
-  oppositeVertices_.resize ( 6 );
-
-  faces0_[0].resize ( 4 ); faces0_[1].resize ( 4 ); faces0_[2].resize ( 4 );
-  faces0_[3].resize ( 4 ); faces0_[4].resize ( 4 ); faces0_[5].resize ( 4 );
-
-  faces0_[0][0] = connectivity0_[0];
-  faces0_[0][1] = connectivity0_[3];
-  faces0_[0][2] = connectivity0_[2];
-  faces0_[0][3] = connectivity0_[1];
-  oppositeVertices_[0] = connectivity_[4];
-
-  ffaces0_[0].resize ( 8 );
-  ffaces0_[0][0] = connectivity0_[0]; ffaces0_[0][4] = connectivity0_[8];
-  ffaces0_[0][1] = connectivity0_[1]; ffaces0_[0][5] = connectivity0_[11];
-  ffaces0_[0][2] = connectivity0_[2]; ffaces0_[0][6] = connectivity0_[13];
-  ffaces0_[0][3] = connectivity0_[3]; ffaces0_[0][7] = connectivity0_[9];
-
-  faces0_[1][0] = connectivity0_[4];
-  faces0_[1][1] = connectivity0_[7];
-  faces0_[1][2] = connectivity0_[6];
-  faces0_[1][3] = connectivity0_[5];
-  oppositeVertices_[1] = connectivity_[0];
-
-  ffaces0_[1].resize ( 8 );
-  ffaces0_[1][0] = connectivity0_[4]; ffaces0_[1][4] = connectivity0_[16];
-  ffaces0_[1][1] = connectivity0_[5]; ffaces0_[1][5] = connectivity0_[18];
-  ffaces0_[1][2] = connectivity0_[6]; ffaces0_[1][6] = connectivity0_[19];
-  ffaces0_[1][3] = connectivity0_[7]; ffaces0_[1][7] = connectivity0_[17];
-
-  faces0_[2][0] = connectivity0_[4];
-  faces0_[2][1] = connectivity0_[0];
-  faces0_[2][2] = connectivity0_[1];
-  faces0_[2][3] = connectivity0_[5];
-  oppositeVertices_[2] = connectivity0_[7];
-
-  ffaces0_[2].resize ( 8 );
-  ffaces0_[2][0] = connectivity0_[4]; ffaces0_[2][4] = connectivity0_[16];
-  ffaces0_[2][1] = connectivity0_[5]; ffaces0_[2][5] = connectivity0_[12];
-  ffaces0_[2][2] = connectivity0_[1]; ffaces0_[2][6] = connectivity0_[8];
-  ffaces0_[2][3] = connectivity0_[0]; ffaces0_[2][7] = connectivity0_[10];
-
-  faces0_[3][0] = connectivity0_[7];
-  faces0_[3][1] = connectivity0_[6];
-  faces0_[3][2] = connectivity0_[2];
-  faces0_[3][3] = connectivity0_[3];
-  oppositeVertices_[3] = connectivity_[4];
-
-  ffaces0_[3].resize ( 8 );
-  ffaces0_[3][0] = connectivity0_[7];  ffaces0_[3][4] = connectivity0_[19];
-  ffaces0_[3][1] = connectivity0_[6];  ffaces0_[3][5] = connectivity0_[14];
-  ffaces0_[3][2] = connectivity0_[2];  ffaces0_[3][6] = connectivity0_[13];
-  ffaces0_[3][3] = connectivity0_[3];  ffaces0_[3][7] = connectivity0_[15];
-
-  faces0_[4][0] = connectivity0_[1];
-  faces0_[4][1] = connectivity0_[5];
-  faces0_[4][2] = connectivity0_[6];
-  faces0_[4][3] = connectivity0_[2];
-  oppositeVertices_[4] = connectivity_[0];
-
-  ffaces0_[4].resize ( 8 );
-  ffaces0_[4][0] = connectivity0_[1]; ffaces0_[4][4] = connectivity0_[11];
-  ffaces0_[4][1] = connectivity0_[2]; ffaces0_[4][5] = connectivity0_[14];
-  ffaces0_[4][2] = connectivity0_[6]; ffaces0_[4][6] = connectivity0_[18];
-  ffaces0_[4][3] = connectivity0_[5]; ffaces0_[4][7] = connectivity0_[12];
-
-  faces0_[5][0] = connectivity0_[3];
-  faces0_[5][1] = connectivity0_[0];
-  faces0_[5][2] = connectivity0_[4];
-  faces0_[5][3] = connectivity0_[7];
-  oppositeVertices_[5] = connectivity_[2];
-
-  ffaces0_[5].resize ( 8 );
-  ffaces0_[5][0] = connectivity0_[3]; ffaces0_[5][4] = connectivity0_[15];
-  ffaces0_[5][1] = connectivity0_[7]; ffaces0_[5][5] = connectivity0_[17];
-  ffaces0_[5][2] = connectivity0_[4]; ffaces0_[5][6] = connectivity0_[10];
-  ffaces0_[5][3] = connectivity0_[0]; ffaces0_[5][7] = connectivity0_[9];
-
-  nodePerFace_ = 4;
-}
-
-// ----------------------------------------------------
-//    getJemConnect2DQuadratic_
-// ----------------------------------------------------
-
-// Jemjive format: nodes (corner and midside) are continuous
-
-void Element::getJemConnect2DQuadratic_
-
-     ( IntVector& connect )            const
-{
-
-  int  halfNodeCount = connect.size () / 2;
-
-  //print(connectivity_.begin(),connectivity_.end());
-
-  for ( int i = 0; i < halfNodeCount; i++ )
-  {
-    connect[2*i]   = connectivity_[i];
-    connect[2*i+1] = connectivity_[halfNodeCount+i];
-  }
-
-  //print(connect.begin(),connect.end());
-}
-
-
-// ----------------------------------------------------
-//    getJemConnectTet10_
-// ----------------------------------------------------
-
-
-void Element::getJemConnectTet10_
-
-     ( IntVector& connect )            const
-{
-  connect[0] = connectivity_[0]; connect[3] = connectivity_[9];
-  connect[1] = connectivity_[7]; connect[4] = connectivity_[1];
-  connect[2] = connectivity_[3]; connect[5] = connectivity_[4];
-
-  connect[6] = connectivity_[6];
-  connect[7] = connectivity_[8];
-  connect[8] = connectivity_[5];
-
-  connect[9] = connectivity_[2];
-}
-
-
-// ----------------------------------------------------
-//    getJemConnectHex20_
-// ----------------------------------------------------
-
-void Element::getJemConnectHex20_
-
-     ( IntVector& connect )            const
-{
-  connect[0]  = connectivity_[0];  connect[4] = connectivity_[5];
-  connect[1]  = connectivity_[10]; connect[5] = connectivity_[12];
-  connect[2]  = connectivity_[4];  connect[6] = connectivity_[1];
-  connect[3]  = connectivity_[16]; connect[7] = connectivity_[8];
-
-  connect[8]  = connectivity_[9];  connect[10] = connectivity_[18];
-  connect[9]  = connectivity_[17]; connect[11] = connectivity_[11];
-
-  connect[12] = connectivity_[3];  connect[16] = connectivity_[6];
-  connect[13] = connectivity_[15]; connect[17] = connectivity_[14];
-  connect[14] = connectivity_[7];  connect[18] = connectivity_[2];
-  connect[15] = connectivity_[19]; connect[19] = connectivity_[13];
-}
-
 // ----------------------------------------------------
 //    computeElementSizeTriangle_
 // ----------------------------------------------------
 
 double Element::computeElementSizeTriangle_ ( Global&  globdat ) const
 {
-  int id1 = connectivity0_[0]; 
-  int id2 = connectivity0_[1]; 
-  int id3 = connectivity0_[2]; 
+  int id1 = conn0_()[0]; 
+  int id2 = conn0_()[1]; 
+  int id3 = conn0_()[2]; 
   
-  NodePointer node1, node2, node3;
+  const NodeStore& nodes = globdat.nodeSet;
 
-  node1 = globdat.nodeSet[globdat.nodeId2Position[id1]];
-  node2 = globdat.nodeSet[globdat.nodeId2Position[id2]];
-  node3 = globdat.nodeSet[globdat.nodeId2Position[id3]];
+  int node1 = globdat.nodeId2Position[id1];
+  int node2 = globdat.nodeId2Position[id2];
+  int node3 = globdat.nodeId2Position[id3];
 
-  double a = sqrt(pow((node2->getX() - node1->getX()),2) + pow((node2->getY() - node1->getY()),2));
-  double b = sqrt(pow((node3->getX() - node2->getX()),2) + pow((node3->getY() - node2->getY()),2));
-  double c = sqrt(pow((node1->getX() - node3->getX()),2) + pow((node1->getY() - node3->getY()),2));
+  double a = sqrt(pow((nodes.getX(node2) - nodes.getX(node1)),2) + pow((nodes.getY(node2) - nodes.getY(node1)),2));
+  double b = sqrt(pow((nodes.getX(node3) - nodes.getX(node2)),2) + pow((nodes.getY(node3) - nodes.getY(node2)),2));
+  double c = sqrt(pow((nodes.getX(node1) - nodes.getX(node3)),2) + pow((nodes.getY(node1) - nodes.getY(node3)),2));
 
   double s = 0.5 * (a + b + c);
   double A =  sqrt ( s * (s-a) * (s-b) * (s-c) );
@@ -11,8 +11,64 @@
 #define ELEMENT_H
 
 #include "typedefs.h"
+#include "Span.h"
+#include "ElemStore.h"
+#include "ElementTraits.h"
 
 class Global;
+class IdMap;
+class NodeStore;
+
+// =====================================================================
+//     class FaceView
+// =====================================================================
+
+// A face of a 3D element: the connectivity entries at the local node
+// numbers of one row of its face table. Nothing is stored; the nodes
+// are looked up when they are read.
+
+class FaceView
+{
+  public:
+
+                         FaceView
+
+      ( const int*         conn,
+        const int*         local,
+        int                size )
+
+      : conn_(conn), local_(local), size_(size) {}
+
+    int                  size () const { return size_; }
+
+    int                  operator [] ( int i ) const
+    {
+      return conn_[local_[i]];
+    }
+
+    bool                 contains ( int node ) const
+    {
+      for ( int i = 0; i < size_; i++ )
+      {
+        if ( conn_[local_[i]] == node ) return true;
+      }
+
+      return false;
+    }
+
+    void                 get ( IntVector& nodes ) const
+    {
+      nodes.resize ( size_ );
+
+      for ( int i = 0; i < size_; i++ ) nodes[i] = conn_[local_[i]];
+    }
+
+  private:
+
+    const int*           conn_;
+    const int*           local_;
+    int                  size_;
+};
 
 // =====================================================================
 //     class ELEMENT
@@ -20,6 +76,12 @@ class Global;
 
 // For quadratic elements:
 // the connectivity follows Gmsh's format !!!
+//
+// The id, type and connectivity of an element live in an ElemStore;
+// the constructors add a row to the store (or take a row filled in
+// beforehand) and the element keeps its position in it. The faces of
+// 3D elements are not stored either: they are read from the
+// connectivity through the face table of the element type.
 
 class Element
 {
@@ -27,24 +89,30 @@ class Element
 
                          Element
 
-	( int index, int elemType, 
+	( ElemStore& store, int index, int elemType, 
 	  const IntVector& connec );
 
                          Element
 
-	( int index, int elemType, 
+	( ElemStore& store, int index, int elemType, 
 	  const IntVector& connec, bool isNURBS );
 
 			 Element
 
-	( int index, 
+	( ElemStore& store, int index, 
 	  const IntVector& connec );
 
                          Element
 
-	( int index, int elemType, 
+	( ElemStore& store, int index, int elemType, 
 	  const IntVector& connec, int bulk1, int bulk2 );
 
+    // the element on row pos of store, which already holds its data
+
+                         Element
+
+	( ElemStore& store, int pos, int bulk1 = -1, int bulk2 = -1 );
+
     // get the new connectivity (full)
 
     inline void		 getConnectivity
@@ -69,6 +137,18 @@ class Element
 
         ( IntVector& connec ) const;
 
+    // number of corner nodes, the size of the corner connectivity
+
+    inline int           getCornerCount () const;
+
+    // the same connectivities as views on the store, nothing is copied;
+    // they stay valid as long as no element is added to the store
+
+    inline IntSpan       getNodes        () const;
+    inline IntSpan       getNodes0       () const;
+    inline IntSpan       getCornerNodes  () const;
+    inline IntSpan       getCornerNodes0 () const;
+
     inline void          setConnectivity
 
         ( const IntVector& newConnec );
@@ -89,10 +169,19 @@ class Element
       
         ( int oldId, int newId );
 
-    // 3D elements: build face datastructures
+    // node local of the (modified) connectivity becomes newId
 
-    void                 buildFaces0 ( );
-    void                 buildFaces  ( );
+    inline void          changeNode
+
+        ( int local, int newId );
+
+    // 3D elements: the number of faces (0 for 2D elements) and face
+    // index of the modified and the original mesh, vertices only
+
+    inline int           getFaceCount () const;
+
+    inline FaceView      getFace      ( int index ) const;
+    inline FaceView      getFace0     ( int index ) const;
 
     // 3D elements: get all faces and the nodes in each face are sorted
     // to facilitate equality comparison to find commond faces
@@ -113,6 +202,12 @@ class Element
     void                 getFaces 
       
          ( vector<IntVector>& faces ) const;
+
+    // The same as getFaces but for the original mesh
+
+    void                 getFaces0
+      
+         ( vector<IntVector>& faces ) const;
     
     void                 getFFaces 
       
@@ -131,23 +226,28 @@ class Element
          ( IntVector& fface,
 	   int        index ) const;
 
+    // the same as views, without copying
+
+    inline FaceView      getFullFace  ( int index ) const;
+    inline FaceView      getFullFace0 ( int index ) const;
+
    // check if a 3D element has a face on the interface or not
-   // if so, return the indices of nodes of that face 
+   // if so, return the (original) indices of nodes of that face 
     
    bool                  isOnInterface 
       
          ( IntVector&        face,    
 	   int&              oppVertex,
 	   int&              fIndex,
-	   const NodeSet&    nodeSet,
-	         Int2IntMap& position ) const;
+	   const NodeStore&  nodeSet,
+	   const IdMap&      position ) const;
 
    // check if a 3D element has a face on the interface or not 
 
    bool                  isInterfaceElement 
 
-         ( const NodeSet&    nodeSet,
-	         Int2IntMap& position )  const;
+         ( const NodeStore&  nodeSet,
+	   const IdMap&      position )  const;
 
    // return the coordinate bounds of a face  of a 3D element.
 
@@ -170,9 +270,11 @@ class Element
          ( IntVector& connec )            const;
 
    inline void           setNURBS ( );
+   inline bool           getIsNURBS () const;
 
    // for an edge (node1,node2), find the index of element
    // also contains this edge: useful for discontinuous Galerkin methods.
+   // Only the elements across an edge (face) are searched; -1 if none.
 
    int                   getIndexElementContainsEdge
 
@@ -191,59 +293,28 @@ class Element
 
   private:
 
-   void                  buildFacesForTet4_   ( );
-   void                  buildFaces0ForTet4_  ( );
-   void                  buildFacesForTet10_  ( );
-   void                  buildFaces0ForTet10_ ( );
-   void                  buildFacesForHex8_   ( );
-   void                  buildFaces0ForHex8_  ( );
-   void                  buildFacesForHex20_  ( );
-   void                  buildFaces0ForHex20_ ( );
-
-
-   inline void           getJemConnectLinear_
-
-         ( IntVector& connec )            const; 
-
-   void                  getJemConnect2DQuadratic_
-
-         ( IntVector& connec )            const; 
-
-   void                  getJemConnectTet10_
-
-         ( IntVector& connec )            const; 
-
-
-   void                  getJemConnectHex20_
+   double                computeElementSizeTriangle_( Global& globdat ) const;
 
-         ( IntVector& connec )            const; 
+   // the row of this element in the store
 
-   double                computeElementSizeTriangle_( Global& globdat ) const;
+   inline const int*     conn0_     () const;
+   inline const int*     conn_      () const;
+   inline int*           conn_      ();
+   inline int            nodeCount_ () const;
 
   private:
 
-    int                  index_;
-    int                  elemType_;   // used with Paraview format
+    ElemStore*           store_;      // id, type (used with Paraview format)
+    int                  pos_;        // and connectivity arrays
 
-    IntVector            connectivity_;     // modified connectivity array
-    IntVector            connectivity0_;    // original connectivity array
+    const FaceTable*     faceTable_;  // 0 for 2D elements
 
     bool                 done_;
-    bool                 isQuadratic_;
     bool                 isChanged_;
     bool                 isNURBS_;
     int                  bulk1_;
     int                  bulk2_;
-
-    // 3D data
-
-    vector<IntVector>    faces_;             // store the corner vertex indices of faces
-    vector<IntVector>    faces0_;            // store the corner vertex indices of faces
-    vector<IntVector>    ffaces_;            // store the vertex indices of faces (modified mesh)
-    vector<IntVector>    ffaces0_;           // store the vertex indices of faces (original mesh)
-    IntVector            oppositeVertices_; // store the opposite vertices of  all faces
-
-    int                  nodePerFace_;
+    int                  cornerCount_;
 };
 
 // ==========================================================
@@ -258,12 +329,12 @@ struct PrintElement;
 
 inline int Element::getIndex () const
 {
-  return index_;
+  return store_->getIndex ( pos_ );
 }
 
 inline int Element::getElemType () const
 {
-  return elemType_;
+  return store_->getElemType ( pos_ );
 }
 
 inline int Element::getBulk1 () const
@@ -278,7 +349,7 @@ inline int Element::getBulk2 () const
 
 inline void  Element::setElemType ( int type )
 {
-  elemType_ = type;
+  store_->setElemType ( pos_, type );
 }
 
 inline  void Element::setDone ( bool done ) 
@@ -296,34 +367,58 @@ inline bool Element::getChanged () const
   return isChanged_;
 }
 
+inline int Element::getCornerCount () const
+{
+  return cornerCount_;
+}
+
+inline IntSpan Element::getNodes () const
+{
+  return IntSpan ( conn_(), conn_() + nodeCount_() );
+}
+
+inline IntSpan Element::getNodes0 () const
+{
+  return IntSpan ( conn0_(), conn0_() + nodeCount_() );
+}
+
+inline IntSpan Element::getCornerNodes () const
+{
+  return IntSpan ( conn_(), conn_() + cornerCount_ );
+}
+
+inline IntSpan Element::getCornerNodes0 () const
+{
+  return IntSpan ( conn0_(), conn0_() + cornerCount_ );
+}
+
 inline void Element::getConnectivity
 
    ( IntVector& connec ) const
 {
-  connec.resize ( connectivity_.size() );
-  connec = connectivity_;	
+  connec.assign ( conn_(), conn_() + nodeCount_() );
 }
 
 inline void Element::getConnectivity0
 
    ( IntVector& connec ) const
 {
-  connec.resize ( connectivity0_.size() );
-  connec = connectivity0_;	
+  connec.assign ( conn0_(), conn0_() + nodeCount_() );
 }
 
+// the new connectivity has as many nodes as the old one
 
 inline void Element::setConnectivity
 
         ( const IntVector& newConnec )
 {
-  connectivity_ = newConnec;
+  copy ( newConnec.begin(), newConnec.end(), conn_() );
 }
 
 inline void Element::changeConnectivity ( int oldId, int newId )
 {
-  replace ( connectivity_.begin(),
-	    connectivity_.end  (),
+  replace ( conn_(),
+	    conn_() + nodeCount_(),
 	    oldId, newId );
 
   if ( !isChanged_ && newId != oldId )
@@ -332,13 +427,54 @@ inline void Element::changeConnectivity ( int oldId, int newId )
   }
 }
 
+inline void Element::changeNode ( int local, int newId )
+{
+  if ( conn_()[local] != newId )
+  {
+    conn_()[local] = newId;
+    isChanged_     = true;
+  }
+}
+
+inline int Element::getFaceCount () const
+{
+  return faceTable_ ? faceTable_->faceCount : 0;
+}
+
+inline FaceView Element::getFace ( int index ) const
+{
+  const int n = faceTable_->faceCorners;
+
+  return FaceView ( conn_(), faceTable_->faces + index * n, n );
+}
+
+inline FaceView Element::getFace0 ( int index ) const
+{
+  const int n = faceTable_->faceCorners;
+
+  return FaceView ( conn0_(), faceTable_->faces + index * n, n );
+}
+
+inline FaceView Element::getFullFace ( int index ) const
+{
+  const int n = faceTable_->fullFaceNodes;
+
+  return FaceView ( conn_(), faceTable_->fullFaces + index * n, n );
+}
+
+inline FaceView Element::getFullFace0 ( int index ) const
+{
+  const int n = faceTable_->fullFaceNodes;
+
+  return FaceView ( conn0_(), faceTable_->fullFaces + index * n, n );
+}
+
 inline void Element::getFullFace
 
    ( IntVector& fface,
      int        index ) const
 {
-  fface.resize ( ffaces_[0].size() );
-  fface = ffaces_[index];	
+  getFullFace ( index ).get ( fface );
 }
 
 inline void Element::getFullFace0
@@ -346,26 +482,42 @@ inline void Element::getFullFace0
    ( IntVector& fface,
      int        index ) const
 {
-  fface.resize ( ffaces0_[0].size() );
-  fface = ffaces0_[index];	
+  getFullFace0 ( index ).get ( fface );
 }
 
-inline void Element::getJemConnectLinear_
-
-   ( IntVector& connec ) const
+inline void Element::setNURBS ()
 {
-  connec.resize ( connectivity_.size() );
-  connec = connectivity_;	
+  isNURBS_ = true;
 }
 
-inline void Element::setNURBS ()
+inline bool Element::getIsNURBS () const
 {
-  isNURBS_ = true;
+  return isNURBS_;
 }
 
 inline int Element::getOppVertex (int faceID) const
 {
-  return oppositeVertices_[faceID];
+  return conn_()[faceTable_->opposite[faceID]];
+}
+
+inline const int* Element::conn0_ () const
+{
+  return store_->getConnectivity0 ( pos_ );
+}
+
+inline const int* Element::conn_ () const
+{
+  return store_->getConnectivity ( pos_ );
+}
+
+inline int* Element::conn_ ()
+{
+  return store_->getConnectivity ( pos_ );
+}
+
+inline int Element::nodeCount_ () const
+{
+  return store_->getNodeCount ( pos_ );
 }
 
 #endif
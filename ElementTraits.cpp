@@ -0,0 +1,106 @@
+#include "ElementTraits.h"
+
+
+// the tables are indexed at run time, so they need a definition
+
+constexpr int Tri3Traits ::EDGES[3][2];
+constexpr int Tri6Traits ::JEM_ORDER[6];
+constexpr int Quad4Traits::EDGES[4][2];
+constexpr int Quad8Traits::JEM_ORDER[8];
+
+constexpr int Tet4Traits ::EDGES[6][2];
+constexpr int Tet4Traits ::FACES[4][3];
+constexpr int Tet4Traits ::OPPOSITE[4];
+constexpr int Tet4Traits ::FULL_FACES[4][3];
+constexpr int Tet10Traits::FULL_FACES[4][6];
+constexpr int Tet10Traits::JEM_ORDER[10];
+
+constexpr int Hex8Traits ::EDGES[12][2];
+constexpr int Hex8Traits ::FACES[6][4];
+constexpr int Hex8Traits ::OPPOSITE[6];
+constexpr int Hex8Traits ::FULL_FACES[6][4];
+constexpr int Hex20Traits::FULL_FACES[6][8];
+constexpr int Hex20Traits::JEM_ORDER[20];
+
+// the face table of a 3D element type, shared by all its elements
+
+template <class Traits>
+static const FaceTable*  faceTable_ ()
+{
+  static const FaceTable  table =
+  {
+    Traits::FACE_COUNT,
+    Traits::FACE_CORNERS,
+    Traits::FULL_FACE_NODES,
+    Traits::FACES[0],
+    Traits::FULL_FACES[0],
+    Traits::OPPOSITE
+  };
+
+  return &table;
+}
+
+// =====================================================================
+//     cornerCountOf
+// =====================================================================
+
+int                      cornerCountOf
+
+  ( int                    elemType,
+    int                    nodeCount )
+
+{
+  switch ( elemType )
+  {
+    case Tri3Traits ::TYPE: return Tri3Traits ::CORNER_COUNT;
+    case Tri6Traits ::TYPE: return Tri6Traits ::CORNER_COUNT;
+    case Quad4Traits::TYPE: return Quad4Traits::CORNER_COUNT;
+    case Quad8Traits::TYPE: return Quad8Traits::CORNER_COUNT;
+    case Tet4Traits ::TYPE: return Tet4Traits ::CORNER_COUNT;
+    case Tet10Traits::TYPE: return Tet10Traits::CORNER_COUNT;
+    case Hex8Traits ::TYPE: return Hex8Traits ::CORNER_COUNT;
+    case Hex20Traits::TYPE: return Hex20Traits::CORNER_COUNT;
+  }
+
+  return nodeCount > 4 ? nodeCount / 2 : nodeCount;
+}
+
+// =====================================================================
+//     interfaceCornersOf
+// =====================================================================
+
+int                      interfaceCornersOf
+
+  ( int                    elemType )
+
+{
+  switch ( elemType )
+  {
+    case Tet4Traits ::TYPE: return Tet4Traits ::INTERFACE_CORNERS;
+    case Tet10Traits::TYPE: return Tet10Traits::INTERFACE_CORNERS;
+    case Hex8Traits ::TYPE: return Hex8Traits ::INTERFACE_CORNERS;
+    case Hex20Traits::TYPE: return Hex20Traits::INTERFACE_CORNERS;
+  }
+
+  return 3;
+}
+
+// =====================================================================
+//     faceTableOf
+// =====================================================================
+
+const FaceTable*         faceTableOf
+
+  ( int                    elemType )
+
+{
+  switch ( elemType )
+  {
+    case Tet4Traits ::TYPE: return faceTable_<Tet4Traits>  ();
+    case Tet10Traits::TYPE: return faceTable_<Tet10Traits> ();
+    case Hex8Traits ::TYPE: return faceTable_<Hex8Traits>  ();
+    case Hex20Traits::TYPE: return faceTable_<Hex20Traits> ();
+  }
+
+  return 0;
+}
@@ -0,0 +1,188 @@
+#ifndef ELEMENT_TRAITS_H
+#define ELEMENT_TRAITS_H
+
+// =====================================================================
+//     element traits
+// =====================================================================
+
+/*
+ * Compile time descriptions of the bulk element types, one struct per
+ * Gmsh element type. Local node numbers follow Gmsh: the corners first,
+ * then the midside nodes. The tables are
+ *
+ *   EDGES       the corners of the edges. Edge k of a 2D element runs
+ *               from corner k to corner k+1; in the quadratic elements
+ *               the midside node of edge k is CORNER_COUNT+k.
+ *   FACES       the corners of the faces of a 3D element, ordered so
+ *               that the normal points outwards (the order of getFaces)
+ *   FULL_FACES  all nodes of the faces (the order of getFullFace)
+ *   OPPOSITE    the corner opposite to each face
+ *   JEM_ORDER   for quadratic elements, the local node written at each
+ *               position of a jem-jive connectivity
+ *
+ * INTERFACE_CORNERS is the number of interfacial corners that makes an
+ * element an interface element (see Element::isInterfaceElement): the
+ * corners of a face in 3D, three corners in 2D.
+ */
+
+struct Tri3Traits
+{
+  static constexpr int  TYPE              = 2;
+  static constexpr int  NODE_COUNT        = 3;
+  static constexpr int  CORNER_COUNT      = 3;
+  static constexpr int  INTERFACE_CORNERS = 3;
+
+  static constexpr int  EDGE_COUNT        = 3;
+  static constexpr int  EDGES[3][2]       = { {0,1}, {1,2}, {2,0} };
+};
+
+struct Tri6Traits : public Tri3Traits
+{
+  static constexpr int  TYPE              = 9;
+  static constexpr int  NODE_COUNT        = 6;
+
+  static constexpr int  JEM_ORDER[6]      = { 0, 3, 1, 4, 2, 5 };
+};
+
+struct Quad4Traits
+{
+  static constexpr int  TYPE              = 3;
+  static constexpr int  NODE_COUNT        = 4;
+  static constexpr int  CORNER_COUNT      = 4;
+  static constexpr int  INTERFACE_CORNERS = 3;
+
+  static constexpr int  EDGE_COUNT        = 4;
+  static constexpr int  EDGES[4][2]       = { {0,1}, {1,2}, {2,3}, {3,0} };
+};
+
+struct Quad8Traits : public Quad4Traits
+{
+  static constexpr int  TYPE              = 16;
+  static constexpr int  NODE_COUNT        = 8;
+
+  static constexpr int  JEM_ORDER[8]      = { 0, 4, 1, 5, 2, 6, 3, 7 };
+};
+
+struct Tet4Traits
+{
+  static constexpr int  TYPE              = 4;
+  static constexpr int  NODE_COUNT        = 4;
+  static constexpr int  CORNER_COUNT      = 4;
+  static constexpr int  INTERFACE_CORNERS = 3;
+
+  static constexpr int  EDGE_COUNT        = 6;
+  static constexpr int  EDGES[6][2]       = { {0,1}, {1,2}, {2,0},
+                                              {3,0}, {3,2}, {3,1} };
+
+  static constexpr int  FACE_COUNT        = 4;
+  static constexpr int  FACE_CORNERS      = 3;
+  static constexpr int  FACES[4][3]       = { {0,1,3}, {1,2,3},
+                                              {0,2,3}, {0,1,2} };
+  static constexpr int  OPPOSITE[4]       = { 2, 0, 1, 3 };
+
+  static constexpr int  FULL_FACE_NODES   = 3;
+  static constexpr int  FULL_FACES[4][3]  = { {0,1,3}, {1,2,3},
+                                              {0,2,3}, {0,1,2} };
+};
+
+struct Tet10Traits : public Tet4Traits
+{
+  static constexpr int  TYPE              = 11;
+  static constexpr int  NODE_COUNT        = 10;
+
+  static constexpr int  FULL_FACE_NODES   = 6;
+  static constexpr int  FULL_FACES[4][6]  = { {0,1,3,4,9,7}, {1,2,3,5,8,9},
+                                              {0,2,3,6,8,7}, {0,1,2,4,5,6} };
+
+  static constexpr int  JEM_ORDER[10]     = { 0, 7, 3, 9, 1, 4, 6, 8, 5, 2 };
+};
+
+struct Hex8Traits
+{
+  static constexpr int  TYPE              = 5;
+  static constexpr int  NODE_COUNT        = 8;
+  static constexpr int  CORNER_COUNT      = 8;
+  static constexpr int  INTERFACE_CORNERS = 4;
+
+  static constexpr int  EDGE_COUNT        = 12;
+  static constexpr int  EDGES[12][2]      = { {0,1}, {0,3}, {0,4}, {1,2},
+                                              {1,5}, {2,3}, {2,6}, {3,7},
+                                              {4,5}, {4,7}, {5,6}, {6,7} };
+
+  static constexpr int  FACE_COUNT        = 6;
+  static constexpr int  FACE_CORNERS      = 4;
+  static constexpr int  FACES[6][4]       = { {0,3,2,1}, {4,7,6,5},
+                                              {4,0,1,5}, {7,6,2,3},
+                                              {1,5,6,2}, {3,0,4,7} };
+  static constexpr int  OPPOSITE[6]       = { 4, 0, 7, 4, 0, 2 };
+
+  static constexpr int  FULL_FACE_NODES   = 4;
+  static constexpr int  FULL_FACES[6][4]  = { {0,3,2,1}, {4,7,6,5},
+                                              {4,0,1,5}, {7,6,2,3},
+                                              {1,5,6,2}, {3,0,4,7} };
+};
+
+// the corners of a full face run the other way round than in FACES
+
+struct Hex20Traits : public Hex8Traits
+{
+  static constexpr int  TYPE              = 17;
+  static constexpr int  NODE_COUNT        = 20;
+
+  static constexpr int  FULL_FACE_NODES   = 8;
+  static constexpr int  FULL_FACES[6][8]  =
+  {
+    { 0, 1, 2, 3,  8, 11, 13,  9 }, { 4, 5, 6, 7, 16, 18, 19, 17 },
+    { 4, 5, 1, 0, 16, 12,  8, 10 }, { 7, 6, 2, 3, 19, 14, 13, 15 },
+    { 1, 2, 6, 5, 11, 14, 18, 12 }, { 3, 7, 4, 0, 15, 17, 10,  9 }
+  };
+
+  static constexpr int  JEM_ORDER[20]     = { 0, 10,  4, 16,  5, 12,  1,  8,
+                                              9, 17, 18, 11,  3, 15,  7, 19,
+                                              6, 14,  2, 13 };
+};
+
+// =====================================================================
+//     struct FaceTable
+// =====================================================================
+
+// the face tables of a 3D element type, for looking them up at run time;
+// the rows of faces and fullFaces are faceCorners and fullFaceNodes long
+
+struct FaceTable
+{
+  int                      faceCount;
+  int                      faceCorners;
+  int                      fullFaceNodes;
+
+  const int*               faces;
+  const int*               fullFaces;
+  const int*               opposite;
+};
+
+// ---------------------------------------------------------------------
+//   run time lookups
+// ---------------------------------------------------------------------
+
+// the number of corners of an element of type elemType with nodeCount
+// nodes; elements of other types (interface and boundary elements)
+// are quadratic if they have more than four nodes
+
+int                      cornerCountOf
+
+  ( int                    elemType,
+    int                    nodeCount );
+
+// INTERFACE_CORNERS of elemType, three for other types
+
+int                      interfaceCornersOf
+
+  ( int                    elemType );
+
+// the face table of elemType, 0 if it is not a 3D element type
+
+const FaceTable*         faceTableOf
+
+  ( int                    elemType );
+
+#endif
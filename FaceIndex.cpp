@@ -0,0 +1,186 @@
+#include "FaceIndex.h"
+
+
+// ------------------------------------------------------------
+//    constructor
+// ------------------------------------------------------------
+
+FaceIndex::FaceIndex ()
+{
+  rehash_ ( 16 );
+}
+
+// ------------------------------------------------------------
+//    reserve
+// ------------------------------------------------------------
+
+void FaceIndex::reserve ( int faceCount )
+{
+  keys_  .reserve ( MAX_SIZE * faceCount );
+  owners_.reserve ( 2 * faceCount );
+  locals_.reserve ( 2 * faceCount );
+
+  // the table is kept at most half full
+
+  int slotCount = slots_.size ();
+
+  while ( slotCount < 2 * faceCount ) slotCount *= 2;
+
+  if ( slotCount > int( slots_.size () ) ) rehash_ ( slotCount );
+}
+
+// ------------------------------------------------------------
+//    clear
+// ------------------------------------------------------------
+
+void FaceIndex::clear ()
+{
+  keys_  .clear ();
+  owners_.clear ();
+  locals_.clear ();
+
+  rehash_ ( 16 );
+}
+
+// ------------------------------------------------------------
+//    find
+// ------------------------------------------------------------
+
+int FaceIndex::find ( const IntVector& face ) const
+{
+  int key[MAX_SIZE];
+
+  makeKey_ ( key, face );
+
+  return slots_[findSlot_ ( key )];
+}
+
+// ------------------------------------------------------------
+//    insert
+// ------------------------------------------------------------
+
+int FaceIndex::insert ( const IntVector& face )
+{
+  if ( 2 * ( size () + 1 ) > int( slots_.size () ) )
+  {
+    rehash_ ( 2 * slots_.size () );
+  }
+
+  int key[MAX_SIZE];
+
+  makeKey_ ( key, face );
+
+  const int is = findSlot_ ( key );
+
+  if ( slots_[is] != NONE ) return slots_[is];
+
+  slots_[is] = size ();
+
+  keys_  .insert    ( keys_.end (), key, key + MAX_SIZE );
+  owners_.push_back ( int( NONE ) );
+  owners_.push_back ( int( NONE ) );
+  locals_.push_back ( 0 );
+  locals_.push_back ( 0 );
+
+  return size () - 1;
+}
+
+// ------------------------------------------------------------
+//    addOwner
+// ------------------------------------------------------------
+
+// owners beyond the second (non manifold meshes) are ignored, as
+// the neighbor search this replaces stopped at the first match
+
+void FaceIndex::addOwner
+
+  ( int  face,
+    int  elem,
+    int  localFace )
+
+{
+  for ( int i = 2*face; i < 2*face+2; i++ )
+  {
+    if ( owners_[i] == NONE )
+    {
+      owners_[i] = elem;
+      locals_[i] = localFace;
+      return;
+    }
+  }
+}
+
+// ------------------------------------------------------------
+//    makeKey_
+// ------------------------------------------------------------
+
+void FaceIndex::makeKey_
+
+  ( int*              key,
+    const IntVector&  face )
+
+{
+  const int count = face.size ();
+
+  if ( count > MAX_SIZE )
+  {
+    cerr << "FaceIndex: faces with more than " << MAX_SIZE
+         << " corners are not supported\n";
+    exit(1);
+  }
+
+  for ( int i = 0; i < MAX_SIZE; i++ )
+  {
+    key[i] = i < count ? face[i] : int( NONE );
+  }
+
+  sort ( key, key + count );
+}
+
+// ------------------------------------------------------------
+//    findSlot_
+// ------------------------------------------------------------
+
+// the slot holding key, or the empty slot where it would go
+// (linear probing)
+
+int FaceIndex::findSlot_ ( const int* key ) const
+{
+  const int mask = slots_.size () - 1;
+
+  int is = slot_ ( key );
+
+  while ( slots_[is] != NONE && !equal_ ( slots_[is], key ) )
+  {
+    is = ( is + 1 ) & mask;
+  }
+
+  return is;
+}
+
+// ------------------------------------------------------------
+//    rehash_
+// ------------------------------------------------------------
+
+// slotCount is a power of two
+
+void FaceIndex::rehash_ ( int slotCount )
+{
+  slots_.assign ( slotCount, int( NONE ) );
+
+  shift_ = 64;
+
+  for ( int count = slotCount; count > 1; count /= 2 ) shift_--;
+
+  const int mask      = slotCount - 1;
+  const int faceCount = size ();
+
+  for ( int face = 0; face < faceCount; face++ )
+  {
+    int is = slot_ ( keys_.data () + MAX_SIZE * face );
+
+    while ( slots_[is] != NONE ) is = ( is + 1 ) & mask;
+
+    slots_[is] = face;
+  }
+}
@@ -0,0 +1,164 @@
+#ifndef FACE_INDEX_H
+#define FACE_INDEX_H
+
+#include "typedefs.h"
+
+// =====================================================================
+//     class FaceIndex
+// =====================================================================
+
+/*
+ * A hash table of the faces of a 3D mesh, keyed by the corner nodes of
+ * the face (three or four) regardless of their order. Faces are
+ * numbered 0,...,size()-1 in the order they are inserted. For each face
+ * it records the elements sharing it, their position in elemSet and
+ * the local number of the face in them; an interior face has two, the
+ * first two are kept.
+ *
+ * Without owners it serves as a set of faces.
+ */
+
+class FaceIndex
+{
+  public:
+
+    static const int     NONE     = -1;
+    static const int     MAX_SIZE = 4;    // corners per face
+
+                         FaceIndex      ();
+
+    inline int           size           () const;
+
+    void                 reserve        ( int faceCount );
+    void                 clear          ();
+
+    // number of the face, NONE if there is no such face
+
+    int                  find
+
+      ( const IntVector&   face ) const;
+
+    inline bool          contains
+
+      ( const IntVector&   face ) const;
+
+    // number of the face, added if it is new
+
+    int                  insert
+
+      ( const IntVector&   face );
+
+    // element elem has the face as its local face localFace
+
+    void                 addOwner
+
+      ( int                face,
+        int                elem,
+        int                localFace );
+
+    // i = 0,1; NONE if the face has less owners
+
+    inline int           getOwner       ( int face, int i ) const;
+    inline int           getLocalFace   ( int face, int i ) const;
+
+    // the owner of the face that is not elem, NONE if none
+
+    inline int           getOtherOwner  ( int face, int elem ) const;
+
+    // local number of the face in owner elem (which must own it)
+
+    inline int           getLocalFaceOf ( int face, int elem ) const;
+
+  private:
+
+    // the corners of face sorted into key, unused entries NONE
+
+    static void          makeKey_
+
+      ( int*               key,
+        const IntVector&   face );
+
+    inline int           slot_
+
+      ( const int*         key ) const;
+
+    inline bool          equal_
+
+      ( int                face,
+        const int*         key ) const;
+
+    int                  findSlot_
+
+      ( const int*         key ) const;
+
+    void                 rehash_        ( int slotCount );
+
+  private:
+
+    IntVector               keys_;      // MAX_SIZE sorted corners per face
+    IntVector               owners_;    // two per face
+    vector<unsigned char>   locals_;    // two per face
+
+    IntVector               slots_;     // face number or NONE
+    int                     shift_;     // 64 - log2 ( slots_.size() )
+};
+
+// =====================================================================
+//   implementation of inline functions
+// =====================================================================
+
+inline int FaceIndex::size () const
+{
+  return keys_.size () / MAX_SIZE;
+}
+
+inline bool FaceIndex::contains ( const IntVector& face ) const
+{
+  return find ( face ) != NONE;
+}
+
+inline int FaceIndex::getOwner ( int face, int i ) const
+{
+  return owners_[2*face+i];
+}
+
+inline int FaceIndex::getLocalFace ( int face, int i ) const
+{
+  return locals_[2*face+i];
+}
+
+inline int FaceIndex::getOtherOwner ( int face, int elem ) const
+{
+  const int first = owners_[2*face];
+
+  return first != elem ? first : owners_[2*face+1];
+}
+
+inline int FaceIndex::getLocalFaceOf ( int face, int elem ) const
+{
+  return locals_[ owners_[2*face] == elem ? 2*face : 2*face+1 ];
+}
+
+// Fibonacci hashing of the sorted corners, the top bits select the slot
+
+inline int FaceIndex::slot_ ( const int* key ) const
+{
+  unsigned long long h = 0;
+
+  for ( int i = 0; i < MAX_SIZE; i++ )
+  {
+    h = ( h + (unsigned) key[i] ) * 0x9E3779B97F4A7C15ULL;
+  }
+
+  return int ( h >> shift_ );
+}
+
+inline bool FaceIndex::equal_ ( int face, const int* key ) const
+{
+  const int* k = keys_.data () + MAX_SIZE * face;
+
+  return k[0] == key[0] && k[1] == key[1] &&
+         k[2] == key[2] && k[3] == key[3];
+}
+
+#endif
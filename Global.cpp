@@ -14,6 +14,9 @@ Global::Global()
   isNURBS          = false;
   isConverter      = false;
   outAbaqus        = false;
+  isMappedRead     = false;
+  threadCount      = 1;
+  isCached         = false;
 }
 
 
@@ -3,6 +3,13 @@
 
 #include "typedefs.h"
 #include "utilities.h"
+#include "IdMap.h"
+#include "Arena.h"
+#include "NodeStore.h"
+#include "ElemStore.h"
+#include "Adjacency.h"
+#include "DualGraph.h"
+#include "Profile.h"
 
 class NodePair;
 
@@ -21,23 +28,27 @@ class NodePair;
 
 struct Global
 {
-   NodeSet                  nodeSet;         // set of original nodes
-   NodeSet                  newNodeSet;      // set of original nodes+new added nodes
+   NodeStore                nodeSet;         // set of original nodes
+   NodeStore                newNodeSet;      // set of original nodes+new added nodes
+   Arena                    elemArena;       // owns the elements of the sets below
    ElemSet                  elemSet;         // set of volumetric elements (modified)
    ElemSet                  interfaceSet;    // set of interface elements 
    ElemSet                  bndElementSet;   // set of boundary elements (for external force vector) 
 
-   Int2IntVectMap           nodeSupport;     // nodal support 
-   Int2IntVectMap           duplicatedNodes;
-   Int2IntVectMap           duplicatedNodes0; // back up for above
+   ElemStore                elemStore;       // connectivity of elemSet
+   ElemStore                interfaceStore;  // connectivity of interfaceSet
+   ElemStore                bndElemStore;    // connectivity of bndElementSet
+
+   Adjacency                nodeSupport;     // nodal support: node position => element ids
+   Adjacency                duplicatedNodes; // node position => the node, then its copies
    Int2IntVectMap           dom2Elems;
    Int2IntVectMap           dom2BndElems;
-   Int2IntMap               elem2Domain;
-   Int2IntMap               nodeId2Position; // given node's id => position in nodeSet
-   Int2IntMap               elemId2Position; // given elem's id => position in elemSet
+   IdMap                    elem2Domain;     // given elem's id => domain
+   IdMap                    nodeId2Position; // given node's id => position in nodeSet
+   IdMap                    elemId2Position; // given elem's id => position in elemSet
    IntSet                   boundaryNodes;   // id of nodes on the external boundary
    Int2IntSetMap            bndNodesMap;
-   vector<IntVector>        elemNeighbors;
+   DualGraph                elemNeighbors;   // element, edge/face => element across
    vector<NodePair>         nodePairs;     // 2D line elements on the boundary
    IntVector                bndElemsDomain; 
    IntVector                isolatedNodes; // store physical points from Gmsh
@@ -75,7 +86,38 @@ struct Global
 
    bool                     outAbaqus; // write to Abaqus input files
 
+   bool                     isMappedRead; // read Gmsh files through a memory map
+
+   int                      threadCount;  // number of threads (1 = serial)
+
+   string                   cacheFile;    // mesh cache file ("" = no cache)
+   string                   cacheKey;     // content hash of the mesh file
+   bool                     isCached;     // mesh and topology read from cache
+
+   string                   profileFile;  // timing report ("" = no report)
+   Profile                  profile;      // timing of the phases of the run
+
                             Global ();
+
+   // the rows of nodeSupport and duplicatedNodes of node id (empty
+   // if id is not an original node)
+
+   inline IntSpan           supportOf ( int id ) const;
+   inline IntSpan           copiesOf  ( int id ) const;
 };
 
+// ======================================================
+//  implementation of inline functions
+// ======================================================
+
+inline IntSpan Global::supportOf ( int id ) const
+{
+  return nodeSupport[nodeId2Position[id]];
+}
+
+inline IntSpan Global::copiesOf ( int id ) const
+{
+  return duplicatedNodes[nodeId2Position[id]];
+}
+
 #endif
@@ -0,0 +1,449 @@
+#include <cstring>
+#include <cstdlib>
+
+#include "Global.h"
+#include "NodeStore.h"
+#include "Element.h"
+#include "MeshReader.h"
+#include "MappedFile.h"
+
+/*
+ * Reader for the binary Gmsh format 4.1. The file is memory mapped and
+ * the entity blocks of the $Nodes and $Elements sections are copied
+ * directly into the node and element arrays. The physical tag of an
+ * element is the first physical tag of its entity ($Entities section),
+ * which is what the ASCII format 2 stores as first element tag; from
+ * there on the elements are handled exactly as in readGmshMesh.
+ */
+
+// ---------------------------------------------------------------------
+//     class BinaryCursor
+// ---------------------------------------------------------------------
+
+// reads native binary values and the text lines between them
+
+class BinaryCursor
+{
+  public:
+
+                   BinaryCursor
+
+      ( const char*  first,
+        const char*  last )
+
+      : pos_(first), end_(last) {}
+
+    bool           atEnd    () const { return pos_ >= end_; }
+
+    template <class T>
+    T              read     ()
+    {
+      T value;
+
+      if ( size_t( end_ - pos_ ) < sizeof(T) ) error_ ();
+
+      memcpy ( &value, pos_, sizeof(T) );
+      pos_ += sizeof(T);
+
+      return value;
+    }
+
+    void           skip     ( size_t bytes )
+    {
+      if ( size_t( end_ - pos_ ) < bytes ) error_ ();
+
+      pos_ += bytes;
+    }
+
+    // the rest of the current line, without line break
+
+    string         readLine ()
+    {
+      const char* first = pos_;
+
+      while ( pos_ < end_ && *pos_ != '\n' ) pos_++;
+
+      const char* last  = pos_;
+
+      if ( pos_ < end_ ) pos_++;
+
+      if ( last > first && last[-1] == '\r' ) last--;
+
+      return string ( first, last );
+    }
+
+    // move to the line following the line starting with tag
+
+    void           skipTo   ( const char* tag )
+    {
+      const size_t length = strlen ( tag );
+
+      while ( pos_ < end_ )
+      {
+        if ( size_t( end_ - pos_ ) >= length &&
+             strncmp ( pos_, tag, length ) == 0 )
+        {
+          readLine ();
+          return;
+        }
+
+        pos_++;
+      }
+
+      cerr << "no " << tag << " in the mesh file!!!\n";
+      exit(1);
+    }
+
+  private:
+
+    void           error_   () const
+    {
+      cerr << "unexpected end of the binary mesh file!!!\n";
+      exit(1);
+    }
+
+  private:
+
+    const char*    pos_;
+    const char*    end_;
+};
+
+// ---------------------------------------------------------------------
+//     gmshNodeCount
+// ---------------------------------------------------------------------
+
+// number of nodes of a Gmsh element type (not stored in binary files)
+
+static int               gmshNodeCount
+
+    ( int elemType )
+{
+  switch ( elemType )
+  {
+    case  1: return  2;   // 2-node line
+    case  2: return  3;   // 3-node triangle
+    case  3: return  4;   // 4-node quadrangle
+    case  4: return  4;   // 4-node tetrahedron
+    case  5: return  8;   // 8-node hexahedron
+    case  6: return  6;   // 6-node prism
+    case  7: return  5;   // 5-node pyramid
+    case  8: return  3;   // 3-node line
+    case  9: return  6;   // 6-node triangle
+    case 10: return  9;   // 9-node quadrangle
+    case 11: return 10;   // 10-node tetrahedron
+    case 12: return 27;   // 27-node hexahedron
+    case 15: return  1;   // 1-node point
+    case 16: return  8;   // 8-node quadrangle
+    case 17: return 20;   // 20-node hexahedron
+  }
+
+  cerr << "element type " << elemType << " not supported in binary Gmsh files!!!\n";
+  exit(1);
+
+  return 0;
+}
+
+// ---------------------------------------------------------------------
+//     readEntities
+// ---------------------------------------------------------------------
+
+// first physical tag (0 if none) of every entity, by dimension
+
+static void              readEntities
+
+    ( BinaryCursor&  cursor,
+      Int2IntMap     physTags[4] )
+{
+  size_t entityCount[4];
+
+  for ( int dim = 0; dim < 4; dim++ )
+  {
+    entityCount[dim] = cursor.read<size_t> ();
+  }
+
+  for ( int dim = 0; dim < 4; dim++ )
+  {
+    for ( size_t ie = 0; ie < entityCount[dim]; ie++ )
+    {
+      int tag = cursor.read<int> ();
+
+      // point coordinates or bounding box
+
+      cursor.skip ( ( dim == 0 ? 3 : 6 ) * sizeof(double) );
+
+      size_t physCount = cursor.read<size_t> ();
+
+      physTags[dim][tag] = 0;
+
+      for ( size_t ip = 0; ip < physCount; ip++ )
+      {
+        int phys = cursor.read<int> ();
+
+        if ( ip == 0 ) physTags[dim][tag] = phys;
+      }
+
+      // bounding entities
+
+      if ( dim > 0 )
+      {
+        size_t boundCount = cursor.read<size_t> ();
+
+        cursor.skip ( boundCount * sizeof(int) );
+      }
+    }
+  }
+}
+
+// ---------------------------------------------------------------------
+//     readNodes
+// ---------------------------------------------------------------------
+
+static void              readNodes
+
+    ( BinaryCursor&  cursor,
+      Global&        globdat )
+{
+  size_t blockCount = cursor.read<size_t> ();
+  size_t nodeCount  = cursor.read<size_t> ();
+
+  cursor.read<size_t> ();  // min node tag
+  cursor.read<size_t> ();  // max node tag
+
+  globdat.nodeSet.reserve ( nodeCount );
+
+  IntVector  ids;
+
+  for ( size_t ib = 0; ib < blockCount; ib++ )
+  {
+    int    entityDim  = cursor.read<int>    ();
+
+    cursor.read<int> ();   // entity tag
+
+    int    parametric = cursor.read<int>    ();
+    size_t count      = cursor.read<size_t> ();
+
+    // all node tags first, then all coordinates
+
+    ids.resize ( count );
+
+    for ( size_t in = 0; in < count; in++ )
+    {
+      ids[in] = int ( cursor.read<size_t> () );
+    }
+
+    for ( size_t in = 0; in < count; in++ )
+    {
+      double x = cursor.read<double> ();
+      double y = cursor.read<double> ();
+      double z = cursor.read<double> ();
+
+      if ( parametric ) cursor.skip ( entityDim * sizeof(double) );
+
+      globdat.nodeSet.add ( x, y, z, ids[in] );
+
+      globdat.nodeId2Position.set ( ids[in], globdat.nodeSet.size()-1 );
+    }
+  }
+
+  // checking two or three dimensional mesh
+
+  for ( int in = 0; in < globdat.nodeSet.size (); in++ )
+  {
+    if ( globdat.nodeSet.getZ ( in ) != 0. )
+    {
+      globdat.is3D = true;
+      break;
+    }
+  }
+}
+
+// ---------------------------------------------------------------------
+//     readElements
+// ---------------------------------------------------------------------
+
+static void              readElements
+
+    ( BinaryCursor&     cursor,
+      Global&           globdat,
+      const Int2IntMap  physTags[4],
+      int&              nodeElemCount )
+{
+  size_t blockCount = cursor.read<size_t> ();
+  size_t elemCount  = cursor.read<size_t> ();
+
+  cursor.read<size_t> ();  // min element tag
+  cursor.read<size_t> ();  // max element tag
+
+  globdat.elemSet.reserve ( elemCount );
+
+  IntVector  connectivity;
+
+  // as in the ASCII format, elements are numbered in file order
+
+  int        ie = 0;
+
+  for ( size_t ib = 0; ib < blockCount; ib++ )
+  {
+    int    entityDim = cursor.read<int>    ();
+    int    entityTag = cursor.read<int>    ();
+    int    elemType  = cursor.read<int>    ();
+    size_t count     = cursor.read<size_t> ();
+
+    int    matId     = 0;
+
+    if ( entityDim >= 0 && entityDim < 4 )
+    {
+      Int2IntMap::const_iterator it = physTags[entityDim].find ( entityTag );
+
+      if ( it != physTags[entityDim].end () ) matId = it->second;
+    }
+
+    const int nodeCount = gmshNodeCount ( elemType );
+
+    connectivity.resize ( nodeCount );
+
+    for ( size_t i = 0; i < count; i++, ie++ )
+    {
+      cursor.read<size_t> ();  // element tag
+
+      for ( int in = 0; in < nodeCount; in++ )
+      {
+        connectivity[in] = int ( cursor.read<size_t> () );
+      }
+
+      addGmshElement ( globdat, ie, elemType, matId, connectivity,
+                       nodeElemCount );
+    }
+  }
+}
+
+// =====================================================================
+//     isGmshBinaryMesh
+// =====================================================================
+
+bool                     isGmshBinaryMesh
+
+    ( const char* fileName )
+{
+  ifstream file ( fileName, std::ios::in );
+
+  string   line;
+  double   version;
+  int      fileType = 0;
+
+  getline ( file, line );
+
+  if ( line.compare ( 0, 11, "$MeshFormat" ) != 0 ) return false;
+
+  file >> version >> fileType;
+
+  return file && fileType == 1;
+}
+
+// =====================================================================
+//     readGmshMeshBinary
+// =====================================================================
+
+void                     readGmshMeshBinary
+
+    ( Global&     globdat,
+      const char* fileName )
+{
+  MappedFile file ( fileName );
+
+  if ( !file.isOpen () )
+  {
+    cout << "Unable to open mesh file!!!\n\n";
+    exit(1);
+  }
+
+  BinaryCursor    cursor ( file.begin(), file.end() );
+
+  Int2IntMap      physTags[4];
+
+  string          line;
+
+  int             nodeElemCount = 0;
+
+  cout << "Reading Gmsh mesh file ...\n";
+
+  cursor.skipTo ( "$MeshFormat" );
+
+  line = cursor.readLine ();
+
+  {
+    char*  rest;
+    double version  = strtod ( line.c_str(), &rest );
+    int    fileType = strtol ( rest, &rest, 10 );
+    int    dataSize = strtol ( rest, &rest, 10 );
+
+    if ( version != 4.1 || fileType != 1 || dataSize != sizeof(size_t) )
+    {
+      cerr << "only the binary format 4.1 of Gmsh with 8 byte sizes can be read!!!\n";
+      exit(1);
+    }
+  }
+
+  if ( cursor.read<int> () != 1 )
+  {
+    cerr << "the byte order of the binary mesh file is not supported!!!\n";
+    exit(1);
+  }
+
+  cursor.skipTo ( "$EndMeshFormat" );
+
+  bool gotEntities = false;
+  bool gotNodes    = false;
+
+  while ( !cursor.atEnd () )
+  {
+    line = cursor.readLine ();
+
+    if      ( line == "$Entities" )
+    {
+      readEntities ( cursor, physTags );
+
+      gotEntities = true;
+    }
+    else if ( line == "$Nodes" )
+    {
+      cout << "Reading nodes...\n";
+
+      readNodes    ( cursor, globdat );
+
+      cout << "Reading nodes...done!\n\n";
+
+      gotNodes = true;
+    }
+    else if ( line == "$Elements" )
+    {
+      if ( !gotEntities || !gotNodes )
+      {
+        cerr << "$Entities and $Nodes must come before $Elements!!!\n";
+        exit(1);
+      }
+
+      cout << "Reading elements...\n";
+
+      readElements ( cursor, globdat, physTags, nodeElemCount );
+
+      cout << "Reading elements...done!\n\n";
+    }
+    else if ( line.size () < 2 || line[0] != '$' )
+    {
+      continue;
+    }
+
+    // skip the rest of the section, also any section not used here
+
+    cursor.skipTo ( ( "$End" + line.substr ( 1 ) ).c_str () );
+  }
+
+  if ( globdat.elemSet.empty () )
+  {
+    cerr << "no elements in the mesh file!!!\n";
+    exit(1);
+  }
+
+  finishMesh ( globdat, nodeElemCount );
+}
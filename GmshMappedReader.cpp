@@ -0,0 +1,507 @@
+#include <cstring>
+
+#include "Global.h"
+#include "NodeStore.h"
+#include "Element.h"
+#include "MeshReader.h"
+#include "MappedFile.h"
+#include "TextScanner.h"
+#include "Parallel.h"
+
+/*
+ * Reader for the Gmsh ASCII format 2.x working on a memory mapped file.
+ * The $Nodes and $Elements sections are tokenized in place by a
+ * TextScanner, so apart from the nodes and elements themselves nothing
+ * is allocated per line. It fills exactly the same data as readGmshMesh.
+ *
+ * With globdat.threadCount > 1 both sections are cut into chunks at
+ * line breaks. Every chunk is parsed by one thread into its own buffer,
+ * then the buffers are merged into globdat in file order, so that the
+ * numbering (node positions, element ids = line index) does not depend
+ * on the number of threads.
+ */
+
+// ---------------------------------------------------------------------
+//     chunks parsed by the threads
+// ---------------------------------------------------------------------
+
+typedef vector<const char*>   CharPtrVector;
+
+// nodes of one chunk of the $Nodes section
+
+class ReadNodeChunk
+{
+  public:
+
+                   ReadNodeChunk
+
+      ( const CharPtrVector&  bounds,
+        vector<NodeStore>&    chunks )
+
+      : bounds_(bounds), chunks_(chunks) {}
+
+    void           operator () ( int ic )
+    {
+      TextScanner   scanner ( bounds_[ic], bounds_[ic+1] );
+      NodeStore&    nodes = chunks_[ic];
+
+      int           id;
+      double        x,y,z;
+
+      while ( !scanner.atEndOfData () )
+      {
+        id = scanner.readInt    ();
+        x  = scanner.readDouble ();
+        y  = scanner.readDouble ();
+        z  = scanner.readDouble ();
+
+        nodes.add ( x, y, z, id );
+      }
+    }
+
+  private:
+
+    const CharPtrVector&  bounds_;
+    vector<NodeStore>&    chunks_;
+};
+
+// elements of one chunk of the $Elements section, stored as
+// elem-type mat-id number-of-nodes node-list for each line
+
+class ReadElemChunk
+{
+  public:
+
+                   ReadElemChunk
+
+      ( const CharPtrVector&  bounds,
+        vector<IntVector>&    chunks )
+
+      : bounds_(bounds), chunks_(chunks) {}
+
+    void           operator () ( int ic )
+    {
+      TextScanner   scanner ( bounds_[ic], bounds_[ic+1] );
+      IntVector&    data = chunks_[ic];
+
+      int           elemType;
+      int           tagCount;
+      int           matId;
+      size_t        countPos;
+
+      data.reserve ( ( bounds_[ic+1] - bounds_[ic] ) / 4 );
+
+      while ( !scanner.atEndOfData () )
+      {
+        scanner.readInt ();
+
+        elemType = scanner.readInt ();
+        tagCount = scanner.readInt ();
+        matId    = 0;
+
+        for ( int it = 0; it < tagCount; it++ )
+        {
+          int tag = scanner.readInt ();
+
+          if ( it == 0 ) matId = tag;   // physical entity
+        }
+
+        data.push_back ( elemType );
+        data.push_back ( matId    );
+        data.push_back ( 0        );
+
+        countPos = data.size () - 1;
+
+        while ( !scanner.atEndOfLine () )
+        {
+          data.push_back ( scanner.readInt () );
+        }
+
+        data[countPos] = data.size () - countPos - 1;
+
+        scanner.skipLine ();
+      }
+    }
+
+  private:
+
+    const CharPtrVector&  bounds_;
+    vector<IntVector>&    chunks_;
+};
+
+// ---------------------------------------------------------------------
+//     findSectionEnd
+// ---------------------------------------------------------------------
+
+// start of the line beginning with tag, searched from first on
+
+static const char*       findSectionEnd
+
+    ( const char*  first,
+      const char*  last,
+      const char*  tag )
+{
+  const size_t length = strlen ( tag );
+
+  const char*  line   = first;
+
+  while ( line < last )
+  {
+    if ( size_t( last - line ) >= length &&
+         strncmp ( line, tag, length ) == 0 )
+    {
+      return line;
+    }
+
+    line = (const char*) memchr ( line, '\n', last - line );
+
+    if ( line == 0 ) break;
+
+    line++;
+  }
+
+  cerr << "no " << tag << " in the mesh file!!!\n";
+  exit(1);
+
+  return last;
+}
+
+// ---------------------------------------------------------------------
+//     splitLines
+// ---------------------------------------------------------------------
+
+// cut [first,last) into chunkCount pieces of about the same size,
+// every piece starts at the beginning of a line
+
+static void              splitLines
+
+    ( CharPtrVector&  bounds,
+      const char*     first,
+      const char*     last,
+      int             chunkCount )
+{
+  bounds.resize ( chunkCount + 1 );
+
+  bounds[0]          = first;
+  bounds[chunkCount] = last;
+
+  for ( int ic = 1; ic < chunkCount; ic++ )
+  {
+    const char* pos = first + ( last - first ) / chunkCount * ic;
+
+    pos = max ( pos, bounds[ic-1] );
+    pos = (const char*) memchr ( pos, '\n', last - pos );
+
+    bounds[ic] = pos ? pos + 1 : last;
+  }
+}
+
+// =====================================================================
+//     addGmshElement
+// =====================================================================
+
+void                     addGmshElement
+
+    ( Global&           globdat,
+      int               ie,
+      int               elemType,
+      int               matId,
+      const IntVector&  connectivity,
+      int&              nodeElemCount )
+{
+  // line elements => boundary nodes
+  // elemType == 1: two-node   line element
+  // elemType == 8: three-node line element
+
+  if ( elemType == 1 )
+  {
+    int no1 = connectivity[0];
+    int no2 = connectivity[1];
+
+    globdat.boundaryNodes.insert ( no1 );
+    globdat.boundaryNodes.insert ( no2 );
+
+    globdat.bndNodesMap[matId].insert ( no1 );
+    globdat.bndNodesMap[matId].insert ( no2 );
+
+    globdat.nodePairs     .push_back ( NodePair (no1, no2) );
+    globdat.bndElemsDomain.push_back ( matId );
+
+    return;
+  }
+
+  if ( elemType == 8 )
+  {
+    int no1 = connectivity[0];
+    int no2 = connectivity[1];
+    int no3 = connectivity[2]; //midside node
+
+    globdat.boundaryNodes.insert ( no1 );
+    globdat.boundaryNodes.insert ( no2 );
+    globdat.boundaryNodes.insert ( no3 );
+
+    globdat.bndNodesMap[matId].insert ( no1 );
+    globdat.bndNodesMap[matId].insert ( no2 );
+    globdat.bndNodesMap[matId].insert ( no3 );
+
+    globdat.nodePairs.push_back ( NodePair (no1, no2) );
+    globdat.bndElemsDomain.push_back ( matId );
+
+    return;
+  }
+
+  // node element
+
+  if ( elemType == 15 )
+  {
+    globdat.isolatedNodes.push_back ( connectivity[0] );
+    return;
+  }
+
+  nodeElemCount = connectivity.size ();
+
+  // for a 3D mesh, triangles or quadrangles are surface elements
+  // ie. they are boundary elements not bulk elements.
+
+  if ( globdat.is3D )
+  {
+    if ( elemType == 2 || elemType == 9 || // linear or quadratic triangle
+	 elemType == 3 || elemType == 16 ) // linear or quadratic quadrangle
+    {
+      globdat.bndNodesMap[matId].insert ( connectivity.begin(),
+	                                  connectivity.end() );
+      return;
+    }
+  }
+
+  // material => elements
+  // element  => material (domain)
+
+  globdat.dom2Elems[matId].push_back ( ie );
+  globdat.elem2Domain.set ( ie, matId );
+
+  // the rest are solid elements
+  // either 2D solid elements or 3D solid elements
+
+  globdat.elemSet.push_back ( globdat.elemArena.create<Element> ( globdat.elemStore, ie, elemType, connectivity )  );
+
+  globdat.elemId2Position.set ( ie, globdat.elemSet.size() - 1 );
+}
+
+// =====================================================================
+//     readGmshMeshMapped
+// =====================================================================
+
+void                     readGmshMeshMapped
+
+    ( Global&     globdat,
+      const char* fileName )
+{
+  MappedFile file ( fileName );
+
+  if ( !file.isOpen () )
+  {
+    cout << "Unable to open mesh file!!!\n\n";
+    exit(1);
+  }
+
+  int             id;
+  int             matId;
+  int             elemType;
+  int             tagCount;
+  int             nodeElemCount = 0;
+
+  double          x,y,z;
+
+  IntVector       connectivity;
+  CharPtrVector   bounds;
+
+  TextScanner     scanner ( file.begin(), file.end() );
+
+  const int       threadCount = globdat.threadCount;
+  const int       chunkCount  = 4 * threadCount;
+
+  cout << "Reading Gmsh mesh file ...\n";
+
+  if ( scanner.findLine ( "$MeshFormat" ) )
+  {
+    double version  = scanner.readDouble ();
+    int    fileType = scanner.readInt    ();
+
+    if ( version >= 3. || fileType != 0 )
+    {
+      cerr << "only the ASCII format 2 of Gmsh can be read with --mapped-read!!!\n";
+      exit(1);
+    }
+  }
+
+  cout << "Reading nodes...\n";
+
+  if ( !scanner.findLine ( "$Nodes" ) )
+  {
+    cerr << "no $Nodes section in the mesh file!!!\n";
+    exit(1);
+  }
+
+  const int nodeCount = scanner.readInt ();
+
+  globdat.nodeSet.reserve ( nodeCount );
+
+  if ( threadCount > 1 )
+  {
+    scanner.skipLine ();
+
+    const char* last = findSectionEnd ( scanner.position (), file.end (),
+                                        "$EndNodes" );
+
+    vector<NodeStore> chunks ( chunkCount );
+    ReadNodeChunk     readChunk ( bounds, chunks );
+
+    splitLines  ( bounds, scanner.position (), last, chunkCount );
+    parallelFor ( chunkCount, threadCount, readChunk );
+
+    for ( int ic = 0; ic < chunkCount; ic++ )
+    {
+      const int first = globdat.nodeSet.size ();
+
+      globdat.nodeSet.append ( chunks[ic] );
+
+      for ( int in = first; in < globdat.nodeSet.size (); in++ )
+      {
+        globdat.nodeId2Position.set ( globdat.nodeSet.getIndex ( in ), in );
+      }
+
+      NodeStore().swap ( chunks[ic] );
+    }
+
+    if ( globdat.nodeSet.size () != nodeCount )
+    {
+      cerr << "wrong number of nodes in the mesh file!!!\n";
+      exit(1);
+    }
+
+    scanner = TextScanner ( last, file.end () );
+  }
+  else
+  {
+    for ( int in = 0; in < nodeCount; in++ )
+    {
+      id = scanner.readInt    ();
+      x  = scanner.readDouble ();
+      y  = scanner.readDouble ();
+      z  = scanner.readDouble ();
+
+      globdat.nodeSet.add ( x, y, z, id );
+
+      globdat.nodeId2Position.set ( id, globdat.nodeSet.size()-1 );
+    }
+  }
+
+  // checking two or three dimensional mesh
+
+  for ( int in = 0; in < nodeCount; in++ )
+  {
+    if ( globdat.nodeSet.getZ ( in ) != 0. )
+    {
+      globdat.is3D = true;
+      break;
+    }
+  }
+
+  cout << "Reading nodes...done!\n\n";
+
+  cout << "Reading elements...\n";
+
+  if ( !scanner.findLine ( "$Elements" ) )
+  {
+    cerr << "no $Elements section in the mesh file!!!\n";
+    exit(1);
+  }
+
+  const int elemCount = scanner.readInt ();
+
+  scanner.skipLine ();
+
+  globdat.elemSet.reserve ( elemCount );
+  connectivity.reserve    ( 27 );
+
+  if ( threadCount > 1 )
+  {
+    const char* last = findSectionEnd ( scanner.position (), file.end (),
+                                        "$EndElements" );
+
+    vector<IntVector> chunks ( chunkCount );
+    ReadElemChunk     readChunk ( bounds, chunks );
+
+    splitLines  ( bounds, scanner.position (), last, chunkCount );
+    parallelFor ( chunkCount, threadCount, readChunk );
+
+    // merge in file order: the element id is the line index
+
+    int ie = 0;
+
+    for ( int ic = 0; ic < chunkCount; ic++ )
+    {
+      const IntVector& data = chunks[ic];
+
+      for ( size_t i = 0; i < data.size (); ie++ )
+      {
+        elemType = data[i];
+        matId    = data[i+1];
+
+        connectivity.assign ( data.begin() + i + 3,
+                              data.begin() + i + 3 + data[i+2] );
+
+        i += 3 + data[i+2];
+
+        addGmshElement ( globdat, ie, elemType, matId, connectivity,
+                         nodeElemCount );
+      }
+
+      IntVector().swap ( chunks[ic] );
+    }
+
+    if ( ie != elemCount )
+    {
+      cerr << "wrong number of elements in the mesh file!!!\n";
+      exit(1);
+    }
+  }
+  else
+  {
+    for ( int ie = 0; ie < elemCount; ie++ )
+    {
+      // elem-number elem-type number-of-tags tags... node-list
+      // the element number is not used: elements are numbered by line
+
+      scanner.readInt ();
+
+      elemType = scanner.readInt ();
+      tagCount = scanner.readInt ();
+      matId    = 0;
+
+      for ( int it = 0; it < tagCount; it++ )
+      {
+        int tag = scanner.readInt ();
+
+        if ( it == 0 ) matId = tag;   // physical entity
+      }
+
+      connectivity.clear ();
+
+      while ( !scanner.atEndOfLine () )
+      {
+        connectivity.push_back ( scanner.readInt () );
+      }
+
+      scanner.skipLine ();
+
+      addGmshElement ( globdat, ie, elemType, matId, connectivity,
+                       nodeElemCount );
+    }
+  }
+
+  cout << "Reading elements...done!\n\n";
+
+  finishMesh ( globdat, nodeElemCount );
+}
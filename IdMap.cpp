@@ -0,0 +1,166 @@
+#include <climits>
+
+#include "IdMap.h"
+
+
+// ------------------------------------------------------------
+//    constructor
+// ------------------------------------------------------------
+
+IdMap::IdMap ()
+
+  : base_(0), isHashed_(false), count_(0), minId_(0), maxId_(0)
+
+{}
+
+// ------------------------------------------------------------
+//    getHashed
+// ------------------------------------------------------------
+
+void IdMap::getHashed
+
+  ( IntVector&  ids,
+    IntVector&  values ) const
+
+{
+  ids   .clear ();
+  values.clear ();
+
+  for ( Hash_::const_iterator it = hash_.begin (); it != hash_.end (); ++it )
+  {
+    ids   .push_back ( it->first  );
+    values.push_back ( it->second );
+  }
+}
+
+// ------------------------------------------------------------
+//    assign
+// ------------------------------------------------------------
+
+void IdMap::assign
+
+  ( int         base,
+    const int*  first,
+    const int*  last )
+
+{
+  clear ();
+
+  base_ = base;
+
+  values_.assign ( first, last );
+
+  for ( size_t k = 0; k < values_.size (); k++ )
+  {
+    if ( values_[k] == NONE ) continue;
+
+    const int id = base_ + int( k );
+
+    if ( count_ == 0 ) minId_ = id;
+
+    maxId_ = id;
+    count_++;
+  }
+}
+
+void IdMap::assign
+
+  ( const int*  ids,
+    const int*  values,
+    int         count )
+
+{
+  clear ();
+
+  for ( int i = 0; i < count; i++ )
+  {
+    set ( ids[i], values[i] );
+  }
+}
+
+// ------------------------------------------------------------
+//    grow_
+// ------------------------------------------------------------
+
+// makes room in the flat table for the new id (minId_, maxId_ and
+// count_ include it already), or moves to the hash table if the
+// ids became too sparse
+
+void IdMap::grow_ ( int id )
+{
+  const long size = values_.size ();
+
+  if ( size == 0 )
+  {
+    base_ = id;
+    values_.assign ( 1, int( NONE ) );
+    return;
+  }
+
+  const long k = long( id ) - base_;
+
+  if ( k >= 0 && k < size ) return;
+
+  if ( long( maxId_ ) - minId_ + 1 > SPARSE * count_ + SLACK )
+  {
+    toHash_ ();
+    return;
+  }
+
+  // grow geometrically, at the end for increasing ids and at the
+  // front for decreasing ones
+
+  if ( k >= size )
+  {
+    const long n = min ( max ( k + 1, 2 * size ), long( INT_MAX ) - base_ + 1 );
+
+    values_.resize ( n, int( NONE ) );
+  }
+  else
+  {
+    const long extra = min ( max ( -k, size ), long( base_ ) - INT_MIN );
+
+    values_.insert ( values_.begin (), extra, int( NONE ) );
+
+    base_ -= int( extra );
+  }
+}
+
+// ------------------------------------------------------------
+//    toHash_
+// ------------------------------------------------------------
+
+void IdMap::toHash_ ()
+{
+  hash_.reserve ( count_ );
+
+  for ( size_t k = 0; k < values_.size (); k++ )
+  {
+    if ( values_[k] != NONE ) hash_[base_ + int( k )] = values_[k];
+  }
+
+  IntVector ().swap ( values_ );
+
+  base_     = 0;
+  isHashed_ = true;
+}
+
+// ------------------------------------------------------------
+//    toFlat_
+// ------------------------------------------------------------
+
+void IdMap::toFlat_ ()
+{
+  base_ = minId_;
+
+  values_.assign ( long( maxId_ ) - minId_ + 1, int( NONE ) );
+
+  for ( Hash_::const_iterator it = hash_.begin (); it != hash_.end (); ++it )
+  {
+    values_[long( it->first ) - base_] = it->second;
+  }
+
+  Hash_ ().swap ( hash_ );
+
+  isHashed_ = false;
+}
@@ -0,0 +1,227 @@
+#ifndef ID_MAP_H
+#define ID_MAP_H
+
+#include <unordered_map>
+
+#include "typedefs.h"
+
+// =====================================================================
+//     class IdMap
+// =====================================================================
+
+/*
+ * Maps the ids of a mesh file (node ids, element ids) to an int (a
+ * position in nodeSet or elemSet, a domain). Mesh files mostly number
+ * their nodes and elements contiguously, though not necessarily from 0
+ * or 1 nor in increasing order, so the map is a flat table of the ids
+ * base(),...,base()+table().size()-1: a lookup is one array access.
+ * When the ids are spread over a range much larger than their number
+ * the map keeps them in a hash table instead, and goes back to a flat
+ * table once they fill their range. Ids that were never set map to
+ * NONE. Unlike std::map::operator[] a lookup never inserts.
+ */
+
+class IdMap
+{
+  public:
+
+    static const int     NONE = -1;
+
+                         IdMap   ();
+
+    // value of id, NONE if not set
+
+    inline int           operator []
+
+      ( int                id ) const;
+
+    inline bool          contains
+
+      ( int                id ) const;
+
+    inline void          set
+
+      ( int                id,
+        int                value );
+
+    // number of ids set and the largest of them (-1 if none)
+
+    inline int           count   () const;
+    inline int           maxId   () const;
+
+    inline void          clear   ();
+    inline void          swap    ( IdMap& rhs );
+
+    // the flat table, one value per id from base() on (empty while
+    // the ids are kept in the hash table)
+
+    inline int           base    () const;
+    inline const IntVector&
+                         table   () const;
+
+    // the ids and values of the hash table
+
+    void                 getHashed
+
+      ( IntVector&         ids,
+        IntVector&         values ) const;
+
+    // replaces the map by a flat table (ids base,... ) or by the
+    // pairs ids[i] => values[i]
+
+    void                 assign
+
+      ( int                base,
+        const int*         first,
+        const int*         last );
+
+    void                 assign
+
+      ( const int*         ids,
+        const int*         values,
+        int                count );
+
+  private:
+
+    void                 grow_   ( int id );
+    void                 toHash_ ();
+    void                 toFlat_ ();
+
+  private:
+
+    typedef unordered_map<int,int> Hash_;
+
+    // a table over more than SPARSE times the ids set (plus a bit)
+    // is too sparse
+
+    static const long    SPARSE = 4;
+    static const long    SLACK  = 1024;
+
+    int                  base_;
+    IntVector            values_;
+    Hash_                hash_;
+    bool                 isHashed_;
+    int                  count_;
+    int                  minId_;
+    int                  maxId_;
+};
+
+// =====================================================================
+//   implementation of inline functions
+// =====================================================================
+
+inline int IdMap::operator [] ( int id ) const
+{
+  if ( !isHashed_ )
+  {
+    const size_t k = size_t( long( id ) - base_ );
+
+    return k < values_.size () ? values_[k] : NONE;
+  }
+
+  Hash_::const_iterator it = hash_.find ( id );
+
+  return it == hash_.end () ? NONE : it->second;
+}
+
+inline bool IdMap::contains ( int id ) const
+{
+  return (*this)[id] != NONE;
+}
+
+inline void IdMap::set ( int id, int value )
+{
+  if ( !isHashed_ )
+  {
+    const size_t k = size_t( long( id ) - base_ );
+
+    if ( k < values_.size () && values_[k] != NONE )
+    {
+      values_[k] = value;
+      return;
+    }
+  }
+  else
+  {
+    Hash_::iterator it = hash_.find ( id );
+
+    if ( it != hash_.end () )
+    {
+      it->second = value;
+      return;
+    }
+  }
+
+  // a new id
+
+  if ( count_ == 0 )
+  {
+    minId_ = maxId_ = id;
+  }
+  else
+  {
+    minId_ = min ( minId_, id );
+    maxId_ = max ( maxId_, id );
+  }
+
+  count_++;
+
+  if ( isHashed_ )
+  {
+    hash_[id] = value;
+
+    if ( long( maxId_ ) - minId_ < 2L * count_ ) toFlat_ ();
+
+    return;
+  }
+
+  grow_ ( id );
+
+  if ( isHashed_ )
+  {
+    hash_[id] = value;
+  }
+  else
+  {
+    values_[long( id ) - base_] = value;
+  }
+}
+
+inline int IdMap::count () const
+{
+  return count_;
+}
+
+inline int IdMap::maxId () const
+{
+  return count_ ? maxId_ : -1;
+}
+
+inline void IdMap::clear ()
+{
+  IdMap ().swap ( *this );
+}
+
+inline void IdMap::swap ( IdMap& rhs )
+{
+  std::swap ( base_,     rhs.base_     );
+  std::swap ( isHashed_, rhs.isHashed_ );
+  std::swap ( count_,    rhs.count_    );
+  std::swap ( minId_,    rhs.minId_    );
+  std::swap ( maxId_,    rhs.maxId_    );
+
+  values_.swap ( rhs.values_ );
+  hash_  .swap ( rhs.hash_   );
+}
+
+inline int IdMap::base () const
+{
+  return base_;
+}
+
+inline const IntVector& IdMap::table () const
+{
+  return values_;
+}
+
+#endif
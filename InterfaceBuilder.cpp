@@ -5,7 +5,10 @@
 #include "InterfaceBuilder.h"
 #include "Global.h"
 #include "Element.h"
-#include "Node.h"
+#include "NodeStore.h"
+#include "EdgeIndex.h"
+#include "FaceIndex.h"
+#include "Parallel.h"
 #include "utilities.h"
 
 /*
@@ -144,52 +147,48 @@ void   InterfaceBuilder::doFor2DMatInterface ( Global& globdat )
   int              m1,m2;
   int              o1,o2;
   int              ielem,  ieCount = 0;
-  int              nnode;
+  int              ncorner;
   int              bulk1, bulk2;
 
   ElemPointer      ep;
   
-  IntVector        inodes0, inodesF;
+  IntSpan          inodes0, inodesF;
   IntVector        interConnec(globdat.nodeICount);
   IntVector        interConnec1, interConnec2;
 
-  vector<NodePair> doneEdges;   // list of edges already done
+  EdgeIndex        bndEdges;    // edges on the external boundary
+  EdgeIndex        doneEdges;   // list of edges already done
   set<int>         doneNodes;   // list of edges already done
   doneNodes.insert(-1);
 
   const  int       elemCount = globdat.elemSet.size ();
 
+  buildEdgeIndex ( bndEdges, globdat );
+
   // loop over all bulk elements
 
   for ( int ie = 0; ie < elemCount; ie++ )
   {
-     ep    = globdat.elemSet[ie];
+     ep      = globdat.elemSet[ie];
 
-     ep->getCornerConnectivity0 ( inodes0 );
-
-     if ( globdat.isQuadratic ) 
-     {
-       ep->getConnectivity0 ( inodesF ); 
-     }
-
-     inodes0.push_back ( inodes0[0] );  
-
-     nnode = inodes0.size(); 
+     inodes0 = ep->getCornerNodes0 ();
+     inodesF = ep->getNodes0       ();
+     ncorner = inodes0.size ();
 
      // loop over edges, add interface along common edge
 
-     for ( int in = 0; in < nnode-1; in++ )
+     for ( int in = 0; in < ncorner; in++ )
      {
        n1 = inodes0[in];
-       n2 = inodes0[in+1];
+       n2 = inodes0[(in+1) % ncorner];
 
-       if ( globdat.isQuadratic ) p1 = inodesF[nnode - 1 + in]; // index of midside node
+       if ( globdat.isQuadratic ) p1 = inodesF[ncorner + in]; // index of midside node
 
        o1 = globdat.nodeId2Position[n1];
        o2 = globdat.nodeId2Position[n2];
 
-       m1 = globdat.nodeSet[o1]->getDuplicity ();
-       m2 = globdat.nodeSet[o2]->getDuplicity ();
+       m1 = globdat.nodeSet.getDuplicity ( o1 );
+       m2 = globdat.nodeSet.getDuplicity ( o2 );
 
        // not a common edge, omits
 
@@ -198,18 +197,14 @@ void   InterfaceBuilder::doFor2DMatInterface ( Global& globdat )
 
        // edge on external boundary, also omitted
 
-       if ( find ( globdat.nodePairs.begin(), 
-       	           globdat.nodePairs.end  (), 
-       	           NodePair(n1,n2) ) != globdat.nodePairs.end() )
+       if ( bndEdges.contains ( n1, n2 ) )
        {
          continue;
        }
 
        // ignore edge already added
 
-       if ( find ( doneEdges.begin(), 
-       	           doneEdges.end  (), 
-       	           NodePair(n1,n2) ) != doneEdges.end() )
+       if ( doneEdges.contains ( n1, n2 ) )
        {
          break;
        }
@@ -220,11 +215,11 @@ void   InterfaceBuilder::doFor2DMatInterface ( Global& globdat )
        {
          bool val1, val2;
 
-         double x1 = globdat.nodeSet[o1]->getX ();
-         double y1 = globdat.nodeSet[o1]->getY ();
+         double x1 = globdat.nodeSet.getX ( o1 );
+         double y1 = globdat.nodeSet.getY ( o1 );
 
-         double x2 = globdat.nodeSet[o2]->getX ();
-         double y2 = globdat.nodeSet[o2]->getY ();
+         double x2 = globdat.nodeSet.getX ( o2 );
+         double y2 = globdat.nodeSet.getY ( o2 );
 
          for ( int is = 0; is < globdat.segment.size(); is++ )
          {
@@ -237,23 +232,31 @@ void   InterfaceBuilder::doFor2DMatInterface ( Global& globdat )
          if ( val1 && val2 ) break; // do not add interface on existing notch
        }
 
-       addInterface ( interConnec, n1, n2, p1, ep->getChanged(), globdat );
+       // the element across the edge; without one, or with one of the
+       // same material (an edge between two interfacial nodes that
+       // cuts through a material), the edge is not on an interface
+
+       bulk2 = globdat.elemNeighbors.getNeighbor ( ie, in );
 
-       bulk1 = ep->getIndex();
-       bulk2 = ep->getIndexElementContainsEdge ( globdat, 
-                   globdat.duplicatedNodes0[n1][1], globdat.duplicatedNodes0[n2][1] );
+       if ( bulk2 == DualGraph::NONE ) continue;
+
+       if ( globdat.elem2Domain[ep->getIndex ()] ==
+            globdat.elem2Domain[globdat.elemSet[bulk2]->getIndex ()] )
+       {
+         continue;
+       }
+
+       addInterface ( interConnec, n1, n2, p1, ep->getChanged(), globdat );
 
-       //cout<< "bulk1 and bulk2: " <<  bulk1 << " " << bulk2 << endl;
-       bulk1 = globdat.elemId2Position[bulk1];
-       bulk2 = globdat.elemId2Position[bulk2];
+       bulk1 = ie;
 
-       globdat.interfaceSet.push_back ( ElemPointer ( new Element ( ieCount, 0,
-                   interConnec, bulk1, bulk2 ) ) );
+       globdat.interfaceSet.push_back ( globdat.elemArena.create<Element> ( globdat.interfaceStore, ieCount, 0,
+                   interConnec, bulk1, bulk2 ) );
        
        globdat.interfaceMats.push_back (0);
        ieCount++;
 
-       doneEdges.push_back ( NodePair(n1,n2) );
+       doneEdges.insert ( n1, n2 );
     }
   }
 }
@@ -265,16 +268,15 @@ void   InterfaceBuilder::doFor2DMatInterface ( Global& globdat )
 void   InterfaceBuilder::doFor3DMatInterface ( Global& globdat )
 {
 
-  ElemPointer        ip, jp;
+  ElemPointer        ip;
 
-  IntVector          face, sface, fface;
+  IntVector          face;
   IntVector          interConnec(globdat.nodeICount);
-  IntVector          neighbors;
-  vector<IntVector>  doneFaces;
+  FaceIndex          doneFaces;
 
-  int                nodeCount, neiCount;
+  int                nodeCount;
   int                ieCount = 0;
-  int                ielem, jelem, n, m;
+  int                n, m;
   int                oppVertex, fIndex;
 
   const  int         elemCount = globdat.elemSet.size ();
@@ -282,7 +284,6 @@ void   InterfaceBuilder::doFor3DMatInterface ( Global& globdat )
   for ( int ie = 0; ie < elemCount; ie++ )
   {
     ip    = globdat.elemSet[ie];
-    ielem = ip->getIndex ();
 
     if ( ip->isOnInterface ( face, oppVertex, fIndex,
 	                     globdat.nodeSet, globdat.nodeId2Position ) )
@@ -324,13 +325,7 @@ void   InterfaceBuilder::doFor3DMatInterface ( Global& globdat )
         if (ignored) continue;
       }
 
-      sface = face;
-
-      sort ( sface.begin(), sface.end() );
-
-      if ( find ( doneFaces.begin(),
-	          doneFaces.end  (), 
-		  sface ) != doneFaces.end() )
+      if ( doneFaces.contains ( face ) )
       {
 	continue;
       }
@@ -339,10 +334,26 @@ void   InterfaceBuilder::doFor3DMatInterface ( Global& globdat )
 
       if ( globdat.isQuadratic ) 
       {
-	ip->getFullFace ( fface, fIndex );
+	const FaceView fface = ip->getFullFace0 ( fIndex );
 
 	nodeCount  = fface.size ();
 
+	// a face inside one material may have all its corners on the
+	// interface; its midside nodes then have no copy: skip it
+
+	bool inside = false;
+
+	for ( int in = nodeCount/2; in < nodeCount; in++ )
+	{
+	  if ( globdat.copiesOf ( fface[in] ).size () < 2 )
+	  {
+	    inside = true;
+	    break;
+	  }
+	}
+
+	if ( inside ) continue;
+
 	for ( int in = 0; in < nodeCount/2; in++ )
 	{
 	  n                           = fface[in];
@@ -351,8 +362,8 @@ void   InterfaceBuilder::doFor3DMatInterface ( Global& globdat )
 	  interConnec[2*in]             = n;
 	  interConnec[2*in+1]           = m;
 
-	  interConnec[2*in+nodeCount]   = globdat.duplicatedNodes0[n][1] ;
-	  interConnec[2*in+1+nodeCount] = globdat.duplicatedNodes0[m][1] ;
+	  interConnec[2*in+nodeCount]   = copyOfNode ( n, globdat );
+	  interConnec[2*in+1+nodeCount] = copyOfNode ( m, globdat );
 	}
       }
       else
@@ -363,19 +374,19 @@ void   InterfaceBuilder::doFor3DMatInterface ( Global& globdat )
 	{
 	  n                          = face[in];
 	  interConnec[in]            = n;
-	  interConnec[in+nodeCount]  = globdat.duplicatedNodes0[n][1] ;
+	  interConnec[in+nodeCount]  = copyOfNode ( n, globdat );
 	}
       }
 
       // insert this interface 
 
-      globdat.interfaceSet.push_back ( ElemPointer ( new Element ( ieCount, interConnec ) ) );
+      globdat.interfaceSet.push_back ( globdat.elemArena.create<Element> ( globdat.interfaceStore, ieCount, interConnec ) );
 
       globdat.interfaceMats.push_back (0);
       globdat.oppositeVertices.push_back ( oppVertex );
       ieCount++;
 
-      doneFaces.push_back ( sface );
+      doneFaces.insert ( face );
     }
   }
 }
@@ -386,73 +397,45 @@ void   InterfaceBuilder::doFor3DMatInterface ( Global& globdat )
 
 void   InterfaceBuilder::doForDomain ( Global& globdat )
 {
-  int              neiCount;
-  int              nnode;
-  int              n1,n2,n12;
+  int              ncorner, next;
+  int              n1,n2;
   int              m1,m2;
   int              o1,o2;
   int              p1,p2,p12;
   int              ielem, jelem, ieCount(0), bieCount(0);
   int              bulk1, bulk2;
-  int              npId;
+  int              npId, edge;
 
-  ElemPointer      ep,jp;
+  ElemPointer      ep;
   
-  IntVector        inodes, inodes0, inodes00, inodesF, inodesC;
-  IntVector        jnodes, jnodes0;
+  IntSpan          inodes, inodes0;
   IntVector        interConnec(globdat.nodeICount);
   IntVector        bndElemConn(globdat.nodeICount/2);
-  IntVector        neighbors;
-  vector<NodePair> doneEdges;   // list of edges already done
-
-
-  IntVector::const_iterator         it1, it2, it12;
-  vector<NodePair>::const_iterator  npIt;
+  EdgeIndex        bndEdges;    // edges on the external boundary
+  EdgeIndex        doneEdges;   // list of edges already done
 
   const  int        elemCount = globdat.elemSet.size ();
 
+  buildEdgeIndex ( bndEdges, globdat );
+
   for ( int ie = 0; ie < elemCount; ie++ )
   {
     ep    = globdat.elemSet[ie];
     ielem = ep->getIndex();
 
-    ep->getConnectivity        ( inodes  );      // full, updated connectivity 
-    ep->getCornerConnectivity0 ( inodes0 );      // for edge, only corner nodes suffice 
-    //inodes00 = inodes0;
-
-    // for quadratic elements, need a full connectivity
-
-    if ( globdat.isQuadratic ) 
-    {
-       ep->getConnectivity0      ( inodesF ); 
-       ep->getCornerConnectivity ( inodesC );   
-       inodesC.push_back ( inodesC[0] );  
-    }
-
-    //print ( inodes0.begin(), inodes0.end() );
-    //print ( inodesF.begin(), inodesF.end() );
-    
-    inodes0.push_back ( inodes0[0] );  
-    inodes .push_back ( inodes [0] );  
-
-    nnode = inodes0.size();
-
-    neighbors = globdat.elemNeighbors[ie]; 
-    neiCount  = neighbors.size ();
-    
-    //cout << "doing element " << ie+1 << ":\n ";
-   // print ( neighbors.begin(), neighbors.end() );
+    inodes  = ep->getNodes        ();      // full, updated connectivity 
+    inodes0 = ep->getCornerNodes0 ();      // for edge, only corner nodes suffice 
+    ncorner = inodes0.size ();
 
     // loop over edges, add interface along common edge
 
-    for ( int in = 0; in < nnode-1; in++ )
+    for ( int in = 0; in < ncorner; in++ )
     {
       // indices of two nodes making the edge 
 
-      n1 = inodes0[in];
-      n2 = inodes0[in+1];
-
-      if ( globdat.isQuadratic ) n12 = inodesF[nnode - 1 + in]; // index of midside node
+      next = ( in + 1 ) % ncorner;
+      n1   = inodes0[in];
+      n2   = inodes0[next];
       
       //cout << "edge (" << n1 << "," << n2 << ")" << endl;
 
@@ -460,34 +443,32 @@ void   InterfaceBuilder::doForDomain ( Global& globdat )
 
       o1 = globdat.nodeId2Position[n1];
       o2 = globdat.nodeId2Position[n2];
-      m1 = globdat.nodeSet[o1]->getDuplicity ();
-      m2 = globdat.nodeSet[o2]->getDuplicity ();
+      m1 = globdat.nodeSet.getDuplicity ( o1 );
+      m2 = globdat.nodeSet.getDuplicity ( o2 );
 
       // edge on external boundary, also omitted
       // build boundary elements
       
-      npIt = find ( globdat.nodePairs.begin(), globdat.nodePairs.end(), NodePair(n1,n2) ); 
+      edge = bndEdges.find ( n1, n2 );
 
-      if ( npIt != globdat.nodePairs.end() )
+      if ( edge != EdgeIndex::NONE )
       {
-         npId = globdat.bndElemsDomain[npIt - globdat.nodePairs.begin()];
+         npId = bndEdges.getBoundaryTag ( edge );
 
          if (!globdat.isQuadratic)
          {
            bndElemConn[0] = inodes[in];
-	   bndElemConn[1] = inodes[in+1];
+	   bndElemConn[1] = inodes[next];
          }
          else
          {
-           // note that for corner nodes, using the corner connectivity
-           // for the midside nodes, using the full connectivity 
-           bndElemConn[0] = inodesC[in];
-           bndElemConn[1] = inodes[nnode - 1 + in];
-           bndElemConn[2] = inodesC[in+1];
-           //print (interConnec.begin(), interConnec.end());
+           // the corner nodes come first, then the midside nodes
+           bndElemConn[0] = inodes[in];
+           bndElemConn[1] = inodes[ncorner + in];
+           bndElemConn[2] = inodes[next];
          }
         
-         globdat.bndElementSet.push_back ( ElemPointer ( new Element ( bieCount, bndElemConn ) ) );
+         globdat.bndElementSet.push_back ( globdat.elemArena.create<Element> ( globdat.bndElemStore, bieCount, bndElemConn ) );
          globdat.dom2BndElems[npId].push_back ( bieCount++ );
 
 	 continue;
@@ -501,9 +482,7 @@ void   InterfaceBuilder::doForDomain ( Global& globdat )
 
       // ignore edge already added
 
-      if ( find ( doneEdges.begin(), 
-		  doneEdges.end  (), 
-		  NodePair(n1,n2) ) != doneEdges.end() )
+      if ( doneEdges.contains ( n1, n2 ) )
       {
 	continue;
       }
@@ -514,11 +493,11 @@ void   InterfaceBuilder::doForDomain ( Global& globdat )
       {
         bool val1, val2;
 
-        double x1 = globdat.nodeSet[o1]->getX ();
-        double y1 = globdat.nodeSet[o1]->getY ();
+        double x1 = globdat.nodeSet.getX ( o1 );
+        double y1 = globdat.nodeSet.getY ( o1 );
 
-        double x2 = globdat.nodeSet[o2]->getX ();
-        double y2 = globdat.nodeSet[o2]->getY ();
+        double x2 = globdat.nodeSet.getX ( o2 );
+        double y2 = globdat.nodeSet.getY ( o2 );
 
         for ( int is = 0; is < globdat.segment.size(); is++ )
         {
@@ -551,481 +530,621 @@ void   InterfaceBuilder::doForDomain ( Global& globdat )
       if (!globdat.isQuadratic)
       {
 	interConnec[0] = inodes[in];
-	interConnec[1] = inodes[in+1];
+	interConnec[1] = inodes[next];
       }
       else
       {
-        // note that for corner nodes, using the corner connectivity
-        // for the midside nodes, using the full connectivity 
-	interConnec[0] = inodesC[in];
-	interConnec[1] = inodes[nnode - 1 + in];
-	interConnec[2] = inodesC[in+1];
-        //print (interConnec.begin(), interConnec.end());
+        // the corner nodes come first, then the midside nodes
+	interConnec[0] = inodes[in];
+	interConnec[1] = inodes[ncorner + in];
+	interConnec[2] = inodes[next];
       }
 
-      // loop over neighbors of element ie
+      // the element across the edge, nodes of the edge in there
 
-      for ( int je = 0; je < neiCount; je++ )
-      {
-	 jelem = globdat.elemId2Position[neighbors[je]];
-	 jp    = globdat.elemSet[jelem];
-
-	 if ( jp->getIndex() == ielem ) continue; 
-
-	 jp->getConnectivity  ( jnodes  );
-	 jp->getConnectivity0 ( jnodes0 );
-
-	 //print ( jnodes0.begin(), jnodes0.end() );
-
-	 it1 = find ( jnodes0.begin(), jnodes0.end(), n1 );
-	 it2 = find ( jnodes0.begin(), jnodes0.end(), n2 );
-
-         // a common edge is found between ie and je
-
-	 if ( ( it1 != jnodes0.end() ) && ( it2 != jnodes0.end() ) )
-	 {
-	   p1 = jnodes[it1 - jnodes0.begin()];
-	   p2 = jnodes[it2 - jnodes0.begin()];
-	 
-           if (globdat.isQuadratic)
-           {
-             it12 = find ( jnodes0.begin(), jnodes0.end(), n12 );
-	     p12  = jnodes[it12 - jnodes0.begin()];
-	     
-             interConnec[3] = p1;
-	     interConnec[4] = p12;
-	     interConnec[5] = p2;
-           }
-           else
-           {
-	     interConnec[2] = p1;
-	     interConnec[3] = p2;
-           }
-
-	   //cout << " found common edge: (" << p1 << "," << p2 << ")" << endl;
-           //print (interConnec.begin(), interConnec.end());
-
-           
-           bulk1 = ielem;
-           bulk2 = jp->getIndex();
-           // the following is obsolete 
-           //bulk2 = ep->getIndexElementContainsEdge ( globdat, p1, p2 );
+      jelem = findCommonEdge ( p1, p2, p12, n1, ie, in, globdat );
 
-           //cout<< "bulk1 and bulk2: " <<  bulk1 << " " << bulk2 << " " << jp->getIndex() << endl;
-           bulk1 = globdat.elemId2Position[bulk1];
-           bulk2 = globdat.elemId2Position[bulk2];
+      if ( jelem == -1 ) continue;
 
-           globdat.interfaceSet.push_back ( ElemPointer ( new Element ( ieCount, 0,
-                   interConnec, bulk1, bulk2 ) ) );
-      
-           ieCount++;
+      if (globdat.isQuadratic)
+      {
+        interConnec[3] = p1;
+        interConnec[4] = p12;
+        interConnec[5] = p2;
+      }
+      else
+      {
+        interConnec[2] = p1;
+        interConnec[3] = p2;
+      }
 
-           if ( ( globdat.nodeSet[o1]->getIsInterface() ) && ( globdat.nodeSet[o2]->getIsInterface() ) )
-           {
-             globdat.interfaceMats.push_back ( 1 );
-           }
-           else
-           {
-             globdat.interfaceMats.push_back ( 0 );
-           }
+      bulk1 = ie;
+      bulk2 = jelem;
 
-           doneEdges.push_back ( NodePair(n1,n2) );
+      globdat.interfaceSet.push_back ( globdat.elemArena.create<Element> ( globdat.interfaceStore, ieCount, 0,
+              interConnec, bulk1, bulk2 ) );
+ 
+      ieCount++;
 
-	   break; // only have ONE edge in common
-	 }
+      if ( ( globdat.nodeSet.getIsInterface ( o1 ) ) && ( globdat.nodeSet.getIsInterface ( o2 ) ) )
+      {
+        globdat.interfaceMats.push_back ( 1 );
       }
+      else
+      {
+        globdat.interfaceMats.push_back ( 0 );
+      }
+
+      doneEdges.insert ( n1, n2 );
     }
   }
 }
 
 // ---------------------------------------------------------
-//   doForEverywhere2D
+//   work shared by the threads in doForEverywhere2D/3D
 // ---------------------------------------------------------
 
-void   InterfaceBuilder::doForEverywhere2D ( Global& globdat )
+/*
+ * An interface element is added on an interior edge (face) by the
+ * first element of elemSet that reaches it, so whether element ie adds
+ * one on its side depends only on ie and the element across. The
+ * elements are visited in parallel twice: once to count what each
+ * element adds, once (after a prefix sum over the counts) to fill the
+ * new elements into their slots. The numbering is that of a serial
+ * loop, whatever the number of threads.
+ */
+
+class Everywhere2D
 {
-  int              neiCount;
-  int              nnode;
-  int              n1,n2,n12;
-  int              m1,m2;
-  int              o1,o2;
-  int              p1,p2,p12;
-  int              ielem, jelem, ieCount(0), bieCount(0);
-  int              npId;
+  public:
 
-  ElemPointer      ep,jp;
-  
-  IntVector        inodes, inodes0, inodes00, inodesC, inodesF;
-  IntVector        jnodes, jnodes0;
-  IntVector        interConnec(globdat.nodeICount);
-  IntVector        bndElemConn(globdat.nodeICount/2);
-  IntVector        neighbors;
-  vector<NodePair> doneEdges;   // list of edges already done
+    // the passes, in this order
 
+    enum          Pass
+    {
+                    FIND_STOPS,
+                    COUNT,
+                    FILL
+    };
 
-  IntVector::const_iterator it1, it2, it12;
-  vector<NodePair>::const_iterator npIt;
-  
-  cout << " do everywhere for 2D mesh...\n";
+    Pass          pass;
 
-  const  int        elemCount = globdat.elemSet.size ();
+                  Everywhere2D
 
-  int      bulk1, bulk2;
+      ( Global&            globdat,
+        const EdgeIndex&   bndEdges )
 
-  for ( int ie = 0; ie < elemCount; ie++ )
-  {
-    ep    = globdat.elemSet[ie];
-    ielem = ep->getIndex();
+      : globdat_    ( globdat ),
+        bndEdges_   ( bndEdges ),
+        stops_      ( globdat.elemSet.size () ),
+        ifaceFirst_ ( globdat.elemSet.size () + 1, 0 ),
+        bndFirst_   ( globdat.elemSet.size () + 1, 0 ) {}
 
-    ep->getConnectivity        ( inodes  );      // modified connectivity 
-    ep->getCornerConnectivity0 ( inodes0 );      // original corner connectivity
-    //inodes00 = inodes0;
+    void          operator () ( int ic )
+    {
+      const int last = chunkEnd ( ic, globdat_.elemSet.size () );
 
-    if (globdat.isQuadratic)
+      for ( int ie = ic * CHUNK_SIZE; ie < last; ie++ )
+      {
+        if ( pass == FIND_STOPS ) findStop_ ( ie );
+        else                      visit_    ( ie );
+      }
+    }
+
+    // turns the counts into slots and makes room for the new elements;
+    // returns the number of interface elements
+
+    int           startFill ()
     {
-       ep->getConnectivity0       ( inodesF );
-       ep->getCornerConnectivity  ( inodesC );
-       inodesC.push_back (inodesC[0]);
+      const int elemCount = stops_.size ();
+
+      for ( int ie = 0; ie < elemCount; ie++ )
+      {
+        ifaceFirst_[ie+1] += ifaceFirst_[ie];
+        bndFirst_  [ie+1] += bndFirst_  [ie];
+      }
+
+      const int ieCount  = ifaceFirst_[elemCount];
+      const int bieCount = bndFirst_  [elemCount];
+
+      ifacePos_ = globdat_.interfaceStore.size ();
+      ifaceSet_ = globdat_.interfaceSet  .size ();
+      bndPos_   = globdat_.bndElemStore  .size ();
+      bndSet_   = globdat_.bndElementSet .size ();
+
+      globdat_.interfaceStore.append ( ieCount,  globdat_.nodeICount     );
+      globdat_.bndElemStore  .append ( bieCount, globdat_.nodeICount / 2 );
+
+      globdat_.interfaceSet  .resize ( ifaceSet_ + ieCount  );
+      globdat_.bndElementSet .resize ( bndSet_   + bieCount );
+      globdat_.interfaceMats .resize ( globdat_.interfaceMats.size () + ieCount );
+
+      ifaces_ = globdat_.elemArena.allocate<Element> ( ieCount  );
+      bnds_   = globdat_.elemArena.allocate<Element> ( bieCount );
+
+      npIds_.resize ( bieCount );
+
+      return ieCount;
     }
-    
-    inodes .push_back ( inodes [0] );     // add first node to make a closed loop
-    inodes0.push_back ( inodes0[0] );     // => edges 
 
-    nnode = inodes0.size();
+    // the boundary elements into dom2BndElems, in order
 
-    neighbors = globdat.elemNeighbors[ie]; 
-    neiCount  = neighbors.size ();
-    
-    //cout << "doing element " << ie+1 << ":\n ";
-   // print ( neighbors.begin(), neighbors.end() );
+    void          finish ()
+    {
+      for ( int ib = 0; ib < npIds_.size (); ib++ )
+      {
+        globdat_.dom2BndElems[npIds_[ib]].push_back ( ib );
+      }
+    }
 
-    // loop over edges, add interface along common edge
+  private:
 
-    for ( int in = 0; in < nnode-1; in++ )
+    // nodes of a quadratic interface element; boundary elements have half
+
+    static const int  MAX_NODES_ = 6;
+
+    enum          EdgeKind
     {
-      // indices of two nodes making the edge (original mesh)
+                    BOUNDARY_EDGE,  // boundary element
+                    SKIPPED_EDGE,   // not between two elements
+                    NOTCH_EDGE,     // existing notch: the element stops
+                    INNER_EDGE      // interface element
+    };
 
-      n1 = inodes0[in];
-      n2 = inodes0[in+1];
+    // original edge n1-n2, npId is set for a boundary edge
 
-      if (globdat.isQuadratic) n12 = inodesF[nnode-1+in];
-      
-      //cout << "edge (" << n1 << "," << n2 << ")" << endl;
+    EdgeKind      edgeKind_
 
-      // get number of elements around these nodes
-      o1 = globdat.nodeId2Position[n1];
-      o2 = globdat.nodeId2Position[n2];
-      m1 = globdat.nodeSet[o1]->getDuplicity ();
-      m2 = globdat.nodeSet[o2]->getDuplicity ();
-      
-      // edge on external boundary, also omitted
-      // build boundary elements
-      // this must be done before the next if command.
-      
-      npIt = find ( globdat.nodePairs.begin(), globdat.nodePairs.end(), NodePair(n1,n2) ); 
+      ( int                n1,
+        int                n2,
+        int&               npId ) const
+    {
+      const int edge = bndEdges_.find ( n1, n2 );
 
-      if ( npIt != globdat.nodePairs.end() )
+      if ( edge != EdgeIndex::NONE )
       {
-         //cout << "edge (" << n1 << "," << n2 << ")" << endl;
-         npId = globdat.bndElemsDomain[npIt - globdat.nodePairs.begin()];
-
-         if (!globdat.isQuadratic)
-         {
-           bndElemConn[0] = inodes[in];
-           bndElemConn[1] = inodes[in+1];
-         }
-         else
-         {
-           bndElemConn[0] = inodesC[in];
-           bndElemConn[1] = inodes[nnode-1+in];
-           bndElemConn[2] = inodesC[in+1];
-         }
-	
-         globdat.bndElementSet.push_back ( ElemPointer ( new Element ( bieCount, bndElemConn ) ) );
-         globdat.dom2BndElems[npId].push_back ( bieCount++ );
+        npId = bndEdges_.getBoundaryTag ( edge );
 
-	 continue;
+        return BOUNDARY_EDGE;
       }
 
+      // get number of elements around these nodes
+
+      const NodeStore& nodes = globdat_.nodeSet;
+
+      const int o1 = globdat_.nodeId2Position[n1];
+      const int o2 = globdat_.nodeId2Position[n2];
+      const int m1 = nodes.getDuplicity ( o1 );
+      const int m2 = nodes.getDuplicity ( o2 );
+
       // not a common edge (or not an interelement boundary), omits
       // This check cannot detect edges on the boundary!!!
       // Therefore, in geo file, must define boundaries as physical quantities.
-      
-      if ( ( m1 == 0 ) || ( m2 == 0 ) ) continue;
-      if ( ( m1 == 1 ) || ( m2 == 1 ) ) continue;
 
-      // ignore edge already added
+      if ( ( m1 == 0 ) || ( m2 == 0 ) ) return SKIPPED_EDGE;
+      if ( ( m1 == 1 ) || ( m2 == 1 ) ) return SKIPPED_EDGE;
+
+      // existing notch
 
-      if ( find ( doneEdges.begin(), 
-		  doneEdges.end  (), 
-		  NodePair(n1,n2) ) != doneEdges.end() )
+      if ( globdat_.isNotch )
       {
-	continue;
+        bool val1 = false, val2 = false;
+
+        for ( int is = 0; is < globdat_.segment.size(); is++ )
+        {
+          val1 = globdat_.segment[is].isOn ( nodes.getX ( o1 ), nodes.getY ( o1 ) );
+          val2 = globdat_.segment[is].isOn ( nodes.getX ( o2 ), nodes.getY ( o2 ) );
+
+          if ( val1 && val2 ) break;
+        }
+
+        if ( val1 && val2 ) return NOTCH_EDGE;
       }
-	
-      // existing notch
-      
-      if ( globdat.isNotch )
+
+      return INNER_EDGE;
+    }
+
+    // an element stops at its first edge on a notch
+
+    void          findStop_ ( int ie )
+    {
+      const int* inodes0 = globdat_.elemStore.getConnectivity0 ( ie );
+      const int  ncorner = globdat_.elemSet[ie]->getCornerCount ();
+
+      int        npId;
+
+      stops_[ie] = ncorner;
+
+      for ( int in = 0; in < ncorner; in++ )
       {
-        bool val1, val2;
+        if ( edgeKind_ ( inodes0[in], inodes0[(in+1) % ncorner], npId ) == NOTCH_EDGE )
+        {
+          stops_[ie] = in;
+          break;
+        }
+      }
+    }
 
-        double x1 = globdat.nodeSet[o1]->getX ();
-        double y1 = globdat.nodeSet[o1]->getY ();
+    // counts (COUNT) or adds (FILL) the elements of element ie
 
-        double x2 = globdat.nodeSet[o2]->getX ();
-        double y2 = globdat.nodeSet[o2]->getY ();
+    void          visit_ ( int ie )
+    {
+      const DualGraph& neighbors = globdat_.elemNeighbors;
 
-        for ( int is = 0; is < globdat.segment.size(); is++ )
+      const int* inodes0 = globdat_.elemStore.getConnectivity0 ( ie );
+      const int  ncorner = globdat_.elemSet[ie]->getCornerCount ();
+
+      int        iface   = pass == FILL ? ifaceFirst_[ie] : 0;
+      int        ibnd    = pass == FILL ? bndFirst_  [ie] : 0;
+      int        n1, n2, npId, jelem;
+
+      for ( int in = 0; in < stops_[ie]; in++ )
+      {
+        n1 = inodes0[in];
+        n2 = inodes0[(in+1) % ncorner];
+
+        const EdgeKind kind = edgeKind_ ( n1, n2, npId );
+
+        if ( kind == BOUNDARY_EDGE )
         {
-          val1 = globdat.segment[is].isOn ( x1, y1 );
-          val2 = globdat.segment[is].isOn ( x2, y2 );
+          if ( pass == FILL ) addBoundary_ ( ie, in, ibnd, npId );
 
-          if ( val1 && val2 ) break;
+          ibnd++;
+          continue;
         }
 
-        if ( val1 && val2 ) break; // do not add interface on existing notch
+        if ( kind != INNER_EDGE ) continue;
+
+        jelem = neighbors.getNeighbor ( ie, in );
+
+        if ( jelem == DualGraph::NONE ) continue;
+
+        // already added by the element across
+
+        if ( jelem < ie && neighbors.getNeighborSide ( ie, in ) < stops_[jelem] )
+        {
+          continue;
+        }
+
+        if ( pass == FILL ) addInterface_ ( ie, in, iface, n1, n2 );
+
+        iface++;
       }
-	
-      int mat = globdat.elem2Domain[ielem];
 
-      //if (  inodes == inodes00  )
-      //{
-      //  interConnec[0] = n1;
-      //  interConnec[1] = n2;
-      //}
-      //else
-      //{
-      //  interConnec[0] = inodes[in];
-      //  interConnec[1] = inodes[in+1];
-      //}
+      if ( pass == COUNT )
+      {
+        ifaceFirst_[ie+1] = iface;
+        bndFirst_  [ie+1] = ibnd;
+      }
+    }
 
-      if (!globdat.isQuadratic)
+    // boundary element number ib on edge in of element ie
+
+    void          addBoundary_
+
+      ( int                ie,
+        int                in,
+        int                ib,
+        int                npId )
+    {
+      const ElemPointer& ep      = globdat_.elemSet[ie];
+      const IntSpan      inodes  = ep->getNodes ();   // modified connectivity
+      const int          ncorner = ep->getCornerCount ();
+      const int          next    = ( in + 1 ) % ncorner;
+
+      int                bndElemConn[MAX_NODES_ / 2];
+
+      if (!globdat_.isQuadratic)
       {
-        interConnec[0] = inodes[in];
-        interConnec[1] = inodes[in+1];
+        bndElemConn[0] = inodes[in];
+        bndElemConn[1] = inodes[next];
       }
       else
       {
-        interConnec[0] = inodesC[in];
-        interConnec[1] = inodes[nnode-1+in];
-        interConnec[2] = inodesC[in+1];
+        bndElemConn[0] = inodes[in];
+        bndElemConn[1] = inodes[ncorner+in];
+        bndElemConn[2] = inodes[next];
       }
 
-      // loop over neighbors of element ie
+      globdat_.bndElemStore.set ( bndPos_ + ib, ib, bndElemConn );
 
-      for ( int je = 0; je < neiCount; je++ )
-      {
-	 jelem = globdat.elemId2Position[neighbors[je]];
-	 jp    = globdat.elemSet[jelem];
+      globdat_.bndElementSet[bndSet_ + ib] = new ( bnds_ + ib )
+        Element ( globdat_.bndElemStore, bndPos_ + ib );
 
-	 if ( jp->getIndex() == ielem ) continue;    // skip element ielem 
+      npIds_[ib] = npId;
+    }
+
+    // interface element number iface on edge in (n1,n2) of element ie
 
-	 jp->getConnectivity  ( jnodes  );           // modified connectivity
-	 jp->getConnectivity0 ( jnodes0 );           // original connectivity
+    void          addInterface_
 
-	 //print ( jnodes0.begin(), jnodes0.end() );
+      ( int                ie,
+        int                in,
+        int                iface,
+        int                n1,
+        int                n2 )
+    {
+      const ElemPointer& ep      = globdat_.elemSet[ie];
+      const IntSpan      inodes  = ep->getNodes ();   // modified connectivity
+      const int          ncorner = ep->getCornerCount ();
+      const int          next    = ( in + 1 ) % ncorner;
 
-	 it1 = find ( jnodes0.begin(), jnodes0.end(), n1 );
-	 it2 = find ( jnodes0.begin(), jnodes0.end(), n2 );
+      int                interConnec[MAX_NODES_];
+      int                p1, p2, p12;
 
-         // find n1,n2 are present in jnodes0, an interelement boundary found
+      if (!globdat_.isQuadratic)
+      {
+        interConnec[0] = inodes[in];
+        interConnec[1] = inodes[next];
+      }
+      else
+      {
+        interConnec[0] = inodes[in];
+        interConnec[1] = inodes[ncorner+in];
+        interConnec[2] = inodes[next];
+      }
 
-	 if ( ( it1 != jnodes0.end() ) && ( it2 != jnodes0.end() ) )
-	 {
-	   p1 = jnodes[it1 - jnodes0.begin()];
-	   p2 = jnodes[it2 - jnodes0.begin()];
+      // the element across the edge, nodes of the edge in there
 
-           if (globdat.isQuadratic)
-           {
-              it12 = find ( jnodes0.begin(), jnodes0.end(), n12 );
-	      p12  = jnodes[it12 - jnodes0.begin()];
-           }
+      const int          jelem = findCommonEdge ( p1, p2, p12, n1, ie, in, globdat_ );
 
-	   //cout << " found common edge: (" << p1 << "," << p2 << ")" << endl;
+      if (!globdat_.isQuadratic)
+      {
+        interConnec[2] = p1;
+        interConnec[3] = p2;
+      }
+      else
+      {
+        interConnec[3] = p1;
+        interConnec[4] = p12;
+        interConnec[5] = p2;
+      }
 
-           if (!globdat.isQuadratic)
-           {
-	     interConnec[2] = p1;
-	     interConnec[3] = p2;
-           }
-           else
-           {
-	     interConnec[3] = p1;
-	     interConnec[4] = p12;
-	     interConnec[5] = p2;
-           }
+      globdat_.interfaceStore.set ( ifacePos_ + iface, iface, interConnec );
 
-           bulk1 = ielem;
-           bulk2 = jp->getIndex();
-           //bulk2 = ep->getIndexElementContainsEdge ( globdat, p1, p2 );
+      globdat_.interfaceSet[ifaceSet_ + iface] = new ( ifaces_ + iface )
+        Element ( globdat_.interfaceStore, ifacePos_ + iface, ie, jelem );
 
-           //cout<< "bulk1 and bulk2: " <<  bulk1 << " " << bulk2 << endl;
-           bulk1 = globdat.elemId2Position[bulk1];
-           bulk2 = globdat.elemId2Position[bulk2];
+      const int          o1 = globdat_.nodeId2Position[n1];
+      const int          o2 = globdat_.nodeId2Position[n2];
 
-           globdat.interfaceSet.push_back ( ElemPointer ( new Element ( ieCount, 0,
-                   interConnec, bulk1, bulk2 ) ) );
-      
-           ieCount++;
-
-           if ( ( globdat.nodeSet[o1]->getIsInterface() ) && 
-                ( globdat.nodeSet[o2]->getIsInterface() ) )
-           {
-             globdat.interfaceMats.push_back ( 1 );
-           }
-           else
-           {
-             globdat.interfaceMats.push_back ( 0 );
-           }
-
-           doneEdges.push_back ( NodePair(n1,n2) );
-
-	   break; // only have ONE edge in common
-	 }
-      }
+      globdat_.interfaceMats[ifaceSet_ + iface] =
+        ( globdat_.nodeSet.getIsInterface ( o1 ) &&
+          globdat_.nodeSet.getIsInterface ( o2 ) ) ? 1 : 0;
     }
-  }
 
-  cout << ieCount << " interface elements added\n";
-}
+  private:
 
+    Global&            globdat_;
+    const EdgeIndex&   bndEdges_;
 
-// ---------------------------------------------------------
-//   doForEverywhere3D
-// ---------------------------------------------------------
+    IntVector          stops_;       // edges of each element visited
+    IntVector          ifaceFirst_;  // first interface element of each element
+    IntVector          bndFirst_;    // first boundary element of each element
+    IntVector          npIds_;       // tag of each boundary element
 
-void   InterfaceBuilder::doForEverywhere3D ( Global& globdat )
+    int                ifacePos_, ifaceSet_;
+    int                bndPos_,   bndSet_;
+
+    Element*           ifaces_;      // room for the new elements
+    Element*           bnds_;
+};
+
+class Everywhere3D
 {
-  ElemPointer        ip, jp;
-
-  int                ielem, jelem;
-  int                faceCount, neiCount;
-  int                nodeCount; // # nodes per face
-  int                n, ieCount(0);
-  int                bulk1, bulk2;
-  int                oppVertex;
-  
-  IntVector          face, sface, fface, fface0;
-  IntVector          dface, dfaceu, dupNodes;
-  IntVector          interConnec(globdat.nodeICount);
-  IntVector          neighbors;
-  vector<IntVector>  ifaces0, jfaces, jfaces0, jffaces, doneFaces;
-  
-  vector<IntVector>::const_iterator it;
-  IntVector        ::const_iterator iit;
+  public:
 
-  const  int         elemCount = globdat.elemSet.size ();
-                     nodeCount = globdat.nodeICount/2;
+    enum          Pass
+    {
+                    COUNT,
+                    FILL
+    };
 
-  // loop over elements
+    Pass          pass;
 
-  for ( int ie = 0; ie < elemCount; ie++ )
-  {
-    ip    = globdat.elemSet[ie];
-    ielem = ip->getIndex ();
+                  Everywhere3D ( Global& globdat )
 
-    ip->getSortedFaces0 ( ifaces0 );            // faces of original mesh of element "ie"
+      : globdat_    ( globdat ),
+        ifaceFirst_ ( globdat.elemSet.size () + 1, 0 ) {}
 
-    // loop over faces
+    void          operator () ( int ic )
+    {
+      const int last = chunkEnd ( ic, globdat_.elemSet.size () );
 
-    faceCount = ifaces0.size ( );
+      for ( int ie = ic * CHUNK_SIZE; ie < last; ie++ )
+      {
+        visit_ ( ie );
+      }
+    }
 
-    //cout <<  " element: " << ie << "\n";
+    // turns the counts into slots and makes room for the new elements;
+    // returns the number of interface elements
 
-    for ( int kf = 0; kf < faceCount; kf++ )
+    int           startFill ()
     {
-      face. resize ( nodeCount );
-      face  = ifaces0[kf];
+      const int elemCount = globdat_.elemSet.size ();
+
+      for ( int ie = 0; ie < elemCount; ie++ )
+      {
+        ifaceFirst_[ie+1] += ifaceFirst_[ie];
+      }
+
+      const int ieCount = ifaceFirst_[elemCount];
+
+      ifacePos_ = globdat_.interfaceStore.size ();
+      ifaceSet_ = globdat_.interfaceSet  .size ();
+
+      globdat_.interfaceStore  .append ( ieCount, globdat_.nodeICount );
+      globdat_.interfaceSet    .resize ( ifaceSet_ + ieCount );
+      globdat_.interfaceMats   .resize ( globdat_.interfaceMats   .size () + ieCount, 0 );
+      globdat_.oppositeVertices.resize ( globdat_.oppositeVertices.size () + ieCount );
+
+      ifaces_ = globdat_.elemArena.allocate<Element> ( ieCount );
 
-      oppVertex = ip->getOppVertex ( kf );
+      return ieCount;
+    }
+
+  private:
 
-      // omit face already handled
+    // counts (COUNT) or adds (FILL) the elements of element ie
+
+    void          visit_ ( int ie )
+    {
+      const DualGraph&   neighbors = globdat_.elemNeighbors;
+      const ElemPointer& ip        = globdat_.elemSet[ie];
+      const int          faceCount = neighbors.getSideCount ( ie );
 
-      if ( find ( doneFaces.begin(), doneFaces.end  (), face ) != doneFaces.end() )
+      int                iface     = pass == FILL ? ifaceFirst_[ie] : 0;
+      int                jelem;
+
+      for ( int kf = 0; kf < faceCount; kf++ )
       {
-	continue;
+        if ( ip->isOnExternalBoundary ( kf, globdat_ ) )  continue;
+
+        // the element across the face, which adds the interface if
+        // it comes first
+
+        jelem = neighbors.getNeighbor ( ie, kf );
+
+        if ( jelem == DualGraph::NONE || jelem < ie ) continue;
+
+        if ( pass == FILL ) addInterface_ ( ie, kf, jelem, iface );
+
+        iface++;
       }
 
-      if ( ip->isOnExternalBoundary ( kf, globdat ) )  continue;
-            
+      if ( pass == COUNT ) ifaceFirst_[ie+1] = iface;
+    }
+
+    // interface element number iface on face kf of element ie
+
+    void          addInterface_
+
+      ( int                ie,
+        int                kf,
+        int                jelem,
+        int                iface )
+    {
+      const ElemPointer& ip        = globdat_.elemSet[ie];
+      const ElemPointer& jp        = globdat_.elemSet[jelem];
+      const int          nodeCount = globdat_.nodeICount/2; // # nodes per face
+
+      int                interConnec[MAX_NODES_];
+      int                n = 0;
+
       // upper face of the interface element
 
-      ip->getFullFace0 ( fface0, kf );
-      ip->getFullFace  ( fface,  kf );
+      const FaceView     fface0 = ip->getFullFace0 ( kf );
+      const FaceView     fface  = ip->getFullFace  ( kf );
 
       for ( int in = 0; in < fface.size(); in++ )
       {
-         n                          = fface[in];
-	 interConnec[in]            = n;
+        n               = fface[in];
+        interConnec[in] = n;
       }
-	      
-      neighbors = globdat.elemNeighbors[ie]; 
-      neiCount  = neighbors.size ();
 
-      // loop over neighbors of element ie
+      // modified full face of jelem (works also for quadratic elems)
+
+      const FaceView     dface  =
+        jp->getFullFace ( globdat_.elemNeighbors.getNeighborSide ( ie, kf ) );
 
-      for ( int je = 0; je < neiCount; je++ )
+      for ( int in = 0; in < nodeCount; in++ )
       {
-	 jelem = globdat.elemId2Position[neighbors[je]];
-	 jp    = globdat.elemSet[jelem];
+        const IntSpan    dupNodes = globdat_.copiesOf ( fface0[in] );
 
-	 if ( jp->getIndex() == ielem ) continue; // omit element being considered
+        for ( int id = 0; id < dupNodes.size(); id++ )
+        {
+          if ( dface.contains ( dupNodes[id] ) )
+          {
+            n = dupNodes[id];
+            break;
+          }
+        }
+        interConnec[in+nodeCount]  = n;
+      }
 
-	 // find common face
+      globdat_.interfaceStore.set ( ifacePos_ + iface, iface, interConnec );
 
-	 jp->getSortedFaces0        ( jfaces0  );  // original sorted faces
-	 jp->getSortedFaces         ( jfaces   );  // original sorted faces
-	 jp->getFFaces              ( jffaces  );  // modified full faces (work also for quadratic elems)
+      globdat_.interfaceSet[ifaceSet_ + iface] = new ( ifaces_ + iface )
+        Element ( globdat_.interfaceStore, ifacePos_ + iface, ie, jelem );
 
-	 // common face between ielem and jelem found
-	 
-         it = find ( jfaces0.begin(), jfaces0.end  (), face );
+      globdat_.oppositeVertices[ifaceSet_ + iface] = ip->getOppVertex ( kf );
+    }
 
-	 if ( it != jfaces0.end() )
-	 {
-            //cout <<  " found common face: " << jp->getIndex() << "\n";
-	    
-            dface  = jffaces[it - jfaces0.begin()];
-	    dfaceu = jfaces [it - jfaces0.begin()];
+  private:
 
-            for ( int in = 0; in < nodeCount; in++ )
-	    {
-              dupNodes = globdat.duplicatedNodes0[fface0[in]]; 
-              for ( int id = 0; id < dupNodes.size(); id++ )
-              {
-                 iit  = find ( dface.begin(), dface.end  (), dupNodes[id] );
-                 if ( iit != dface.end() )
-                 {
-                    n = *iit;
-                    break;
-                 }
-              }
-	      interConnec[in+nodeCount]  = n;
-	    }
-      
-            // insert this interface 
-       
-            bulk1 = ip->getIndex();
-            bulk2 = jp->getIndex();
-            //bulk2 = ip->getIndexElementContainsFace ( globdat, dfaceu );
+    // nodes of a Hex20 interface element
 
-            cout<< "bulk1 and bulk2: " <<  bulk1 << " " << bulk2 << endl;
-            cout<< " bulk2: " <<   jp->getIndex() << endl;
-            bulk1 = globdat.elemId2Position[bulk1];
-            bulk2 = globdat.elemId2Position[bulk2];
+    static const int   MAX_NODES_ = 16;
 
-            globdat.interfaceSet.push_back ( ElemPointer ( new Element ( ieCount, 0, interConnec, bulk1, bulk2 ) ) );
+    Global&            globdat_;
 
-            globdat.interfaceMats.push_back    (0);
-            globdat.oppositeVertices.push_back (oppVertex);
-            ieCount++;
+    IntVector          ifaceFirst_;  // first interface element of each element
 
-            doneFaces.push_back ( face );
+    int                ifacePos_, ifaceSet_;
 
-	    break; // only have ONE face in common
-	 }
-      }      // end of loop over neighbors
-    }
+    Element*           ifaces_;      // room for the new elements
+};
+
+// ---------------------------------------------------------
+//   doForEverywhere2D
+// ---------------------------------------------------------
+
+void   InterfaceBuilder::doForEverywhere2D ( Global& globdat )
+{
+  const int        elemCount = globdat.elemSet.size ();
+
+  EdgeIndex        bndEdges;    // edges on the external boundary
+
+  cout << " do everywhere for 2D mesh...\n";
+
+  buildEdgeIndex ( bndEdges, globdat );
+
+  Everywhere2D     everywhere ( globdat, bndEdges );
+
+  everywhere.pass = Everywhere2D::FIND_STOPS;
+  parallelFor ( chunkCount ( elemCount ), globdat.threadCount, everywhere );
+
+  everywhere.pass = Everywhere2D::COUNT;
+  parallelFor ( chunkCount ( elemCount ), globdat.threadCount, everywhere );
+
+  const int        ieCount = everywhere.startFill ();
+
+  everywhere.pass = Everywhere2D::FILL;
+  parallelFor ( chunkCount ( elemCount ), globdat.threadCount, everywhere );
+
+  everywhere.finish ();
+
+  cout << ieCount << " interface elements added\n";
+}
+
+
+// ---------------------------------------------------------
+//   doForEverywhere3D
+// ---------------------------------------------------------
+
+void   InterfaceBuilder::doForEverywhere3D ( Global& globdat )
+{
+  const int        elemCount = globdat.elemSet.size ();
+
+  Everywhere3D     everywhere ( globdat );
+
+  everywhere.pass = Everywhere3D::COUNT;
+  parallelFor ( chunkCount ( elemCount ), globdat.threadCount, everywhere );
+
+  const int        first   = globdat.interfaceSet.size ();
+  const int        ieCount = everywhere.startFill ();
+
+  everywhere.pass = Everywhere3D::FILL;
+  parallelFor ( chunkCount ( elemCount ), globdat.threadCount, everywhere );
+
+  for ( int ie = first; ie < first + ieCount; ie++ )
+  {
+    const ElemPointer& ep = globdat.interfaceSet[ie];
+
+    cout<< "bulk1 and bulk2: " << globdat.elemSet[ep->getBulk1()]->getIndex() << " "
+                               << globdat.elemSet[ep->getBulk2()]->getIndex() << endl;
+    cout<< " bulk2: " << globdat.elemSet[ep->getBulk2()]->getIndex() << endl;
   }
 }
 
@@ -1040,57 +1159,58 @@ void   InterfaceBuilder::doFor2DPolycrystal ( Global& globdat )
   int              m1,m2;
   int              o1,o2;
   int              ielem, jelem;
-  int		   nnode, ieCount = 0;
+  int		   ncorner, next, ieCount = 0;
 
-  ElemPointer      ep, jp;
+  ElemPointer      ep;
   
-  IntVector        inodes0, inodes, inodesF;
+  IntSpan          inodes0, inodes, inodesF;
 
   IntVector        interConnec(globdat.nodeICount);
-  IntVector        neighbors;
 
-  vector<NodePair> doneEdges;   
+  EdgeIndex        bndEdges;    // edges on the external boundary
+  EdgeIndex        doneEdges;   
+  EdgeIndex        ignoredEdges;
 
   int              ignoredEdgeCount = 0;
 
   const  int       elemCount = globdat.elemSet.size ();
 
+  buildEdgeIndex ( bndEdges, globdat );
+
+  for ( size_t ip = 0; ip < globdat.ignoredEdges.size (); ip++ )
+  {
+    ignoredEdges.insert ( globdat.ignoredEdges[ip].node1, 
+                          globdat.ignoredEdges[ip].node2 );
+  }
+
    for ( int ie = 0; ie < elemCount; ie++ )
    {
       ep    = globdat.elemSet[ie];
       ielem = ep->getIndex();
 
-      ep->getCornerConnectivity0 ( inodes0 ); 
-      ep->getCornerConnectivity  ( inodes  ); 
-
-      if ( globdat.isQuadratic ) 
-      {
-        ep->getConnectivity0 ( inodesF ); 
-      }
-
-      inodes0.push_back ( inodes0[0] );  
-      inodes .push_back ( inodes [0] );  
-
-      nnode     = inodes0.size();
- 
-      neighbors = globdat.elemNeighbors[ie]; 
+      inodes0 = ep->getCornerNodes0 (); 
+      inodes  = ep->getCornerNodes  (); 
+      inodesF = ep->getNodes0       (); 
+      ncorner = inodes0.size ();
 
       // loop over edges, add interface along common edge
 
-      for ( int in = 0; in < nnode-1; in++ )
+      for ( int in = 0; in < ncorner; in++ )
       {
-	n10  = inodes0[in]; n20 = inodes0[in+1];
-	n1   = inodes[in];  n2  = inodes[in+1];
+        next = ( in + 1 ) % ncorner;
+
+	n10  = inodes0[in]; n20 = inodes0[next];
+	n1   = inodes[in];  n2  = inodes[next];
 
         // index of midside node
 
-        if ( globdat.isQuadratic ) p12 = inodesF[nnode - 1 + in]; 
+        if ( globdat.isQuadratic ) p12 = inodesF[ncorner + in]; 
 
 	o1  = globdat.nodeId2Position[n10];
 	o2  = globdat.nodeId2Position[n20];
 
-	m1  = globdat.nodeSet[o1]->getDuplicity ();
-	m2  = globdat.nodeSet[o2]->getDuplicity ();
+	m1  = globdat.nodeSet.getDuplicity ( o1 );
+	m2  = globdat.nodeSet.getDuplicity ( o2 );
 
 	// not a common edge, omits
 	
@@ -1099,27 +1219,21 @@ void   InterfaceBuilder::doFor2DPolycrystal ( Global& globdat )
 
 	// edge on external boundary, also omitted
 
-	if ( find ( globdat.nodePairs.begin(), 
-		    globdat.nodePairs.end  (), 
-		    NodePair(n10,n20) ) != globdat.nodePairs.end() )
+	if ( bndEdges.contains ( n10, n20 ) )
 	{
 	  continue;
 	}
 
 	// ignore edge already added
 
-	if ( find ( doneEdges.begin(), 
-		    doneEdges.end  (), 
-		    NodePair(n10,n20) ) != doneEdges.end() )
+	if ( doneEdges.contains ( n10, n20 ) )
 	{
 	  break;
 	}
 
 	// ignore edge belongs to ignoredEdges
 
-	if ( find ( globdat.ignoredEdges.begin(), 
-		    globdat.ignoredEdges.end  (), 
-		    NodePair(n10,n20) ) != globdat.ignoredEdges.end() )
+	if ( ignoredEdges.contains ( n10, n20 ) )
 	{
 	  break;
 	}
@@ -1128,11 +1242,11 @@ void   InterfaceBuilder::doFor2DPolycrystal ( Global& globdat )
 	
         if ( globdat.isNotch )
 	{
-	  double x1 = globdat.nodeSet[o1]->getX ();
-	  double y1 = globdat.nodeSet[o1]->getY ();
+	  double x1 = globdat.nodeSet.getX ( o1 );
+	  double y1 = globdat.nodeSet.getY ( o1 );
 
-	  double x2 = globdat.nodeSet[o2]->getX ();
-	  double y2 = globdat.nodeSet[o2]->getY ();
+	  double x2 = globdat.nodeSet.getX ( o2 );
+	  double y2 = globdat.nodeSet.getY ( o2 );
 
 	  bool val1 = globdat.segment[0].isOn ( x1, y1 );
 	  bool val2 = globdat.segment[0].isOn ( x2, y2 );
@@ -1142,7 +1256,7 @@ void   InterfaceBuilder::doFor2DPolycrystal ( Global& globdat )
             //cout << n1 << " p1 (" << x1 << "," << y1 << ")\n";
             //cout << n2 << " p2 (" << x2 << "," << y2 << ")\n\n";
 
-	    doneEdges.push_back ( NodePair(n10,n20) );
+	    doneEdges.insert ( n10, n20 );
 	    ignoredEdgeCount++;
 
 	    break;
@@ -1157,7 +1271,7 @@ void   InterfaceBuilder::doFor2DPolycrystal ( Global& globdat )
 	}
 	else if  ( m1 == 3 || m2 == 3 ) // junction node
 	{
-	  findCommonEdge ( p1, p2, n10, n20, ielem, neighbors, globdat );
+	  findCommonEdge ( p1, p2, m12, n10, ie, in, globdat );
 
 	  if ( ep->getChanged() )
 	  {
@@ -1181,12 +1295,12 @@ void   InterfaceBuilder::doFor2DPolycrystal ( Global& globdat )
 	  exit(1);
 	}
 
-	globdat.interfaceSet.push_back ( ElemPointer ( new Element ( ieCount, interConnec ) )
+	globdat.interfaceSet.push_back ( globdat.elemArena.create<Element> ( globdat.interfaceStore, ieCount, interConnec )
 				       );
 
 	globdat.interfaceMats.push_back (0);
 	ieCount++;
-	doneEdges.push_back ( NodePair(n1,n2) );
+	doneEdges.insert ( n1, n2 );
      }
   }
 
@@ -1202,16 +1316,16 @@ void   InterfaceBuilder::doFor3DPolycrystal ( Global& globdat )
 {
    ElemPointer        ip;
 
-  IntVector          face, sface;
+  IntVector          face;
   IntVector          interConnec;
-  IntVector          neighbors;
-  IntVector          inodes, inodes0;
+  IntSpan            inodes, inodes0;
 
-  vector<IntVector>  doneFaces;
+  FaceIndex          faces;        // faces of the torn mesh
+  FaceIndex          doneFaces;
 
-  int                nodeCount, neiCount;
+  int                nodeCount;
   int                ieCount = 0;
-  int                ielem, jelem, m, n, mat;
+  int                jelem, m, n, mat;
   int                oppVertex, fIndex;
 
   bool               isOnInterface;
@@ -1219,18 +1333,19 @@ void   InterfaceBuilder::doFor3DPolycrystal ( Global& globdat )
 
   const  int         elemCount = globdat.elemSet.size ();
 
+  buildFaceIndex ( faces, globdat, true );
+
   for ( int ie = 0; ie < elemCount; ie++ )
   {
     ip    = globdat.elemSet[ie];
-    ielem = ip->getIndex ();
 
     isOnInterface = ip->isOnInterface ( face, oppVertex, fIndex, 
 	                                globdat.nodeSet, globdat.nodeId2Position );
 
     if ( !isOnInterface ) continue;
 
-    ip->getConnectivity  ( inodes  );
-    ip->getConnectivity0 ( inodes0 );
+    inodes  = ip->getNodes  ();
+    inodes0 = ip->getNodes0 ();
 
     if ( isOnInterface )
     {
@@ -1247,7 +1362,7 @@ void   InterfaceBuilder::doFor3DPolycrystal ( Global& globdat )
       for ( int in = 0; in < nodeCount; in++ )
       {
         m    = face[in];
-        mat  = globdat.nodeSet[globdat.nodeId2Position[m]]->getDuplicity();
+        mat  = globdat.nodeSet.getDuplicity ( globdat.nodeId2Position[m] );
 
         if ( mat == 3 ) 
         {
@@ -1263,23 +1378,15 @@ void   InterfaceBuilder::doFor3DPolycrystal ( Global& globdat )
 	int    n1   = face[0];
 	int    n2   = face[1];
 
-        double x1   = globdat.nodeSet[globdat.nodeId2Position[n1]]->getX ();
-        double x2   = globdat.nodeSet[globdat.nodeId2Position[n2]]->getX ();
+        double x1   = globdat.nodeSet.getX ( globdat.nodeId2Position[n1] );
+        double x2   = globdat.nodeSet.getX ( globdat.nodeId2Position[n2] );
 
 	double x = x1 > x2 ? x1 : x2;
 
 	if ( x < xMax ) continue;
       }
 
-      // sort the connectivity of face so that
-      // it can be compared with simply "=" operator
-
-      sface = face;
-      sort ( sface.begin(), sface.end() );
-
-      if ( find ( doneFaces.begin(),
-	          doneFaces.end  (), 
-		  sface ) != doneFaces.end() )
+      if ( doneFaces.contains ( face ) )
       {
 	continue;
       }
@@ -1292,28 +1399,21 @@ void   InterfaceBuilder::doFor3DPolycrystal ( Global& globdat )
 	{
 	  n                          = face[in];
 	  interConnec[in]            = n;
-	  interConnec[in+nodeCount]  = globdat.duplicatedNodes0[n][1] ;
+	  interConnec[in+nodeCount]  = copyOfNode ( n, globdat );
 	}
       }
       else
       {
-	IntVector           neighbors;
-	IntVector           jnodes,jnodes0;
-	vector<IntVector>   jfaces;
-
-	int                 neiCount, jelem;
 	int                 p1, p2, p3;
 	int                 m1, m2, m3;
 
-	ElemPointer         jp;
-
-        IntVector::const_iterator it1, it2, it3, it0, itE;
+        const int          *it1, *it2, *it3, *it0, *itE;
 
 	m1 = face[0];
 	m2 = face[1];
 	m3 = face[2];
 
-	if ( inodes == inodes0 ) 
+	if ( equal ( inodes.begin (), inodes.end (), inodes0.begin () ) ) 
 	{
 	  interConnec[0] = m1;
 	  interConnec[1] = m2;
@@ -1333,60 +1433,40 @@ void   InterfaceBuilder::doFor3DPolycrystal ( Global& globdat )
 	  interConnec[2] = inodes[it3-it0];
 	}
 
-	neighbors = globdat.elemNeighbors[ie]; 
-        neiCount  = neighbors.size ();
+        // the element across the face (torn mesh)
 
-        // loop over neighbors of element ie
+	jelem = faces.getOtherOwner ( faces.find ( face ), ie );
 
-	for ( int je = 0; je < neiCount; je++ )
+	if ( jelem != FaceIndex::NONE )
 	{
-	   jelem = globdat.elemId2Position[neighbors[je]];
-	   jp    = globdat.elemSet[jelem];
-
-	   // omit element being considered
-
-	   if ( jp->getIndex() == ielem ) continue; 
-
-	   // find common face
+	  const ElemStore&  store   = globdat.elemStore;
+	  const int*        jnodes0 = store.getConnectivity0 ( jelem );
+	  const int*        jnodes  = store.getConnectivity  ( jelem );
+	  const int*        jE      = jnodes0 + store.getNodeCount ( jelem );
 
-	   jp->getSortedFaces   ( jfaces  );
-	   jp->getConnectivity  ( jnodes  );
-	   jp->getConnectivity0 ( jnodes0 );
+	  const int*        jt1     = find ( jnodes0, jE, m1 );
+	  const int*        jt2     = find ( jnodes0, jE, m2 );
 
-	   // common face between ielem and jelem found
+	  p1 = jnodes[jt1 - jnodes0];
+	  p2 = jnodes[jt2 - jnodes0];
+	  p3 = jnodes[jt2 - jnodes0];
 
-	   if ( find ( jfaces.begin(), jfaces.end  (), sface ) != jfaces.end() )
-	   {
-	     it0 = jnodes0.begin();
-	     itE = jnodes0.end  ();
-
-	     it1 = find ( it0, itE, m1 );
-	     it2 = find ( it0, itE, m2 );
-	     it3 = find ( it0, itE, m3 );
-
-	     p1 = jnodes[it1 - it0];
-	     p2 = jnodes[it2 - it0];
-	     p3 = jnodes[it2 - it0];
-
-	     interConnec[3] = p1;
-	     interConnec[4] = p2;
-	     interConnec[5] = p3;
-
-	     break; // only have ONE face in common
-	   }
+	  interConnec[3] = p1;
+	  interConnec[4] = p2;
+	  interConnec[5] = p3;
 	}
       }
 
       // insert this interface 
 
       globdat.interfaceSet.push_back 
-	( ElemPointer ( new Element ( ieCount, interConnec ) ) );
+	( globdat.elemArena.create<Element> ( globdat.interfaceStore, ieCount, interConnec ) );
 
       globdat.interfaceMats.push_back    (0);
       globdat.oppositeVertices.push_back (oppVertex);
       ieCount++;
 
-      doneFaces.push_back ( sface );
+      doneFaces.insert ( face );
     }
   }
 }
@@ -1408,6 +1488,17 @@ void  addInterface
 	   bool       changed,
 	   Global&    globdat )
 {
+  // every node of the interface must have a copy; the midside node of
+  // an edge between two interfacial corners may not have one
+
+  if ( globdat.copiesOf ( n1 ).size () < 2 ||
+       globdat.copiesOf ( n2 ).size () < 2 ||
+       ( globdat.isQuadratic && globdat.copiesOf ( p1 ).size () < 2 ) )
+  {
+    cerr << "Interface node without a copy!!!\n";
+    exit(1);
+  }
+
   if ( !globdat.isQuadratic )
   {
     // handle orientation of the cohesive segment
@@ -1418,41 +1509,41 @@ void  addInterface
    // {
       // add nodes for the two faces of the interface element
 
-      interConnec[0] = globdat.duplicatedNodes0[n1][0] ;
-      interConnec[1] = globdat.duplicatedNodes0[n2][0] ;
+      interConnec[0] = globdat.copiesOf ( n1 )[0] ;
+      interConnec[1] = globdat.copiesOf ( n2 )[0] ;
 
-      interConnec[2] = globdat.duplicatedNodes0[n1][1] ;
-      interConnec[3] = globdat.duplicatedNodes0[n2][1] ;
+      interConnec[2] = globdat.copiesOf ( n1 )[1] ;
+      interConnec[3] = globdat.copiesOf ( n2 )[1] ;
     //}
     //else
    // {
-     // interConnec[0] = globdat.duplicatedNodes0[n2][0] ;
-      //interConnec[1] = globdat.duplicatedNodes0[n1][0] ;
-      //interConnec[2] = globdat.duplicatedNodes0[n2][1] ;
-      //interConnec[3] = globdat.duplicatedNodes0[n1][1] ;
+     // interConnec[0] = globdat.copiesOf ( n2 )[0] ;
+      //interConnec[1] = globdat.copiesOf ( n1 )[0] ;
+      //interConnec[2] = globdat.copiesOf ( n2 )[1] ;
+      //interConnec[3] = globdat.copiesOf ( n1 )[1] ;
     //}
   }
   else
   {
     if ( !changed )
     {
-      interConnec[0] = globdat.duplicatedNodes0[n1][0] ;
-      interConnec[1] = globdat.duplicatedNodes0[p1][0] ; // midside node
-      interConnec[2] = globdat.duplicatedNodes0[n2][0] ;
+      interConnec[0] = globdat.copiesOf ( n1 )[0] ;
+      interConnec[1] = globdat.copiesOf ( p1 )[0] ; // midside node
+      interConnec[2] = globdat.copiesOf ( n2 )[0] ;
 
-      interConnec[3] = globdat.duplicatedNodes0[n1][1] ;
-      interConnec[4] = globdat.duplicatedNodes0[p1][1] ; // midside node
-      interConnec[5] = globdat.duplicatedNodes0[n2][1] ;
+      interConnec[3] = globdat.copiesOf ( n1 )[1] ;
+      interConnec[4] = globdat.copiesOf ( p1 )[1] ; // midside node
+      interConnec[5] = globdat.copiesOf ( n2 )[1] ;
     }
     else
     {
-      interConnec[0] = globdat.duplicatedNodes0[n2][0] ;
-      interConnec[1] = globdat.duplicatedNodes0[p1][0] ; // midside node
-      interConnec[2] = globdat.duplicatedNodes0[n1][0] ;
+      interConnec[0] = globdat.copiesOf ( n2 )[0] ;
+      interConnec[1] = globdat.copiesOf ( p1 )[0] ; // midside node
+      interConnec[2] = globdat.copiesOf ( n1 )[0] ;
 
-      interConnec[3] = globdat.duplicatedNodes0[n2][1] ;
-      interConnec[4] = globdat.duplicatedNodes0[p1][1] ; // midside node
-      interConnec[5] = globdat.duplicatedNodes0[n1][1] ;
+      interConnec[3] = globdat.copiesOf ( n2 )[1] ;
+      interConnec[4] = globdat.copiesOf ( p1 )[1] ; // midside node
+      interConnec[5] = globdat.copiesOf ( n1 )[1] ;
     }
   }
 }
@@ -1481,8 +1572,8 @@ void  addDiscreteInterface
     {
       bool val1;
 
-      double x1 = globdat.nodeSet[o1]->getX ();
-      double y1 = globdat.nodeSet[o1]->getY ();
+      double x1 = globdat.nodeSet.getX ( o1 );
+      double y1 = globdat.nodeSet.getY ( o1 );
 
       for ( int is = 0; is < globdat.segment.size(); is++ )
       {
@@ -1493,10 +1584,10 @@ void  addDiscreteInterface
       if ( val1  ) continue; // do not add interface on existing notch
     } 
     
-    interConnec[0] = globdat.duplicatedNodes0[index][0] ;
-    interConnec[1] = globdat.duplicatedNodes0[index][1] ;
+    interConnec[0] = globdat.copiesOf ( index )[0] ;
+    interConnec[1] = globdat.copiesOf ( index )[1] ;
          
-    globdat.interfaceSet.push_back ( ElemPointer ( new Element ( ieCount, interConnec ) ) );
+    globdat.interfaceSet.push_back ( globdat.elemArena.create<Element> ( globdat.interfaceStore, ieCount, interConnec ) );
        
     globdat.interfaceMats.push_back (0);
     ieCount++;
@@ -1519,7 +1610,8 @@ void   InterfaceBuilder::doFor2DMatInterfaceNURBS ( Global& globdat )
 
   ElemPointer      ep;
   
-  IntVector        connec, inodes0, edge1, edge2, edge3, edge4;
+  IntSpan          connec;
+  IntVector        inodes0, edge1, edge2, edge3, edge4;
   IntVector        interConnec;
   IntVector        interConnec1, interConnec2;
   vector< vector<int> > edges;
@@ -1536,7 +1628,7 @@ void   InterfaceBuilder::doFor2DMatInterfaceNURBS ( Global& globdat )
   {
      ep    = globdat.elemSet[ie];
 
-     ep->getConnectivity0 ( connec );
+     connec  = ep->getNodes0 ();
 
      numNode = connec.size ();
 
@@ -1760,8 +1852,8 @@ void   InterfaceBuilder::doFor2DMatInterfaceNURBS ( Global& globdat )
        o1 = globdat.nodeId2Position[n1];
        o2 = globdat.nodeId2Position[n2];
 
-       m1 = globdat.nodeSet[o1]->getDuplicity ();
-       m2 = globdat.nodeSet[o2]->getDuplicity ();
+       m1 = globdat.nodeSet.getDuplicity ( o1 );
+       m2 = globdat.nodeSet.getDuplicity ( o2 );
 
        // not a common edge, omits
 
@@ -1792,11 +1884,11 @@ void   InterfaceBuilder::doFor2DMatInterfaceNURBS ( Global& globdat )
        {
          bool val1, val2;
 
-         double x1 = globdat.nodeSet[o1]->getX ();
-         double y1 = globdat.nodeSet[o1]->getY ();
+         double x1 = globdat.nodeSet.getX ( o1 );
+         double y1 = globdat.nodeSet.getY ( o1 );
 
-         double x2 = globdat.nodeSet[o2]->getX ();
-         double y2 = globdat.nodeSet[o2]->getY ();
+         double x2 = globdat.nodeSet.getX ( o2 );
+         double y2 = globdat.nodeSet.getY ( o2 );
 
          for ( int is = 0; is < globdat.segment.size(); is++ )
          {
@@ -1821,7 +1913,7 @@ void   InterfaceBuilder::doFor2DMatInterfaceNURBS ( Global& globdat )
        if ( ss > 2 )
        {
          o1 = globdat.nodeId2Position[interConnec1[1]];
-         m1 = globdat.nodeSet[o1]->getDuplicity ();
+         m1 = globdat.nodeSet.getDuplicity ( o1 );
 	 if ( m1 == 0 || m1 == 1 ) continue;
        }
 
@@ -1834,28 +1926,28 @@ void   InterfaceBuilder::doFor2DMatInterfaceNURBS ( Global& globdat )
        //{
        //  for ( unsigned ii = ss; ii-- > 0 ; )
        //  {
-       //    interConnec.push_back (globdat.duplicatedNodes0[interConnec1[ii]][0]) ;
+       //    interConnec.push_back (globdat.copiesOf ( interConnec1[ii] )[0]) ;
        //  }
        //  
        //  for ( unsigned ii = ss; ii-- > 0 ; )
        //  {
-       //    interConnec.push_back (globdat.duplicatedNodes0[interConnec1[ii]][1]) ;
+       //    interConnec.push_back (globdat.copiesOf ( interConnec1[ii] )[1]) ;
        //  }
        //}
        //else
        //{
          for (int ii = 0; ii < ss; ii++)
          {
-           interConnec.push_back (globdat.duplicatedNodes0[interConnec1[ii]][0]) ;
+           interConnec.push_back (globdat.copiesOf ( interConnec1[ii] )[0]) ;
          }
          
          for (int ii = 0; ii < ss; ii++)
          {
-           interConnec.push_back (globdat.duplicatedNodes0[interConnec1[ii]][1]) ;
+           interConnec.push_back (globdat.copiesOf ( interConnec1[ii] )[1]) ;
          }
        //}
 
-       globdat.interfaceSet.push_back ( ElemPointer ( new Element ( ieCount, interConnec ) ) );
+       globdat.interfaceSet.push_back ( globdat.elemArena.create<Element> ( globdat.interfaceStore, ieCount, interConnec ) );
        
        globdat.interfaceMats.push_back (0);
        ieCount++;
@@ -1910,80 +2002,174 @@ void                     addInterface
     if ( !changed )
     {
       interConnec[0] = n1;
-      interConnec[1] = globdat.duplicatedNodes0[m12][0]; // midside node
+      interConnec[1] = globdat.copiesOf ( m12 )[0]; // midside node
       interConnec[2] = n2;
 
       interConnec[3] = p1;
-      interConnec[4] = globdat.duplicatedNodes0[m12][1]; // midside node
+      interConnec[4] = globdat.copiesOf ( m12 )[1]; // midside node
       interConnec[5] = p2;
     }
     else
     {
       //interConnec[0] = n2;
-      interConnec[1] = globdat.duplicatedNodes0[m12][0]; 
+      interConnec[1] = globdat.copiesOf ( m12 )[0]; 
       //interConnec[2] = n1;
 
       interConnec[3] = p2;
-      interConnec[4] = globdat.duplicatedNodes0[m12][1]; 
+      interConnec[4] = globdat.copiesOf ( m12 )[1]; 
       interConnec[5] = p1;
     }
   }
 }
 
+// ----------------------------------------------------------
+//    buildEdgeIndex
+// ----------------------------------------------------------
+
+// an edge carrying several line elements gets the tag of the first,
+// as a search of nodePairs would
+
+void                     buildEdgeIndex
+
+         ( EdgeIndex&         edges,
+	   const Global&      globdat )
+
+{
+  int          edge;
+
+  const int    pairCount = globdat.nodePairs.size ();
+
+  edges.clear   ();
+  edges.reserve ( pairCount );
+
+  for ( int ip = 0; ip < pairCount; ip++ )
+  {
+    const NodePair& np = globdat.nodePairs[ip];
+
+    edge = edges.insert ( np.node1, np.node2 );
+
+    if ( !edges.isOnBoundary ( edge ) )
+    {
+      edges.setBoundaryTag ( edge, globdat.bndElemsDomain[ip] );
+    }
+  }
+}
+
+// ----------------------------------------------------------
+//    buildFaceIndex
+// ----------------------------------------------------------
+
+/*
+ * Owners are added in the order of elemSet, which is the order in
+ * which the neighbor search over the (sorted) elemNeighbors found
+ * them.
+ */
+
+void                     buildFaceIndex
+
+         ( FaceIndex&         faces,
+	   const Global&      globdat,
+	   bool               modified )
+
+{
+  IntVector          face;
+
+  int                faceCount;
+
+  const int          elemCount = globdat.elemSet.size ();
+
+  faces.clear   ();
+  faces.reserve ( 3 * elemCount );
+
+  for ( int ie = 0; ie < elemCount; ie++ )
+  {
+    const ElemPointer& ep = globdat.elemSet[ie];
+
+    faceCount = ep->getFaceCount ();
+
+    for ( int jf = 0; jf < faceCount; jf++ )
+    {
+      if ( modified ) ep->getFace  ( jf ).get ( face );
+      else            ep->getFace0 ( jf ).get ( face );
+
+      faces.addOwner ( faces.insert ( face ), ie, jf );
+    }
+  }
+}
+
 // ----------------------------------------------------------
 //    findCommonEdge
 // ----------------------------------------------------------
 
-void                     findCommonEdge
+int                      findCommonEdge
 
          ( int&               p1,
 	   int&               p2,
+	   int&               p12,
 	   int                n1,
-	   int                n2,
 	   int                ielem,
-	   const IntVector&   neighbors,
-	   Global&            globdat )
+	   int                iedge,
+	   const Global&      globdat )
 
 {
-  IntVector                 jnodes, jnodes0;
-  IntVector::const_iterator it1, it2;
+  // the sides of 3D elements in the dual graph are faces
+
+  if ( iedge >= globdat.elemNeighbors.getSideCount ( ielem ) ) return -1;
+
+  const int  jelem = globdat.elemNeighbors.getNeighbor ( ielem, iedge );
+
+  if ( jelem == DualGraph::NONE ) return -1;
 
-  ElemPointer               jp;
+  const int  local = globdat.elemNeighbors.getNeighborSide ( ielem, iedge );
 
-  int                       jelem;
+  // the rows of elemStore are the elements of elemSet
 
-  const int                 neiCount = neighbors.size ();
+  const ElemStore& store   = globdat.elemStore;
+  const int*       jnodes0 = store.getConnectivity0 ( jelem );
+  const int*       jnodes  = store.getConnectivity  ( jelem );
+  const int        ncorner = globdat.elemSet[jelem]->getCornerCount ();
+  const int        next    = ( local + 1 ) % ncorner;
 
-  // loop over neighbors of element ie
+  // the edge may run the other way round in jelem
 
-  for ( int je = 0; je < neiCount; je++ )
+  if ( jnodes0[local] == n1 )
   {
-     jelem = globdat.elemId2Position[neighbors[je]];
-     jp    = globdat.elemSet[jelem];
+    p1 = jnodes[local];
+    p2 = jnodes[next];
+  }
+  else
+  {
+    p1 = jnodes[next];
+    p2 = jnodes[local];
+  }
 
-     // omit element being considered
+  // midside node, Gmsh numbering
 
-     if ( jp->getIndex() == ielem ) 
-     {
-       continue; 
-     }
+  if ( store.getNodeCount ( jelem ) > ncorner )
+  {
+    p12 = jnodes[ncorner + local];
+  }
 
-     jp->getCornerConnectivity  ( jnodes  );
-     jp->getCornerConnectivity0 ( jnodes0 );
+  return jelem;
+}
 
-     it1 = find ( jnodes0.begin(), jnodes0.end(), n1 );
-     it2 = find ( jnodes0.begin(), jnodes0.end(), n2 );
+// ----------------------------------------------------------
+//    copyOfNode
+// ----------------------------------------------------------
 
-     // common edge between ielem and jelem found
+int                      copyOfNode
 
-     if ( ( it1 != jnodes0.end() ) && 
-	  ( it2 != jnodes0.end() ) )
-     {
-       p1 = jnodes[it1 - jnodes0.begin()];
-       p2 = jnodes[it2 - jnodes0.begin()];
+         ( int                node,
+	   const Global&      globdat )
 
-       break; // only have ONE edge in common
-     }
+{
+  const IntSpan copies = globdat.copiesOf ( node );
+
+  if ( copies.size () < 2 )
+  {
+    cerr << "Interface node without a copy!!!\n";
+    exit(1);
   }
-}
 
+  return copies[1];
+}
@@ -11,6 +11,8 @@
 #include "typedefs.h"
 
 class Global;
+class EdgeIndex;
+class FaceIndex;
 
 class  InterfaceBuilder
 {
@@ -91,14 +93,44 @@ void                     addDiscreteInterface
 
          ( Global& globdat );
 
-void                     findCommonEdge
+// the edges of the boundary line elements (nodePairs) of a 2D mesh
+// with the tag (bndElemsDomain) of their line element
+
+void                     buildEdgeIndex
+
+         ( EdgeIndex&        edges,
+	   const Global&     globdat );
+
+// one pass over the faces of all elements of a 3D mesh, the faces
+// of the original mesh or, if modified, those of the torn mesh
+
+void                     buildFaceIndex
+
+         ( FaceIndex&        faces,
+	   const Global&     globdat,
+	   bool              modified );
+
+// the element across local edge iedge (n1,n2) of element ielem
+// (positions in elemSet) and the nodes that replace n1, n2 and the
+// midside node in it (modified mesh); -1 if the edge is on the
+// boundary, p1, p2 and p12 are then left unchanged
+
+int                      findCommonEdge
 
          ( int&              p1,
 	   int&              p2,
+	   int&              p12,
 	   int               n1,
-	   int               n2,
 	   int               ielem,
-	   const IntVector&  neighbors,
-	   Global&           globdat );
+	   int               iedge,
+	   const Global&     globdat );
+
+// the copy of interfacial node (id) made by the duplication; exits if
+// the node has none
+
+int                      copyOfNode
+
+         ( int               node,
+	   const Global&     globdat );
 
 #endif
@@ -1,7 +1,7 @@
 #include "InterfaceWriter.h"
 #include "Global.h"
 #include "Element.h"
-#include "Node.h"
+#include "NodeStore.h"
 
 // ---------------------------------------------------------
 //   writeInterface
@@ -34,8 +34,6 @@ void  writeInterface
 
   ElemPointer ep;
 
-  IntVector   connec;
-  IntVector   dupNodes;
 
   int         index;
   int         inter;
@@ -57,7 +55,7 @@ void  writeInterface
          << ep->getBulk1() << " " 
          << ep->getBulk2() << " ";
 
-    ep->getConnectivity ( connec );
+    const IntSpan connec = ep->getNodes ();
 
     copy ( connec.begin(), 
 	   connec.end(), 
@@ -71,24 +69,24 @@ void  writeInterface
 
   for ( int in = 0; in < inCount; in++ )
   {
-    index  = globdat.nodeSet[in]->getIndex ();
+    index  = globdat.nodeSet.getIndex ( in );
     inter  = 1;
 
-    if ( globdat.nodeSet[in]->getIsInterface () )
+    if ( globdat.nodeSet.getIsInterface ( in ) )
     {
       inter = 2;
     }
 
-    dupNodes = globdat.duplicatedNodes[index];
+    const IntSpan dupNodes = globdat.copiesOf ( index );
 
-    dupNodes.push_back ( inter );
-
-    if ( dupNodes.size () != 1 )
+    if ( !dupNodes.empty () )
     {
       copy ( dupNodes.begin(),
 	     dupNodes.end  (), 
 	     ostream_iterator<int> ( file, " " ) 
 	   );
+
+      file << inter << " ";
     }
     else
     {
@@ -98,7 +96,10 @@ void  writeInterface
     file << endl;
   }
 
-  if ( globdat.is3D )
+  // doForDomain builds edge elements, on a 3D mesh as well, and
+  // records no opposite vertices for them
+
+  if ( globdat.is3D && !globdat.oppositeVertices.empty () )
   {
     file << "OppositeVertices\n";
 
@@ -1,60 +1,60 @@
 #include "Global.h"
-#include "Node.h"
+#include "NodeStore.h"
 #include "Element.h"
+#include "MeshWriter.h"
 
 
+#include <sstream>
 #include <boost/algorithm/string.hpp>
 
 
 // =====================================================================
-//     writeJemMesh
+//     writeJemNodes_, writeJemElements_
 // =====================================================================
 
-void                     writeJemMesh 
+static void              writeJemNodes_
 
-    ( Global&     globdat,
-      const char* fileName )
+    ( const Global&  globdat,
+      ostream&       file )
 {
-  ofstream file ( fileName, std::ios::out );
-  
-  cout << "Writing nodes...\n";
-
   file << "<Nodes>\n";
 
   const int nodeCount    = globdat.newNodeSet.size   ();
-  const int elemCount    = globdat.elemSet.size      ();
-  const int bndElemCount = globdat.bndElementSet.size();
 
-  NodePointer np;
+  const NodeStore& nodes = globdat.newNodeSet;
 
   for ( int in = 0; in < nodeCount; in ++ )
   {
-    np = globdat.newNodeSet[in];
- 
     if ( !globdat.is3D )
     {
-      file << np->getIndex() 
-           << " " << np->getX() << " " << np->getY() << ";\n";
+      file << nodes.getIndex(in) 
+           << " " << nodes.getX(in) << " " << nodes.getY(in) << ";\n";
     }
     else
     {
-      file << np->getIndex() << " " 
-	   << np->getX() << " " 
-	   << np->getY() << " "
-	   << np->getZ() << ";\n";
+      file << nodes.getIndex(in) << " " 
+	   << nodes.getX(in) << " " 
+	   << nodes.getY(in) << " "
+	   << nodes.getZ(in) << ";\n";
     }
   }
 
   file << "</Nodes>\n";
+}
 
-  cout << "Writing nodes...done!\n\n";
+// opens the element block with the bulk elements
 
-  cout << "Writing bulk elements...\n";
+static void              writeJemElements_
+
+    ( const Global&  globdat,
+      ostream&       file )
+{
+  const int elemCount    = globdat.elemSet.size      ();
 
   file << "<Elements>\n";
 
   ElemPointer ep;
-  IntVector   connect, newConnect;
+  IntVector   connect;
 
   for ( int ie = 0; ie < elemCount; ie ++ )
   {
@@ -68,6 +68,53 @@ void                     writeJemMesh
 
     file << ";\n";
   }
+}
+
+// =====================================================================
+//     formatJemBulk
+// =====================================================================
+
+void                     formatJemBulk
+
+    ( const Global&  globdat,
+      string&        text )
+{
+  ostringstream out;
+
+  writeJemNodes_    ( globdat, out );
+  writeJemElements_ ( globdat, out );
+
+  text = out.str ();
+}
+
+// =====================================================================
+//     writeJemMesh
+// =====================================================================
+
+void                     writeJemMesh 
+
+    ( Global&        globdat,
+      const char*    fileName,
+      const string&  bulk )
+{
+  ofstream file ( fileName, std::ios::out );
+  
+  const int elemCount    = globdat.elemSet.size      ();
+  const int bndElemCount = globdat.bndElementSet.size();
+
+  ElemPointer ep;
+  IntVector   connect;
+
+  cout << "Writing nodes...\n";
+
+  if ( bulk.empty () ) writeJemNodes_ ( globdat, file );
+  else                 file << bulk;
+
+  cout << "Writing nodes...done!\n\n";
+
+  cout << "Writing bulk elements...\n";
+
+  if ( bulk.empty () ) writeJemElements_ ( globdat, file );
 
   cout << "Writing bulk elements...done!\n\n";
   cout << "Writing boundary elements...\n";
@@ -0,0 +1,53 @@
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "MappedFile.h"
+
+
+// ------------------------------------------------------------
+//    constructor
+// ------------------------------------------------------------
+
+MappedFile::MappedFile ( const char* fileName )
+
+  : data_(0), size_(0)
+{
+  int fd = open ( fileName, O_RDONLY );
+
+  if ( fd < 0 ) return;
+
+  struct stat st;
+
+  if ( fstat ( fd, &st ) == 0 && st.st_size > 0 )
+  {
+    void* p = mmap ( 0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+    if ( p != MAP_FAILED )
+    {
+      // the readers walk through the file once from front to back
+
+      madvise ( p, st.st_size, MADV_SEQUENTIAL );
+
+      data_ = static_cast<const char*> ( p );
+      size_ = st.st_size;
+    }
+  }
+
+  // the mapping stays valid after the descriptor is closed
+
+  close ( fd );
+}
+
+// ------------------------------------------------------------
+//    destructor
+// ------------------------------------------------------------
+
+MappedFile::~MappedFile ()
+{
+  if ( data_ )
+  {
+    munmap ( const_cast<char*>( data_ ), size_ );
+  }
+}
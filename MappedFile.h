@@ -0,0 +1,40 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+
+// =====================================================================
+//     class MappedFile
+// =====================================================================
+
+/*
+ * Read-only memory map of a whole file. The readers tokenize the
+ * mapped bytes in place, so a mesh file is never copied into strings.
+ * The map is released when the object goes out of scope.
+ */
+
+class MappedFile
+{
+  public:
+
+    explicit             MappedFile ( const char* fileName );
+
+                        ~MappedFile ();
+
+    bool                 isOpen () const { return data_ != 0; }
+    const char*          begin  () const { return data_; }
+    const char*          end    () const { return data_ + size_; }
+    size_t               size   () const { return size_; }
+
+  private:
+
+                         MappedFile ( const MappedFile& );
+    MappedFile&          operator = ( const MappedFile& );
+
+  private:
+
+    const char*          data_;
+    size_t               size_;
+};
+
+#endif
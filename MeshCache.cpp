@@ -0,0 +1,638 @@
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+#include "Global.h"
+#include "NodeStore.h"
+#include "Element.h"
+#include "MeshCache.h"
+#include "MappedFile.h"
+
+/*
+ * Layout of a cache file: a header followed by arrays. Every array is
+ * its element count (uint64) followed by the elements, padded to a
+ * multiple of 8 bytes so that all arrays are aligned in the mapped
+ * file and are read in place. Id maps are stored as their tables
+ * (with the first id) or as their hashed ids and values, maps and
+ * vectors of vectors in compressed row form (keys, offsets, values).
+ * All data has the byte order of the machine.
+ *
+ * The faces of 3D elements are not stored: they are a fixed function
+ * of the connectivity and are read from it when asked for.
+ */
+
+// bump when the layout or the meaning of the cached data changes
+
+static const uint32_t    CACHE_VERSION = 7;
+
+static const char        CACHE_MAGIC[8] = { 'I','E','C','A','C','H','E','\0' };
+
+struct CacheHeader
+{
+  char                   magic[8];
+  uint32_t               version;
+  uint32_t               options;     // options the snapshot depends on
+  char                   key[16];     // content hash of the mesh file
+};
+
+// nodeICount, stored in the snapshot, depends on --isContinuum
+
+static uint32_t          cacheOptions
+
+    ( const Global& globdat )
+{
+  return globdat.isContinuum ? 1 : 0;
+}
+
+// ---------------------------------------------------------------------
+//     class CacheWriter
+// ---------------------------------------------------------------------
+
+class CacheWriter
+{
+  public:
+
+    explicit       CacheWriter ( const char* fileName )
+
+      : file_(fileName, std::ios::out | std::ios::binary) {}
+
+    bool           good () const { return file_.good (); }
+
+    void           write ( const void* data, size_t bytes )
+    {
+      file_.write ( static_cast<const char*>( data ), bytes );
+    }
+
+    template <class T>
+    void           writeArray ( const T* data, size_t count )
+    {
+      static const char zeros[8] = { 0 };
+
+      uint64_t n = count;
+
+      write ( &n,   sizeof(n) );
+      write ( data, count * sizeof(T) );
+      write ( zeros, ( 8 - ( count * sizeof(T) ) % 8 ) % 8 );
+    }
+
+    void           writeInts ( const IntVector& v )
+    {
+      writeArray ( v.data(), v.size() );
+    }
+
+  private:
+
+    ofstream       file_;
+};
+
+// ---------------------------------------------------------------------
+//     class CacheReader
+// ---------------------------------------------------------------------
+
+// arrays are returned as pointers into the mapped file; a truncated
+// or damaged file makes ok() false instead of reading past the end
+
+class CacheReader
+{
+  public:
+
+                   CacheReader
+
+      ( const char*  first,
+        const char*  last )
+
+      : pos_(first), end_(last), ok_(true) {}
+
+    bool           ok () const { return ok_; }
+
+    template <class T>
+    const T*       readArray ( size_t& count )
+    {
+      uint64_t n = 0;
+
+      count = 0;
+
+      if ( !ok_ || end_ - pos_ < 8 ) return fail_<T> ();
+
+      memcpy ( &n, pos_, sizeof(n) );
+
+      const size_t bytes  = n * sizeof(T);
+      const size_t padded = ( bytes + 7 ) / 8 * 8;
+
+      if ( n > size_t( end_ - pos_ ) || size_t( end_ - pos_ - 8 ) < padded )
+      {
+        return fail_<T> ();
+      }
+
+      const T* data = reinterpret_cast<const T*>( pos_ + 8 );
+
+      pos_  += 8 + padded;
+      count  = n;
+
+      return data;
+    }
+
+    // offsets of a compressed row array with m-1 rows, k values
+
+    bool           checkOffsets
+
+      ( const int*   offsets,
+        size_t       m,
+        size_t       k )
+    {
+      if ( !ok_ || m == 0 || offsets[0] != 0 || size_t( offsets[m-1] ) != k )
+      {
+        return ok_ = false;
+      }
+
+      for ( size_t i = 1; i < m; i++ )
+      {
+        if ( offsets[i] < offsets[i-1] ) return ok_ = false;
+      }
+
+      return true;
+    }
+
+    void           readInts ( IntVector& v )
+    {
+      size_t     n;
+      const int* data = readArray<int> ( n );
+
+      v.assign ( data, data + n );
+    }
+
+  private:
+
+    template <class T>
+    const T*       fail_ ()
+    {
+      ok_ = false;
+      return 0;
+    }
+
+  private:
+
+    const char*    pos_;
+    const char*    end_;
+    bool           ok_;
+};
+
+static bool              cacheDamaged
+
+    ( const Global& globdat )
+{
+  cout << "mesh cache " << globdat.cacheFile << " is damaged\n\n";
+
+  return false;
+}
+
+// ---------------------------------------------------------------------
+//     maps and vectors of vectors
+// ---------------------------------------------------------------------
+
+// the flat table with its base id, then the hashed ids and values
+
+static void              writeIdMap
+
+    ( CacheWriter&       out,
+      const IdMap&       map )
+{
+  IntVector base ( 1, map.base () ), ids, values;
+
+  map.getHashed ( ids, values );
+
+  out.writeInts ( base        );
+  out.writeInts ( map.table () );
+  out.writeInts ( ids         );
+  out.writeInts ( values      );
+}
+
+static void              readIdMap
+
+    ( CacheReader&       in,
+      IdMap&             map )
+{
+  size_t     k, n, m, l;
+  const int* base   = in.readArray<int> ( k );
+  const int* table  = in.readArray<int> ( n );
+  const int* ids    = in.readArray<int> ( m );
+  const int* values = in.readArray<int> ( l );
+
+  map.clear ();
+
+  if      ( k != 1 || m != l )
+  {
+    return;
+  }
+  else if ( m > 0 )
+  {
+    map.assign ( ids, values, int( m ) );
+  }
+  else
+  {
+    map.assign ( base[0], table, table + n );
+  }
+}
+
+// Int2IntVectMap and Int2IntSetMap
+
+template <class Map>
+static void              writeMultiMap
+
+    ( CacheWriter&       out,
+      const Map&         map )
+{
+  IntVector keys, offsets ( 1, 0 ), values;
+
+  for ( typename Map::const_iterator it = map.begin (); it != map.end (); ++it )
+  {
+    keys  .push_back ( it->first );
+    values.insert    ( values.end(), it->second.begin(), it->second.end() );
+    offsets.push_back ( values.size () );
+  }
+
+  out.writeInts ( keys    );
+  out.writeInts ( offsets );
+  out.writeInts ( values  );
+}
+
+template <class Map>
+static void              readMultiMap
+
+    ( CacheReader&       in,
+      Map&               map )
+{
+  size_t     n, m, k;
+  const int* keys    = in.readArray<int> ( n );
+  const int* offsets = in.readArray<int> ( m );
+  const int* values  = in.readArray<int> ( k );
+
+  map.clear ();
+
+  if ( m != n + 1 || !in.checkOffsets ( offsets, m, k ) ) return;
+
+  for ( size_t i = 0; i < n; i++ )
+  {
+    typename Map::mapped_type row ( values + offsets[i], values + offsets[i+1] );
+
+    map.insert ( map.end (), typename Map::value_type ( keys[i], row ) );
+  }
+}
+
+static void              writeAdjacency
+
+    ( CacheWriter&       out,
+      const Adjacency&   adj )
+{
+  out.writeInts ( adj.getOffsets () );
+  out.writeInts ( adj.getValues  () );
+}
+
+static void              readAdjacency
+
+    ( CacheReader&       in,
+      Adjacency&         adj )
+{
+  size_t     m, k;
+  const int* offsets = in.readArray<int> ( m );
+  const int* values  = in.readArray<int> ( k );
+
+  adj.clear ();
+
+  if ( m > 0 && in.checkOffsets ( offsets, m, k ) )
+  {
+    adj.assign ( offsets, m - 1, values );
+  }
+}
+
+static void              writeDualGraph
+
+    ( CacheWriter&       out,
+      const DualGraph&   graph )
+{
+  const vector<unsigned char>& sides = graph.getSides ();
+
+  out.writeInts  ( graph.getOffsets   () );
+  out.writeInts  ( graph.getNeighbors () );
+  out.writeArray ( sides.data (), sides.size () );
+}
+
+static void              readDualGraph
+
+    ( CacheReader&       in,
+      DualGraph&         graph )
+{
+  size_t               m, k, l;
+  const int*           offsets   = in.readArray<int>           ( m );
+  const int*           neighbors = in.readArray<int>           ( k );
+  const unsigned char* sides     = in.readArray<unsigned char> ( l );
+
+  graph.clear ();
+
+  if ( m > 0 && l == k && in.checkOffsets ( offsets, m, k ) )
+  {
+    graph.assign ( offsets, m - 1, neighbors, sides );
+  }
+}
+
+// =====================================================================
+//     hashMeshFile
+// =====================================================================
+
+std::string              hashMeshFile
+
+    ( const char* fileName )
+{
+  MappedFile file ( fileName );
+
+  if ( !file.isOpen () ) return "";
+
+  const uint64_t MUL  = 0xFF51AFD7ED558CCDULL;
+
+  const char*    p    = file.begin ();
+  size_t         left = file.size  ();
+  uint64_t       hash = 0x9E3779B97F4A7C15ULL ^ left;
+  uint64_t       word;
+
+  // eight bytes at a time, the tail padded with zeros
+
+  for ( ; left > 0; p += 8, left -= min<size_t> ( left, 8 ) )
+  {
+    word = 0;
+
+    memcpy ( &word, p, min<size_t> ( left, 8 ) );
+
+    hash  = ( hash ^ word ) * MUL;
+    hash ^= hash >> 32;
+  }
+
+  hash ^= hash >> 33;
+  hash *= 0xC4CEB9FE1A85EC53ULL;
+  hash ^= hash >> 33;
+
+  char key[17];
+
+  snprintf ( key, sizeof(key), "%016llx", (unsigned long long) hash );
+
+  return key;
+}
+
+// =====================================================================
+//     saveMeshCache
+// =====================================================================
+
+void                     saveMeshCache
+
+    ( const Global& globdat )
+{
+  if ( globdat.cacheKey.size () != 16 ) return;
+
+  cout << "writing mesh cache " << globdat.cacheFile << "...\n";
+
+  // write to a temporary file, so that a run that is interrupted
+  // never leaves a damaged cache behind
+
+  const string tmpFile = globdat.cacheFile + ".tmp";
+
+  CacheWriter  out ( tmpFile.c_str () );
+
+  CacheHeader  header;
+
+  memcpy ( header.magic, CACHE_MAGIC, sizeof(header.magic) );
+  memcpy ( header.key,   globdat.cacheKey.data(), sizeof(header.key) );
+
+  header.version = CACHE_VERSION;
+  header.options = cacheOptions ( globdat );
+
+  out.write ( &header, sizeof(header) );
+
+  // flags and counts found by the reader
+
+  IntVector scalars ( 6 );
+
+  const int elemCount = globdat.elemSet.size ();
+
+  scalars[0] = globdat.is3D;
+  scalars[1] = globdat.isQuadratic;
+  scalars[2] = globdat.isNURBS;
+  scalars[3] = elemCount > 0 && globdat.elemSet[0]->getIsNURBS ();
+  scalars[4] = globdat.nodeElemCount;
+  scalars[5] = globdat.nodeICount;
+
+  out.writeInts ( scalars );
+
+  // nodes, column by column
+
+  const NodeStore& nodes = globdat.nodeSet;
+
+  out.writeInts  ( nodes.getIndices () );
+  out.writeArray ( nodes.getXs().data(), nodes.getXs().size() );
+  out.writeArray ( nodes.getYs().data(), nodes.getYs().size() );
+  out.writeArray ( nodes.getZs().data(), nodes.getZs().size() );
+
+  // elements: the rows of elemStore, which holds exactly the
+  // elements of elemSet in the same order
+
+  const ElemStore& elems = globdat.elemStore;
+
+  IntVector types ( elemCount );
+
+  for ( int ie = 0; ie < elemCount; ie++ )
+  {
+    types[ie] = elems.getElemType ( ie );
+  }
+
+  out.writeInts ( elems.getIndices         () );
+  out.writeInts ( types                       );
+  out.writeInts ( elems.getOffsets         () );
+  out.writeInts ( elems.getConnectivities0 () );
+
+  // mesh data
+
+  writeIdMap    ( out, globdat.nodeId2Position );
+  writeIdMap    ( out, globdat.elemId2Position );
+  writeIdMap    ( out, globdat.elem2Domain     );
+  writeMultiMap ( out, globdat.dom2Elems       );
+  writeMultiMap ( out, globdat.bndNodesMap     );
+
+  IntVector bndNodes ( globdat.boundaryNodes.begin(), globdat.boundaryNodes.end() );
+  IntVector pairs;
+
+  for ( size_t ip = 0; ip < globdat.nodePairs.size (); ip++ )
+  {
+    pairs.push_back ( globdat.nodePairs[ip].node1 );
+    pairs.push_back ( globdat.nodePairs[ip].node2 );
+  }
+
+  out.writeInts ( bndNodes               );
+  out.writeInts ( pairs                  );
+  out.writeInts ( globdat.bndElemsDomain );
+  out.writeInts ( globdat.isolatedNodes  );
+
+  // topology
+
+  writeAdjacency ( out, globdat.nodeSupport   );
+  writeDualGraph ( out, globdat.elemNeighbors );
+
+  if ( !out.good () ||
+       rename ( tmpFile.c_str (), globdat.cacheFile.c_str () ) != 0 )
+  {
+    cerr << "unable to write the mesh cache " << globdat.cacheFile << "\n";
+    remove ( tmpFile.c_str () );
+    return;
+  }
+
+  cout << "writing mesh cache...done!\n\n";
+}
+
+// =====================================================================
+//     loadMeshCache
+// =====================================================================
+
+bool                     loadMeshCache
+
+    ( Global&     globdat )
+{
+  MappedFile   file ( globdat.cacheFile.c_str () );
+
+  CacheHeader  header;
+
+  if ( !file.isOpen () || file.size () < sizeof(header) ) return false;
+
+  memcpy ( &header, file.begin (), sizeof(header) );
+
+  if ( memcmp ( header.magic, CACHE_MAGIC, sizeof(header.magic) ) != 0 ||
+       header.version != CACHE_VERSION                                 ||
+       header.options != cacheOptions ( globdat )                      ||
+       globdat.cacheKey.size () != 16                                  ||
+       memcmp ( header.key, globdat.cacheKey.data(), sizeof(header.key) ) != 0 )
+  {
+    cout << "mesh cache " << globdat.cacheFile << " is out of date\n\n";
+    return false;
+  }
+
+  cout << "Reading mesh cache " << globdat.cacheFile << "...\n";
+
+  CacheReader  in ( file.begin () + sizeof(header), file.end () );
+
+  Global       cached;
+
+  size_t       n, m, k;
+
+  IntVector    scalars;
+
+  in.readInts ( scalars );
+
+  if ( scalars.size () != 6 ) return cacheDamaged ( globdat );
+
+  // nodes
+
+  const int*    ids = in.readArray<int>    ( n );
+  const double* xs  = in.readArray<double> ( m );
+  const double* ys  = in.readArray<double> ( k );
+
+  if ( !in.ok () || m != n || k != n ) return cacheDamaged ( globdat );
+
+  const double* zs  = in.readArray<double> ( m );
+
+  if ( !in.ok () || m != n ) return cacheDamaged ( globdat );
+
+  cached.nodeSet.reserve ( n );
+
+  for ( size_t in = 0; in < n; in++ )
+  {
+    cached.nodeSet.add ( xs[in], ys[in], zs[in], ids[in] );
+  }
+
+  // elements
+
+  const int*   indices      = in.readArray<int> ( n );
+  const int*   types        = in.readArray<int> ( m );
+
+  if ( m != n ) return cacheDamaged ( globdat );
+
+  const int*   offsets      = in.readArray<int> ( m );
+  const int*   connectivity = in.readArray<int> ( k );
+
+  if ( !in.checkOffsets ( offsets, m, k ) || m != n + 1 )
+  {
+    return cacheDamaged ( globdat );
+  }
+
+  const size_t elemCount = n;
+
+  // mesh data
+
+  readIdMap    ( in, cached.nodeId2Position );
+  readIdMap    ( in, cached.elemId2Position );
+  readIdMap    ( in, cached.elem2Domain     );
+  readMultiMap ( in, cached.dom2Elems       );
+  readMultiMap ( in, cached.bndNodesMap     );
+
+  IntVector bndNodes, pairs;
+
+  in.readInts ( bndNodes );
+  in.readInts ( pairs    );
+
+  cached.boundaryNodes.insert ( bndNodes.begin(), bndNodes.end() );
+
+  for ( size_t ip = 0; ip + 1 < pairs.size (); ip += 2 )
+  {
+    cached.nodePairs.push_back ( NodePair ( pairs[ip], pairs[ip+1] ) );
+  }
+
+  in.readInts ( cached.bndElemsDomain );
+  in.readInts ( cached.isolatedNodes  );
+
+  // topology
+
+  readAdjacency ( in, cached.nodeSupport   );
+  readDualGraph ( in, cached.elemNeighbors );
+
+  if ( !in.ok () ) return cacheDamaged ( globdat );
+
+  // all went well: move the data into globdat. The elements are
+  // created last since they refer to globdat.elemStore.
+
+  IntVector    connec;
+
+  globdat.elemStore.clear   ();
+  globdat.elemStore.reserve ( elemCount, offsets[elemCount] );
+  globdat.elemSet  .clear   ();
+  globdat.elemSet  .reserve ( elemCount );
+
+  for ( size_t ie = 0; ie < elemCount; ie++ )
+  {
+    connec.assign ( connectivity + offsets[ie], connectivity + offsets[ie+1] );
+
+    ElemPointer ep = globdat.elemArena.create<Element>
+      ( globdat.elemStore, indices[ie], types[ie], connec );
+
+    if ( scalars[3] ) ep->setNURBS ();
+
+    globdat.elemSet.push_back ( ep );
+  }
+
+  globdat.nodeSet        .swap ( cached.nodeSet         );
+  globdat.nodeId2Position.swap ( cached.nodeId2Position );
+  globdat.elemId2Position.swap ( cached.elemId2Position );
+  globdat.elem2Domain    .swap ( cached.elem2Domain     );
+  globdat.dom2Elems      .swap ( cached.dom2Elems       );
+  globdat.bndNodesMap    .swap ( cached.bndNodesMap     );
+  globdat.boundaryNodes  .swap ( cached.boundaryNodes   );
+  globdat.nodePairs      .swap ( cached.nodePairs       );
+  globdat.bndElemsDomain .swap ( cached.bndElemsDomain  );
+  globdat.isolatedNodes  .swap ( cached.isolatedNodes   );
+  globdat.nodeSupport    .swap ( cached.nodeSupport     );
+  globdat.elemNeighbors  .swap ( cached.elemNeighbors   );
+
+  globdat.is3D           = scalars[0];
+  globdat.isQuadratic    = scalars[1];
+  globdat.isNURBS        = scalars[2];
+  globdat.nodeElemCount  = scalars[4];
+  globdat.nodeICount     = scalars[5];
+
+  cout << "Reading mesh cache...done!\n\n";
+
+  return true;
+}
@@ -0,0 +1,32 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <string>
+
+class Global;
+
+/*
+ * Binary snapshot of the mesh (everything readMesh fills) and of its
+ * topology (node support and element neighbors), option --cache.
+ * The file is keyed by a content hash of the mesh file and the options
+ * the snapshot depends on; it is memory mapped when loaded.
+ */
+
+// content hash of a file as 16 hex digits, "" if it cannot be read
+
+std::string              hashMeshFile
+
+    ( const char* fileName );
+
+// loads globdat.cacheFile if it was written for the mesh content
+// globdat.cacheKey with the same options, returns false otherwise
+
+bool                     loadMeshCache
+
+    ( Global&     globdat );
+
+void                     saveMeshCache
+
+    ( const Global& globdat );
+
+#endif
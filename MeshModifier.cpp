@@ -1,7 +1,761 @@
 #include "MeshModifier.h"
+#include "MeshCache.h"
 #include "Global.h"
-#include "Node.h"
+#include "NodeStore.h"
 #include "Element.h"
+#include "Parallel.h"
+
+// ---------------------------------------------------------------------
+//     work done by the threads
+// ---------------------------------------------------------------------
+
+typedef vector< std::atomic<int> >  AtomicIntVector;
+
+// counts the elements around each node
+
+class CountSupport
+{
+  public:
+
+                   CountSupport
+
+      ( const ElemStore&   store,
+        const IdMap&       position,
+        AtomicIntVector&   counts )
+
+      : store_(store), position_(position), counts_(counts) {}
+
+    void           operator () ( int ic )
+    {
+      const int last = chunkEnd ( ic, store_.size () );
+
+      for ( int ie = ic * CHUNK_SIZE; ie < last; ie++ )
+      {
+        const int* inodes = store_.getConnectivity ( ie );
+        const int  nnode  = store_.getNodeCount    ( ie );
+
+        for ( int in = 0; in < nnode; in++ )
+        {
+          counts_[position_[inodes[in]]]++;
+        }
+      }
+    }
+
+  private:
+
+    const ElemStore&   store_;
+    const IdMap&       position_;
+    AtomicIntVector&   counts_;
+};
+
+// puts the element positions at the next free place of their nodes
+
+class FillSupport
+{
+  public:
+
+                   FillSupport
+
+      ( const ElemStore&   store,
+        const IdMap&       position,
+        AtomicIntVector&   next,
+        IntVector&         values )
+
+      : store_(store), position_(position), next_(next), values_(values) {}
+
+    void           operator () ( int ic )
+    {
+      const int last = chunkEnd ( ic, store_.size () );
+
+      for ( int ie = ic * CHUNK_SIZE; ie < last; ie++ )
+      {
+        const int* inodes = store_.getConnectivity ( ie );
+        const int  nnode  = store_.getNodeCount    ( ie );
+
+        for ( int in = 0; in < nnode; in++ )
+        {
+          values_[next_[position_[inodes[in]]]++] = ie;
+        }
+      }
+    }
+
+  private:
+
+    const ElemStore&   store_;
+    const IdMap&       position_;
+    AtomicIntVector&   next_;
+    IntVector&         values_;
+};
+
+// sorts the positions of each row, then replaces them by element ids
+
+class SortSupport
+{
+  public:
+
+                   SortSupport
+
+      ( const ElemStore&   store,
+        const IntVector&   offsets,
+        IntVector&         values )
+
+      : store_(store), offsets_(offsets), values_(values) {}
+
+    void           operator () ( int ic )
+    {
+      const int rowCount = offsets_.size () - 1;
+      const int last     = chunkEnd ( ic, rowCount );
+
+      int*      row      = values_.data ();
+
+      for ( int in = ic * CHUNK_SIZE; in < last; in++ )
+      {
+        sort ( row + offsets_[in], row + offsets_[in+1] );
+
+        for ( int j = offsets_[in]; j < offsets_[in+1]; j++ )
+        {
+          row[j] = store_.getIndex ( row[j] );
+        }
+      }
+    }
+
+  private:
+
+    const ElemStore&   store_;
+    const IntVector&   offsets_;
+    IntVector&         values_;
+};
+
+// number of sides of each element: corner edges in 2D, faces in 3D
+
+class CountSides
+{
+  public:
+
+                   CountSides ( Global& globdat ) : globdat_(globdat) {}
+
+    void           operator () ( int ic )
+    {
+      const int         last = chunkEnd ( ic, int( globdat_.elemSet.size () ) );
+
+      for ( int ie = ic * CHUNK_SIZE; ie < last; ie++ )
+      {
+        const ElemPointer& ep = globdat_.elemSet[ie];
+
+        if ( globdat_.is3D )
+        {
+          globdat_.elemNeighbors.setSideCount ( ie, ep->getFaceCount () );
+        }
+        else
+        {
+          globdat_.elemNeighbors.setSideCount ( ie, ep->getCornerCount () );
+        }
+      }
+    }
+
+  private:
+
+    Global&            globdat_;
+};
+
+// the element across each side and the local side number there;
+// candidates are the elements around the first corner of the side,
+// taken in the order of elemSet
+
+class FindNeighbors
+{
+  public:
+
+                   FindNeighbors ( Global& globdat ) : globdat_(globdat) {}
+
+    void           operator () ( int ic )
+    {
+      const ElemStore&  store = globdat_.elemStore;
+      const int         last  = chunkEnd ( ic, store.size () );
+
+      IntVector         face;
+
+      for ( int ie = ic * CHUNK_SIZE; ie < last; ie++ )
+      {
+        if ( globdat_.is3D )
+        {
+          const ElemPointer& ep = globdat_.elemSet[ie];
+
+          for ( int jf = 0; jf < ep->getFaceCount (); jf++ )
+          {
+            ep->getFace0 ( jf ).get ( face );
+
+            sort ( face.begin (), face.end () );
+
+            linkSide_ ( ie, jf, face[0], face.data (), face.size () );
+          }
+        }
+        else
+        {
+          const int* inodes  = store.getConnectivity0 ( ie );
+          const int  ncorner = globdat_.elemSet[ie]->getCornerCount ();
+
+          for ( int in = 0; in < ncorner; in++ )
+          {
+            const int edge[2] = { inodes[in], inodes[(in+1) % ncorner] };
+
+            linkSide_ ( ie, in, edge[0], edge, 2 );
+          }
+        }
+      }
+    }
+
+  private:
+
+    void           linkSide_
+
+      ( int                ie,
+        int                side,
+        int                corner,
+        const int*         nodes,
+        int                nodeCount ) const
+    {
+      const IntSpan support = globdat_.supportOf ( corner );
+
+      int           je, jside;
+
+      for ( int is = 0; is < support.size (); is++ )
+      {
+        je = globdat_.elemId2Position[support[is]];
+
+        if ( je == ie ) continue;
+
+        jside = globdat_.is3D ? findFace_ ( je, nodes, nodeCount )
+                              : findEdge_ ( je, nodes[0], nodes[1] );
+
+        if ( jside != DualGraph::NONE )
+        {
+          globdat_.elemNeighbors.setNeighbor ( ie, side, je, jside );
+          return;
+        }
+      }
+    }
+
+    // local corner edge n1-n2 (either way round) of element je
+
+    int            findEdge_
+
+      ( int                je,
+        int                n1,
+        int                n2 ) const
+    {
+      const int* jnodes  = globdat_.elemStore.getConnectivity0 ( je );
+      const int  ncorner = globdat_.elemSet[je]->getCornerCount ();
+
+      for ( int in = 0; in < ncorner; in++ )
+      {
+        const int m1 = jnodes[in];
+        const int m2 = jnodes[(in+1) % ncorner];
+
+        if ( ( m1 == n1 && m2 == n2 ) || ( m1 == n2 && m2 == n1 ) )
+        {
+          return in;
+        }
+      }
+
+      return DualGraph::NONE;
+    }
+
+    // local face of element je with the sorted corners nodes
+
+    int            findFace_
+
+      ( int                je,
+        const int*         nodes,
+        int                nodeCount ) const
+    {
+      const int* jnodes = globdat_.elemStore.getConnectivity0 ( je );
+      const int  jcount = globdat_.elemStore.getNodeCount     ( je );
+
+      // most candidates do not have all the corners
+
+      for ( int in = 1; in < nodeCount; in++ )
+      {
+        if ( find ( jnodes, jnodes + jcount, nodes[in] ) == jnodes + jcount )
+        {
+          return DualGraph::NONE;
+        }
+      }
+
+      const ElemPointer& jp = globdat_.elemSet[je];
+
+      IntVector          face;
+
+      for ( int jf = 0; jf < jp->getFaceCount (); jf++ )
+      {
+        const FaceView view = jp->getFace0 ( jf );
+
+        if ( view.size () != nodeCount ) continue;
+
+        view.get ( face );
+
+        sort ( face.begin (), face.end () );
+
+        if ( equal ( face.begin (), face.end (), nodes ) ) return jf;
+      }
+
+      return DualGraph::NONE;
+    }
+
+  private:
+
+    Global&            globdat_;
+};
+
+// ---------------------------------------------------------------------
+//     duplication and tearing, done by the threads
+// ---------------------------------------------------------------------
+
+// number of copies of each node, -1 if the node is not duplicated at
+// all (no entry in duplicatedNodes)
+
+class CountCopies
+{
+  public:
+
+                   CountCopies
+
+      ( const Global&      globdat,
+        IntVector&         copies )
+
+      : globdat_(globdat), copies_(copies) {}
+
+    void           operator () ( int ic )
+    {
+      const NodeStore& nodes = globdat_.nodeSet;
+      const int        last  = chunkEnd ( ic, nodes.size () );
+
+      for ( int in = ic * CHUNK_SIZE; in < last; in++ )
+      {
+        copies_[in] = -1;
+
+        // if only generate interface elements along material
+        // interfaces, then ignore nodes which are not interfacial
+
+        if ( ( globdat_.isInterface || globdat_.isPolycrystal ) &&
+             !nodes.getIsInterface ( in ) )
+        {
+          continue;
+        }
+
+        // no interface elements in rigid domain then
+        // not duplicate nodes that are defined rigid.
+
+        if ( globdat_.isDomain && nodes.getIsRigid ( in ) ) continue;
+
+        const int duplicity = nodes.getDuplicity ( in );
+
+        if ( duplicity == 1 ) continue;  // ignore nodes belong to only ONE element
+
+        copies_[in] = max ( duplicity - 1, 0 );
+      }
+    }
+
+  private:
+
+    const Global&      globdat_;
+    IntVector&         copies_;
+};
+
+// the copies of each node, numbered after all original nodes: the
+// copies get the ids lastId+1,...
+
+class AddCopies
+{
+  public:
+
+                   AddCopies
+
+      ( Global&            globdat,
+        const IntVector&   copies,
+        const IntVector&   first,
+        int                lastId )
+
+      : globdat_(globdat), copies_(copies), first_(first), lastId_(lastId) {}
+
+    void           operator () ( int ic )
+    {
+      const NodeStore& nodes     = globdat_.nodeSet;
+      const int        nodeCount = nodes.size ();
+      const int        last      = chunkEnd ( ic, nodeCount );
+
+      for ( int in = ic * CHUNK_SIZE; in < last; in++ )
+      {
+        for ( int id = 0; id < copies_[in]; id++ )
+        {
+          const int jn = nodeCount + first_[in] + id;
+
+          globdat_.newNodeSet.set ( jn, nodes.getX ( in ), nodes.getY ( in ),
+                                    nodes.getZ ( in ),
+                                    lastId_ + first_[in] + id + 1 );
+        }
+      }
+    }
+
+  private:
+
+    Global&            globdat_;
+    const IntVector&   copies_;
+    const IntVector&   first_;
+    int                lastId_;
+};
+
+// the node each element of the support of a node gets when the mesh
+// is torn, one entry per entry of nodeSupport. The first change of an
+// entry wins, as replacing a node in a connectivity does nothing once
+// it has been replaced.
+
+class TornIds
+{
+  public:
+
+    static const int   NONE = -1;    // the node itself
+
+                   TornIds ( const Global& globdat )
+
+      : offsets_ ( globdat.nodeSupport.getOffsets () ),
+        ids_     ( globdat.nodeSupport.getValues ().size (), int( NONE ) ) {}
+
+    // element number slot of the support of the node at position in,
+    // inode is its id
+
+    inline void    change
+
+      ( int                in,
+        int                inode,
+        int                slot,
+        int                newId )
+    {
+      int& id = ids_[offsets_[in] + slot];
+
+      if ( id == NONE || id == inode ) id = newId;
+    }
+
+    inline int     get
+
+      ( int                in,
+        int                slot ) const
+    {
+      return ids_[offsets_[in] + slot];
+    }
+
+  private:
+
+    const IntVector&   offsets_;
+    IntVector          ids_;
+};
+
+// nodes on material interfaces (interfaceNodes[in])
+
+class TearInterfaceNode
+{
+  public:
+
+                   TearInterfaceNode
+
+      ( const Global&      globdat,
+        TornIds&           torn )
+
+      : globdat_(globdat), torn_(torn) {}
+
+    void           operator () ( int in )
+    {
+      const int     inode     = globdat_.interfaceNodes[in];
+      const int     jn        = globdat_.nodeId2Position[inode];
+      const IntSpan support   = globdat_.nodeSupport[jn];
+      const int     suppCount = support.size ();
+      const int     mat       = globdat_.elem2Domain[support[0]];
+
+      // loop over support of this node
+
+      for ( int ie = 1; ie < suppCount; ie++ )
+      {
+        if ( globdat_.elem2Domain[support[ie]] == mat ) continue;
+
+        torn_.change ( jn, inode, ie, globdat_.duplicatedNodes[jn][1] );
+      }
+    }
+
+  private:
+
+    const Global&      globdat_;
+    TornIds&           torn_;
+};
+
+// all nodes outside the rigid domain (nodeSet position in)
+
+class TearDomainNode
+{
+  public:
+
+                   TearDomainNode
+
+      ( const Global&      globdat,
+        TornIds&           torn )
+
+      : globdat_(globdat), torn_(torn) {}
+
+    void           operator () ( int in )
+    {
+      const NodeStore& nodes = globdat_.nodeSet;
+
+      // ignore nodes in rigid domain
+
+      if ( nodes.getIsRigid ( in ) ) return;
+
+      const int     inode     = nodes.getIndex ( in );
+      const IntSpan support   = globdat_.nodeSupport[in];
+      const int     suppCount = support.size ();
+
+      // different treatment for interfacial nodes
+
+      if ( nodes.getIsInterface ( in ) )
+      {
+        int c = 0;
+
+        for ( int ie = 0; ie < suppCount; ie++ )
+        {
+          if ( globdat_.elem2Domain[support[ie]] == globdat_.rigidDomain )
+          {
+            continue;
+          }
+
+          torn_.change ( in, inode, ie, globdat_.duplicatedNodes[in][1+c] );
+          c++;
+        }
+
+        return;
+      }
+
+      // first element in the support keeps the original connectivity
+
+      for ( int ie = 1; ie < suppCount; ie++ )
+      {
+        torn_.change ( in, inode, ie, globdat_.duplicatedNodes[in][ie] );
+      }
+    }
+
+  private:
+
+    const Global&      globdat_;
+    TornIds&           torn_;
+};
+
+// all nodes (nodeSet position in)
+
+class TearAllNode
+{
+  public:
+
+                   TearAllNode
+
+      ( const Global&      globdat,
+        TornIds&           torn )
+
+      : globdat_(globdat), torn_(torn) {}
+
+    void           operator () ( int in )
+    {
+      const int     inode     = globdat_.nodeSet.getIndex ( in );
+      const IntSpan support   = globdat_.nodeSupport[in];
+      const int     suppCount = support.size ();
+
+      // first element in the support keeps the original connectivity
+
+      for ( int ie = 1; ie < suppCount; ie++ )
+      {
+        torn_.change ( in, inode, ie, globdat_.duplicatedNodes[in][ie] );
+      }
+    }
+
+  private:
+
+    const Global&      globdat_;
+    TornIds&           torn_;
+};
+
+// nodes on grain boundaries (interfaceNodes[in])
+
+class TearPolycrystalNode
+{
+  public:
+
+                   TearPolycrystalNode
+
+      ( const Global&      globdat,
+        TornIds&           torn )
+
+      : globdat_(globdat), torn_(torn) {}
+
+    void           operator () ( int in )
+    {
+      const int     inode     = globdat_.interfaceNodes[in];
+      const int     jn        = globdat_.nodeId2Position[inode];
+      const IntSpan support   = globdat_.nodeSupport[jn];
+      const int     suppCount = support.size ();
+      const int     matCount  = globdat_.nodeSet.getDuplicity ( jn );
+
+      int           imat;
+
+      if ( matCount == 2 ) // node between 2 intergrnular boundaries
+      {
+        // first element in the support is kept unchanded
+
+        const int mat = globdat_.elem2Domain[support[0]];
+
+        for ( int ie = 1; ie < suppCount; ie++ )
+        {
+          if ( globdat_.elem2Domain[support[ie]] == mat ) continue;
+
+          torn_.change ( jn, inode, ie, globdat_.duplicatedNodes[jn][1] );
+        }
+      }
+      else // nodes at the junction with 3 materials
+      {
+        int       jj = 0;
+
+        IntVector doneNodes;
+
+        for ( int ie = 0; ie < suppCount; ie++ )
+        {
+          if ( find ( doneNodes.begin(),
+                      doneNodes.end  (), ie ) != doneNodes.end () )
+          {
+            continue;
+          }
+
+          imat = globdat_.elem2Domain[support[ie]];
+
+          for ( int je = ie; je < suppCount; je++ )
+          {
+            if ( globdat_.elem2Domain[support[je]] != imat ) continue;
+
+            torn_.change ( jn, inode, je, globdat_.duplicatedNodes[jn][jj] );
+
+            doneNodes.push_back ( ie );
+            doneNodes.push_back ( je );
+          }
+
+          jj++;
+        }
+      }
+    }
+
+  private:
+
+    const Global&      globdat_;
+    TornIds&           torn_;
+};
+
+// calls tearNode for the nodes of chunk ic
+
+template <class TearNode>
+class TearChunk
+{
+  public:
+
+                   TearChunk
+
+      ( TearNode&          tearNode,
+        int                count )
+
+      : tearNode_(tearNode), count_(count) {}
+
+    void           operator () ( int ic )
+    {
+      const int last = chunkEnd ( ic, count_ );
+
+      for ( int in = ic * CHUNK_SIZE; in < last; in++ )
+      {
+        tearNode_ ( in );
+      }
+    }
+
+  private:
+
+    TearNode&          tearNode_;
+    int                count_;
+};
+
+// every element puts the nodes it got into its own connectivity
+
+class TearConnectivity
+{
+  public:
+
+                   TearConnectivity
+
+      ( Global&            globdat,
+        const TornIds&     torn )
+
+      : globdat_(globdat), torn_(torn) {}
+
+    void           operator () ( int ic )
+    {
+      const ElemStore&  store = globdat_.elemStore;
+      const int         last  = chunkEnd ( ic, store.size () );
+
+      int               jn, newId;
+
+      for ( int ie = ic * CHUNK_SIZE; ie < last; ie++ )
+      {
+        const ElemPointer& ep     = globdat_.elemSet[ie];
+        const int          index  = store.getIndex      ( ie );
+        const int*         inodes = store.getConnectivity0 ( ie );
+        const int          nnode  = store.getNodeCount  ( ie );
+
+        for ( int in = 0; in < nnode; in++ )
+        {
+          jn    = globdat_.nodeId2Position[inodes[in]];
+          newId = TornIds::NONE;
+
+          const IntSpan support = globdat_.nodeSupport[jn];
+
+          for ( int is = 0; is < support.size (); is++ )
+          {
+            if ( support[is] == index )
+            {
+              newId = torn_.get ( jn, is );
+              break;
+            }
+          }
+
+          if ( newId != TornIds::NONE ) ep->changeNode ( in, newId );
+        }
+      }
+    }
+
+  private:
+
+    Global&            globdat_;
+    const TornIds&     torn_;
+};
+
+// tears the mesh at the nodes visited by tearNode (count of them)
+
+template <class TearNode>
+static void              tearSupport
+
+  ( Global&         globdat,
+    const TornIds&  torn,
+    TearNode&       tearNode,
+    int             count )
+
+{
+  const int           threadCount = globdat.threadCount;
+
+  TearChunk<TearNode> tearChunk ( tearNode, count );
+  TearConnectivity    tearConnectivity ( globdat, torn );
+
+  parallelFor ( chunkCount ( count ), threadCount, tearChunk );
+  parallelFor ( chunkCount ( globdat.elemSet.size () ), threadCount,
+                tearConnectivity );
+}
 
 // -------------------------------------------------------
 //    doIt
@@ -17,46 +771,95 @@ void MeshModifier::doIt
 
   ( Global&  globdat )
 {
+  Profile&   profile   = globdat.profile;
+
+  const long elemCount = globdat.elemSet.size ();
+  const long nodeCount = globdat.nodeSet.size ();
 
-  buildNodeSupport      ( globdat );
-  buildNeighborElems    ( globdat );
+  int        phase;
+
+  if ( !globdat.isCached )
+  {
+    phase = profile.start ( "node support" );
+    buildNodeSupport    ( globdat );
+    profile.stop ( phase, elemCount );
+
+    phase = profile.start ( "neighbors" );
+    buildNeighborElems  ( globdat );
+    profile.stop ( phase, elemCount );
+
+    if ( !globdat.cacheFile.empty () ) saveMeshCache ( globdat );
+  }
+
+  phase = profile.start ( "interfacial nodes" );
   buildInterfacialNodes ( globdat );
+  profile.stop ( phase, nodeCount );
+
+  phase = profile.start ( "duplication" );
   duplicateNodes        ( globdat ); 
+  profile.stop ( phase, nodeCount );
+
+  phase = profile.start ( "tearing" );
   tearElements          ( globdat ); 
+  profile.stop ( phase, elemCount );
 }
 
 // -------------------------------------------------------
 //    buildNodeSupport
 // -------------------------------------------------------
 
+/*
+ * The elements around each node, in the order of elemSet. Elements are
+ * handed to the threads in chunks: the elements of each node are
+ * counted (atomically), the counts turned into offsets and the element
+ * positions filled in. As threads fill in any order, each row is then
+ * sorted, which gives the same support as a serial run.
+ */
+
 void MeshModifier::buildNodeSupport
 
   ( Global&  globdat )
 
 {
-  const int   elemCount = globdat.elemSet.size ();
-  const int   nodeCount = globdat.nodeSet.size ();
+  const int   elemCount   = globdat.elemSet.size ();
+  const int   rowCount    = globdat.nodeSet.size ();
+  const int   threadCount = globdat.threadCount;
 
-  IntVector   inodes;
-
-  ElemPointer ep;
+  IntVector   offsets ( rowCount + 1, 0 );
+  IntVector   values;
 
   cout << "building nodal support...\n";
 
-  for ( int ie = 0; ie < elemCount; ie++ )
-  {
-    ep = globdat.elemSet[ie];
+  AtomicIntVector  counts ( rowCount );
 
-    ep->getConnectivity ( inodes );
+  for ( int in = 0; in < rowCount; in++ ) counts[in] = 0;
 
-    //print (inodes.begin(), inodes.end());  cout << "\n";
+  CountSupport     countSupport ( globdat.elemStore, globdat.nodeId2Position,
+                                  counts );
 
-    for ( int in = 0; in < inodes.size(); in++ )
-    {
-      globdat.nodeSupport[inodes[in]].push_back ( ep->getIndex () );
-    }
+  parallelFor ( chunkCount ( elemCount ), threadCount, countSupport );
+
+  // the counts become the fill positions of the rows
+
+  for ( int in = 0; in < rowCount; in++ )
+  {
+    offsets[in+1] = offsets[in] + counts[in];
+    counts[in]    = offsets[in];
   }
 
+  values.resize ( offsets[rowCount] );
+
+  FillSupport      fillSupport ( globdat.elemStore, globdat.nodeId2Position,
+                                 counts, values );
+
+  parallelFor ( chunkCount ( elemCount ), threadCount, fillSupport );
+
+  SortSupport      sortSupport ( globdat.elemStore, offsets, values );
+
+  parallelFor ( chunkCount ( rowCount ), threadCount, sortSupport );
+
+  globdat.nodeSupport.swap ( offsets, values );
+
   cout << "building nodal support...done!\n\n";
 }
 
@@ -65,48 +868,38 @@ void MeshModifier::buildNodeSupport
 //    buildNeighborElems
 // -------------------------------------------------------
 
+/*
+ * Builds the dual graph: across each side (corner edge in 2D, face in
+ * 3D) of an element is the first other element in the support of the
+ * side's first corner that has the same side. Elements are handed to
+ * the threads in chunks; the sides are counted, the counts turned into
+ * offsets and every element fills in its own neighbors, so the graph
+ * does not depend on the number of threads.
+ */
+
 void MeshModifier::buildNeighborElems
 
   ( Global&  globdat )
 
 {
-  int         inodeCnt;
-
-  ElemPointer ep;
+  const int   elemCount   = globdat.elemSet.size ();
+  const int   threadCount = globdat.threadCount;
 
-  IntVector   inodes;
+  DualGraph&  graph       = globdat.elemNeighbors;
 
   cout << "building element neighbors...\n";
 
-  const int   elemCount = globdat.elemSet.size ();
+  graph.startCount ( elemCount );
 
-  globdat.elemNeighbors.resize ( elemCount );
+  CountSides     countSides    ( globdat );
 
-  for ( int ie = 0; ie < elemCount; ie++ )
-  {
-    ep = globdat.elemSet[ie];
-
-    ep->getConnectivity ( inodes );
-
-    inodeCnt = inodes.size ();
-
-    IntSet neighbors;
+  parallelFor ( chunkCount ( elemCount ), threadCount, countSides );
 
-    for ( int in = 0; in < inodeCnt; in++ )
-    {
-      int ii = inodes[in];
-
-      for ( int iee = 0; iee < globdat.nodeSupport[ii].size(); iee++ )
-      {
-	neighbors.insert ( globdat.nodeSupport[ii][iee] );
-      }
-    }
+  graph.startFill ();
 
-    copy ( neighbors.begin(), neighbors.end(), 
-	   back_inserter ( globdat.elemNeighbors[ie] ) );
-  }
+  FindNeighbors  findNeighbors ( globdat );
 
-  //print ( elemNeighbors );
+  parallelFor ( chunkCount ( elemCount ), threadCount, findNeighbors );
 
   cout << "building element neighbors...done!\n\n";
 }
@@ -130,9 +923,10 @@ void MeshModifier::buildInterfacialNodes
   int         nnode;
 
   IntSet      matSet;
-  IntVector   inodes, support;
+  IntSpan     inodes;
+  IntSpan     support;
 
-  NodePointer np;
+  NodeStore&  nodes = globdat.nodeSet;
   ElemPointer ep;
 
   cout << "detecting interface nodes...\n";
@@ -140,12 +934,11 @@ void MeshModifier::buildInterfacialNodes
   for ( int in = 0; in < nodeCount; in++ )
   {
     rCount = 0;
-    np     = globdat.nodeSet[in];
-    index  = np->getIndex ();
+    index  = nodes.getIndex ( in );
 
     // ignore nodes belong to only ONE element
 
-    support   =  globdat.nodeSupport[index];
+    support   =  globdat.nodeSupport[in];
     suppCount =  support.size (); 
 
     //print ( support.begin(), support.end() );
@@ -179,24 +972,24 @@ void MeshModifier::buildInterfacialNodes
       duplicity = matCount != 1 ? suppCount - rCount + 1 : suppCount;
     }
 
-    np->setDuplicity   ( duplicity );
+    nodes.setDuplicity ( in, duplicity );
 
     if ( matCount != 1 )    // interfacial node 
     {
       if ( !globdat.isIgSegment )   // option --noInterface is false
       {
-        np->setIsInterface ( true ); 
+        nodes.setIsInterface ( in, true ); 
         globdat.interfaceNodes.push_back ( index );
       }
       else
       {
-	if ( globdat.ignoredSegment.isOn ( np->getX(), np->getY() ) )
+	if ( globdat.ignoredSegment.isOn ( nodes.getX ( in ), nodes.getY ( in ) ) )
 	{
-          np->setDuplicity   ( 1 );
+          nodes.setDuplicity ( in, 1 );
 	}
 	else
 	{
-	  np->setIsInterface ( true ); 
+	  nodes.setIsInterface ( in, true ); 
           globdat.interfaceNodes.push_back ( index );
 	}
       }
@@ -209,8 +1002,8 @@ void MeshModifier::buildInterfacialNodes
 	            matSet.end  (), 
 		    globdat.rigidDomain ) != matSet.end () )
 	{
-	  np->setIsRigid   ( true );
-	  np->setDuplicity ( 1    );
+	  nodes.setIsRigid ( in, true );
+	  nodes.setDuplicity ( in, 1 );
 	}
       }
     }
@@ -223,7 +1016,7 @@ void MeshModifier::buildInterfacialNodes
 	        globdat.boundaryNodes.end(), 
 		index ) != globdat.boundaryNodes.end () )
     {
-      np->setIsOnBoundary ( true );
+      nodes.setIsOnBoundary ( in, true );
     }
   }
 
@@ -231,18 +1024,15 @@ void MeshModifier::buildInterfacialNodes
   // two interfacial nodes but this edge is not a grain
   // boundary, so do not add interface element along this edge.
 
-  if ( globdat.isPolycrystal )
+  if ( globdat.isPolycrystal && !globdat.is3D )
   {
      int n1, n2, m1, m2, o1, o2;
-     int neiCount, jelem, ielem;
+     int jelem, ielem;
      int imat, jmat;
 
-     ElemPointer jp;
-     IntVector   neighbors, jnodes0;
-
      bool        found;
 
-     IntVector::const_iterator it1, it2;
+     const DualGraph& neighbors = globdat.elemNeighbors;
 
      // loop over all elements
 
@@ -257,12 +1047,8 @@ void MeshModifier::buildInterfacialNodes
 	if ( ep->isInterfaceElement ( globdat.nodeSet, 
 	                              globdat.nodeId2Position ) ) 
 	{
-          neighbors = globdat.elemNeighbors[ie]; 
-	  neiCount  = neighbors.size ();
-
-	  ep->getCornerConnectivity0 ( inodes ); //print (inodes.begin(), inodes.end());
-	  inodes.push_back ( inodes[0] );  
-	  nnode = inodes.size()-1;
+	  inodes = ep->getCornerNodes0 ();
+	  nnode  = inodes.size();
 
 	  imat  = globdat.elem2Domain[ielem];
 
@@ -271,42 +1057,26 @@ void MeshModifier::buildInterfacialNodes
 	  for ( int in = 0; in < nnode; in++ )
 	  {
 	    n1 = inodes[in];
-	    n2 = inodes[in+1]; //cout << n1 << ";" << n2 << endl;
-
-	    // loop over neighbors of element ie
-
-	    for ( int je = 0; je < neiCount; je++ )
-	    {
-	       jelem = globdat.elemId2Position[neighbors[je]];
-	       jp    = globdat.elemSet[jelem];
+	    n2 = inodes[(in+1) % nnode]; //cout << n1 << ";" << n2 << endl;
 
-	       // omit element being considered
+	    // the element across this edge
 
-	       if ( jp->getIndex() == ielem ) continue; 
+	    jelem = neighbors.getNeighbor ( ie, in );
 
-	       jp->getCornerConnectivity0 ( jnodes0 );
-	       it1 = find ( jnodes0.begin(), jnodes0.end(), n1 );
-	       it2 = find ( jnodes0.begin(), jnodes0.end(), n2 );
-
-	       // common edge between ielem and jelem found
-
-	       if (  it1 != jnodes0.end()  && it2 != jnodes0.end()  )
-	       {
-                 jmat  = globdat.elem2Domain[neighbors[je]];
+	    if ( jelem != DualGraph::NONE )
+	    {
+              jmat  = globdat.elem2Domain[globdat.elemSet[jelem]->getIndex()];
                  
-		 //print (jnodes0.begin(), jnodes0.end());
-		 //cout << imat << "," << jmat << endl;
+	      //cout << imat << "," << jmat << endl;
 
-		 if ( jmat == imat )
-		 {
-	           globdat.ignoredEdges.push_back ( NodePair(n1,n2) );
-                   found = true;
+	      if ( jmat == imat )
+	      {
+	        globdat.ignoredEdges.push_back ( NodePair(n1,n2) );
+                found = true;
 
-		   //cout << NodePair(n1,n2);
-		   break; // only have ONE edge in common
-		 }
-	       }
-	    } // end of loop on neighbors
+	        //cout << NodePair(n1,n2);
+	      }
+	    }
 
 	    if ( found ) continue; 
 
@@ -331,6 +1101,14 @@ void MeshModifier::buildInterfacialNodes
 //    duplicateNodes
 // -------------------------------------------------------
 
+/*
+ * A node shared by n elements gets n-1 copies. The copies of each node
+ * are counted in parallel, a prefix sum over the counts gives the ids
+ * of the copies (in the order of nodeSet, as a serial loop would) and
+ * the new nodes are then filled in in parallel. The copies are
+ * numbered after the largest original id, which is the node count for
+ * nodes numbered from 0 or 1.
+ */
 
 void MeshModifier::duplicateNodes
 
@@ -343,59 +1121,62 @@ void MeshModifier::duplicateNodes
 
   cout << "duplicating nodes...\n";
 
-  const int     nodeCount = globdat.nodeSet.size ();
+  const int        nodeCount   = globdat.nodeSet.size ();
+  const int        threadCount = globdat.threadCount;
 
-        int     index, duplicity;
-	int     idd(0);
+  const NodeStore& nodes       = globdat.nodeSet;
+
+  IntVector        copies ( nodeCount );
+  IntVector        first  ( nodeCount + 1, 0 );
+
+  CountCopies      countCopies ( globdat, copies );
+
+  parallelFor ( chunkCount ( nodeCount ), threadCount, countCopies );
 
-  NodePointer   np;
-  
   for ( int in = 0; in < nodeCount; in++ )
   {
-    np    = globdat.nodeSet[in];
+    first[in+1] = first[in] + max ( copies[in], 0 );
+  }
 
-    index = np->getIndex ();
+  const int        idd = first[nodeCount];
 
-    // if only generate interface elements along material
-    // interfaces, then ignore nodes which are not interfacial
+  const int        lastId = max ( nodeCount, globdat.nodeId2Position.maxId () );
 
-    if (  ( globdat.isInterface || globdat.isPolycrystal ) && 
-	  !np->getIsInterface ()  ) 
-    {
-      continue;
-    }
-	
-    // no interface elements in rigid domain then
-    // not duplicate nodes that are defined rigid.
+  globdat.newNodeSet.resize ( nodeCount + idd );
 
-    if ( ( globdat.isDomain ) && ( np->getIsRigid() ) )
-    {
-      continue;
-    }
+  AddCopies        addCopies ( globdat, copies, first, lastId );
 
-    duplicity = np->getDuplicity ();
+  parallelFor ( chunkCount ( nodeCount ), threadCount, addCopies );
 
-    //cout << duplicity << "\n";
-    
-    if ( duplicity == 1 ) continue;  // ignore nodes belong to only ONE element
- 
-    globdat.duplicatedNodes[index].push_back ( index );
+  // node position => the node itself followed by its copies
 
-    for ( int id = 0; id < duplicity-1; id++ )
-    {
-      idd++;
+  IntVector        offsets ( nodeCount + 1, 0 );
+  IntVector        values;
+
+  for ( int in = 0; in < nodeCount; in++ )
+  {
+    offsets[in+1] = offsets[in] + ( copies[in] >= 0 ? copies[in] + 1 : 0 );
+  }
+
+  values.resize ( offsets[nodeCount] );
+
+  for ( int in = 0; in < nodeCount; in++ )
+  {
+    if ( copies[in] < 0 ) continue;
 
-      globdat.newNodeSet.push_back ( NodePointer 	  
-	                             ( new Node (np->getX(), np->getY(), np->getZ(),
-					 idd + nodeCount ) ) );
+    int*  dupl = &values[offsets[in]];
 
-      globdat.duplicatedNodes[index].push_back ( idd + nodeCount );
+    dupl[0] = nodes.getIndex ( in );
+
+    for ( int id = 0; id < copies[in]; id++ )
+    {
+      dupl[id+1] = lastId + first[in] + id + 1;
     }
   }
 
-  cout << "number of nodes added: " << idd << "\n\n";
+  globdat.duplicatedNodes.swap ( offsets, values );
 
-  globdat.duplicatedNodes0 = globdat.duplicatedNodes;
+  cout << "number of nodes added: " << idd << "\n\n";
 }
 
 
@@ -403,6 +1184,14 @@ void MeshModifier::duplicateNodes
 //    tearElements
 // -------------------------------------------------------
 
+/*
+ * Tearing gives each element around a duplicated node one of its
+ * copies. Per node the copy of every element of its support is chosen
+ * (in parallel over the nodes, see TornIds), then every element
+ * rewrites its own connectivity (in parallel over the elements). The
+ * result is the same as replacing the nodes one node at a time.
+ */
+
 void MeshModifier::tearElements
 
   ( Global&  globdat )
@@ -444,40 +1233,10 @@ void MeshModifier::tearInterfaceElements
   ( Global&  globdat )
 
 {
-  IntVector       support;
-
-  const int       interNodeCount = globdat.interfaceNodes.size (); 
+  TornIds              torn ( globdat );
+  TearInterfaceNode    tearNode ( globdat, torn );
 
-  int             inode; 
-  int             suppCount;
-  int             ielem;
-  int             mat,imat;
-
-  // loop over interface nodes
-
-  for ( int in = 0; in < interNodeCount; in++ )
-  {
-    inode      = globdat.interfaceNodes[in];
-
-    support    = globdat.nodeSupport[inode];
-    suppCount  = support.size ();
-
-    mat        = globdat.elem2Domain[support[0]];
-
-    // loop over support of this node
-
-    for ( int ie = 1; ie < suppCount; ie++ )
-    {
-      ielem    = globdat.elemId2Position[support[ie]]; 
-      imat     = globdat.elem2Domain[support[ie]];
-
-      if ( imat == mat ) continue;
-
-      globdat.elemSet[ielem]->changeConnectivity 
-	
-	             ( inode, globdat.duplicatedNodes[inode][1] );
-    }
-  }
+  tearSupport ( globdat, torn, tearNode, globdat.interfaceNodes.size () );
 }
 
 // -------------------------------------------------------
@@ -489,62 +1248,10 @@ void MeshModifier::tearDomainElements
   ( Global&  globdat )
 
 {
-  const  int         nodeCount = globdat.nodeSet.size ();
-
-         int         inode;
-	 int         ielem, iel;
-	 int         suppCount;
-
-	 IntVector   support;
-
-  for ( int in = 0; in < nodeCount; in++ )
-  {
-    // ignore nodes in rigid domain
-
-    if ( globdat.nodeSet[in]->getIsRigid() ) 
-    {
-      continue;
-    }
-
-    inode      = globdat.nodeSet[in]->getIndex ();
-    support    = globdat.nodeSupport[inode];
-    suppCount  = support.size ();
-
-    // different treatment for interfacial nodes
+  TornIds              torn ( globdat );
+  TearDomainNode       tearNode ( globdat, torn );
 
-    if ( globdat.nodeSet[in]->getIsInterface() )
-    {
-      //cout << inode << ":   "; // detect interface node correctly
-      //print ( support.begin(), support.end() );
-      //print ( duplicatedNodes[inode].begin(), duplicatedNodes[inode].end());
-
-      int c = 0;
-
-      for ( int ie = 0; ie < suppCount; ie++ )
-      {
-        iel      = support[ie];
-        if ( globdat.elem2Domain[iel] == globdat.rigidDomain ) 
-	{
-	  continue; 
-	}
-        ielem    = globdat.elemId2Position[iel]; 
-        globdat.elemSet[ielem]->changeConnectivity ( inode, globdat.duplicatedNodes[inode][1+c] );
-	c++;
-      }
-      continue;  // to next node (the below is skipped)
-    }
-
-    // the rest is handled in the following ...
-    // first element in the support keeps the original connectivity
-
-    for ( int ie = 1; ie < suppCount; ie++ )
-    {
-      iel      = support[ie];
-      ielem    = globdat.elemId2Position[iel]; 
-      
-      globdat.elemSet[ielem]->changeConnectivity ( inode, globdat.duplicatedNodes[inode][ie] );
-    }
-  }
+  tearSupport ( globdat, torn, tearNode, globdat.nodeSet.size () );
 }
 
 // -------------------------------------------------------
@@ -556,39 +1263,10 @@ void MeshModifier::tearAllElements
   ( Global&  globdat )
 
 {
-  const  int         nodeCount = globdat.nodeSet.size ();
-
-         int         inode;
-	 int         ielem, iel;
-	 int         suppCount;
+  TornIds              torn ( globdat );
+  TearAllNode          tearNode ( globdat, torn );
 
-	 IntVector   support;
-
-  for ( int in = 0; in < nodeCount; in++ )
-  {
-    inode      = globdat.nodeSet[in]->getIndex ();
-    support    = globdat.nodeSupport[inode];
-    suppCount  = support.size ();
-
-    // first element in the support keeps the original connectivity
-
-    for ( int ie = 1; ie < suppCount; ie++ )
-    {
-      iel      = support[ie];
-      ielem    = globdat.elemId2Position[iel]; 
-      
-      globdat.elemSet[ielem]->changeConnectivity ( inode, globdat.duplicatedNodes[inode][ie] );
-    }
-  }
-   
-  if ( globdat.is3D )
-  {
-    cout << "  -rebuilding faces for 3D elements...\n"; 
-    for ( int ie = 0; ie < globdat.elemSet.size (); ie++ )
-    {
-        globdat.elemSet[ie]->buildFaces ();
-    }
-  }
+  tearSupport ( globdat, torn, tearNode, globdat.nodeSet.size () );
 }
 
 // -------------------------------------------------------
@@ -600,84 +1278,8 @@ void MeshModifier::tearPolycrystalElements
   ( Global&  globdat )
 
 {
-  IntVector       support;
-
-  const int       interNodeCount = globdat.interfaceNodes.size (); 
-
-  int             inode, jnode; 
-  int             suppCount;
-  int             ielem, jelem;
-  int             mat, imat, jmat, matCount;
-
-  // loop over interface nodes
-
-  for ( int in = 0; in < interNodeCount; in++ )
-  {
-    inode      = globdat.interfaceNodes[in];
-    jnode      = globdat.nodeId2Position[inode];
+  TornIds              torn ( globdat );
+  TearPolycrystalNode  tearNode ( globdat, torn );
 
-    support    = globdat.nodeSupport[inode];
-    suppCount  = support.size ();
-
-    matCount   = globdat.nodeSet[jnode]->getDuplicity ();
-
-    // loop over support of this node
-
-    if ( matCount == 2 ) // node between 2 intergrnular boundaries
-    {
-      // first element in the support is kept unchanded
-    
-      mat = globdat.elem2Domain[support[0]];
-
-      for ( int ie = 1; ie < suppCount; ie++ )
-      {
-	ielem    = globdat.elemId2Position[support[ie]]; 
-	imat     = globdat.elem2Domain[support[ie]];
-
-	if ( imat == mat ) continue;
-
-	globdat.elemSet[ielem]->changeConnectivity 
-	  
-	          ( inode, globdat.duplicatedNodes[inode][1] );
-      }
-    }
-    else // nodes at the junction with 3 materials
-    {
-      int jj = 0;
-
-      IntVector doneNodes;
-
-      for ( int ie = 0; ie < suppCount; ie++ )
-      {
-	if ( find ( doneNodes.begin(),
-		    doneNodes.end  (), ie ) != doneNodes.end () )
-	{
-	  continue;
-	}
-
-	ielem    = globdat.elemId2Position[support[ie]]; 
-	imat     = globdat.elem2Domain[support[ie]];
-
-        for ( int je = 0; je < suppCount; je++ )
-        {
-	  if ( je < ie ) continue;
-
-	  jmat     = globdat.elem2Domain[support[je]]; 
-
-	  if ( jmat != imat ) continue;
-	
-	  jelem    = globdat.elemId2Position[support[je]]; 
-
-	  globdat.elemSet[jelem]->changeConnectivity 
-
-	            ( inode, globdat.duplicatedNodes[inode][jj] );
-
-	  doneNodes.push_back ( ie );
-	  doneNodes.push_back ( je );
-        }
-
-	jj++;
-      }
-    }
-  }
+  tearSupport ( globdat, torn, tearNode, globdat.interfaceNodes.size () );
 }
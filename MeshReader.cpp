@@ -5,6 +5,7 @@
 #include "MeshReader.h"
 #include "Global.h"
 #include "Element.h"
+#include "MeshCache.h"
 
 // =====================================================================
 //     readMesh
@@ -22,9 +23,32 @@ void                     readMesh
 
   boost::split ( filenames, filename, boost::is_any_of(".") );
 
-  if      ( filenames[1] == "msh" )
+  // a valid cache replaces reading the mesh and building its topology
+
+  if ( !globdat.cacheFile.empty () )
   {
-    readGmshMesh ( globdat, fileName );
+    globdat.cacheKey = hashMeshFile  ( fileName );
+    globdat.isCached = loadMeshCache ( globdat );
+  }
+
+  if      ( globdat.isCached )
+  {
+    checkMeshOptions ( globdat );
+  }
+  else if ( filenames[1] == "msh" )
+  {
+    if      ( isGmshBinaryMesh ( fileName ) )
+    {
+      readGmshMeshBinary ( globdat, fileName );
+    }
+    else if ( globdat.isMappedRead || globdat.threadCount > 1 )
+    {
+      readGmshMeshMapped ( globdat, fileName );
+    }
+    else
+    {
+      readGmshMesh       ( globdat, fileName );
+    }
   }
   else if ( filenames[1] == "nurbs" )
   {
@@ -57,7 +81,24 @@ void                     readMesh
   if (globdat.is3D){
   cout << "Three dimensional mesh is being considered\n";
   }
-  
+  cout << endl;
+}
+
+
+// =====================================================================
+//     computeSmallestSize
+// =====================================================================
+
+/*
+ * Only reads the nodes and the original connectivity, which do not
+ * change after readMesh: main runs it while MeshModifier builds the
+ * node support and tears the mesh.
+ */
+
+double                   computeSmallestSize
+
+    ( Global&     globdat )
+{
   // compute element size (smallest) for determining critical time step
   // in explicit dynamic simulations
   
@@ -79,8 +120,134 @@ void                     readMesh
      she   = min(he,she);
   }
 
-  cout << "Smallest element size......................... " << she << "\n";
+  return she;
+}
+
+
+// =====================================================================
+//     checkMeshOptions
+// =====================================================================
+
+// validate the options against the mesh
+
+void                     checkMeshOptions
+
+    ( Global&     globdat )
+{
+  // check validity of input
+
+  if ( globdat.isDomain )
+  {
+    Int2IntVectMap::const_iterator it;
+    Int2IntVectMap::const_iterator eit = globdat.dom2Elems.end   ();
+
+    it = globdat.dom2Elems.find ( globdat.rigidDomain );
+
+    if ( it == eit )
+    {
+      cerr << "invalid number of rigid domain!!!\n";
+      exit(1);
+    }
+  }
+
+  if ( globdat.isInterface )
+  {
+  }
+
+  if ( globdat.isNotch )
+  {
+    cout << "Existing notch segment is: "; // << globdat.segment << endl;
+  }
+
+  if ( globdat.isIgSegment )
+  {
+    cout << "Do not treat nodes on this segment: "<< globdat.ignoredSegment << endl;
+  }
+
   cout << endl;
 }
 
 
+// =====================================================================
+//     finishMesh
+// =====================================================================
+
+/*
+ * Checks shared by the Gmsh and Abaqus readers once nodes and
+ * elements are in place: validate the options against the mesh and
+ * deduce the kind of interface elements. The faces of 3D elements need
+ * no building, they are read from the connectivity when asked for.
+ * nodeElemCount is the node count of the last solid element read.
+ */
+
+void                     finishMesh
+
+    ( Global&     globdat,
+      int         nodeElemCount )
+{
+  int             elemType;
+
+  checkMeshOptions ( globdat );
+
+  // every node of an element must have been read, the node data is
+  // looked up by the position of the node
+
+  const ElemStore& elems = globdat.elemStore;
+
+  for ( int ie = 0; ie < elems.size (); ie++ )
+  {
+    const int* inodes = elems.getConnectivity0 ( ie );
+    const int  nnode  = elems.getNodeCount     ( ie );
+
+    for ( int in = 0; in < nnode; in++ )
+    {
+      if ( !globdat.nodeId2Position.contains ( inodes[in] ) )
+      {
+        cerr << "node " << inodes[in] << " of an element is not "
+             << "defined!!!\n";
+        exit(1);
+      }
+    }
+  }
+
+  globdat.nodeElemCount = nodeElemCount;
+
+  string elemTypeStr = "linear";
+
+  elemType = globdat.elemSet[0]->getElemType ();
+
+  if ( !globdat.is3D )
+  {
+    if ( elemType == 2 || elemType == 3 )
+    {
+      globdat.nodeICount  = globdat.isContinuum ? 4 : 2;
+      globdat.isQuadratic = false;
+      elemTypeStr         = "linear";
+    }
+    else
+    {
+      globdat.nodeICount  = 6;
+      globdat.isQuadratic = true;
+      elemTypeStr         = "quadratic";
+    }
+  }
+  else
+  {
+    // hex8 or tet4 elements 
+    if ( elemType == 4 || elemType == 5 ) 
+    {
+      globdat.nodeICount  = elemType == 4 ? 6 : 8;
+      globdat.isQuadratic = false; 
+      elemTypeStr = "linear";
+    }
+    // hex20 or tet10 elements 
+    else
+    {
+      globdat.nodeICount  = elemType == 11 ? 12 : 16;
+      globdat.isQuadratic = true;
+      elemTypeStr = "quadratic";
+    }
+  }
+
+
+}
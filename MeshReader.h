@@ -1,6 +1,8 @@
 #ifndef MESH_READER_H
 #define MESH_READER_H
 
+#include "typedefs.h"
+
 class Global;
 
 void                     readGmshMesh 
@@ -8,6 +10,49 @@ void                     readGmshMesh
     ( Global&     globdat,
       const char* fileName );
 
+// same as readGmshMesh, but the file is memory mapped
+// and tokenized in place (option --mapped-read); with
+// more than one thread the $Nodes and $Elements sections
+// are parsed in chunks in parallel
+
+void                     readGmshMeshMapped
+
+    ( Global&     globdat,
+      const char* fileName );
+
+// binary Gmsh format 4.1
+
+void                     readGmshMeshBinary
+
+    ( Global&     globdat,
+      const char* fileName );
+
+bool                     isGmshBinaryMesh
+
+    ( const char* fileName );
+
+// stores element ie (index in the element list of the file) of a
+// Gmsh mesh in globdat: boundary lines, points, 3D surface elements
+// or solid elements, according to elemType
+
+void                     addGmshElement
+
+    ( Global&           globdat,
+      int               ie,
+      int               elemType,
+      int               matId,
+      const IntVector&  connectivity,
+      int&              nodeElemCount );
+
+void                     checkMeshOptions
+
+    ( Global&     globdat );
+
+void                     finishMesh
+
+    ( Global&     globdat,
+      int         nodeElemCount );
+
 void                     readAbaqusMesh
 
 (Global&     globdat,
@@ -24,6 +69,10 @@ void                     readMesh
    ( Global&     globdat,
      const char* fileName );
 
+double                   computeSmallestSize
+
+    ( Global&     globdat );
+
 
 
 #endif
@@ -7,8 +7,9 @@
 
 void                     writeMesh 
 
-   ( Global&     globdat,
-     const char* fileName )
+   ( Global&        globdat,
+     const char*    fileName,
+     const string&  bulk )
 
 {
   string    filename  ( fileName );
@@ -18,9 +19,9 @@ void                     writeMesh
 
   if ( filenames[1] == "mesh" )
   {
-    writeJemMesh ( globdat, fileName );
+    writeJemMesh ( globdat, fileName, bulk );
   }
-  if ( filenames[1] == "inp" )
+  else if ( filenames[1] == "inp" )
   {
     writeAbaqusMesh ( globdat, fileName );
   }
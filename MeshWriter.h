@@ -1,12 +1,26 @@
 #ifndef MESH_WRITER_H
 #define MESH_WRITER_H
 
+#include <string>
+
 class Global;
 
+// bulk: the nodes and bulk elements as formatted by formatJemBulk,
+// written as they are; formatted here if empty
+
 void                     writeJemMesh 
 
-    ( Global&     globdat,
-      const char* fileName );
+    ( Global&             globdat,
+      const char*         fileName,
+      const std::string&  bulk = "" );
+
+// the start of a jem mesh file (nodes and bulk elements), which does
+// not change any more once the mesh is torn
+
+void                     formatJemBulk
+
+    ( const Global&       globdat,
+      std::string&        text );
 
 void                     writeAbaqusMesh 
 
@@ -15,8 +29,9 @@ void                     writeAbaqusMesh
 
 void                     writeMesh 
 
-   ( Global&     globdat,
-     const char* fileName );
+   ( Global&             globdat,
+     const char*         fileName,
+     const std::string&  bulk = "" );
 
 
 #endif
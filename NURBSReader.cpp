@@ -1,5 +1,5 @@
 #include "Global.h"
-#include "Node.h"
+#include "NodeStore.h"
 #include "Element.h"
 
 /*
@@ -23,7 +23,25 @@
  */
 
 
-#include <boost/algorithm/string.hpp>
+#include "TextScanner.h"
+
+
+// all integers of a line
+
+static void              readIntLine
+
+    ( IntVector&     values,
+      const string&  line )
+{
+  TextScanner scanner ( line );
+
+  values.clear ();
+
+  while ( !scanner.atEndOfLine () )
+  {
+    values.push_back ( scanner.readInt () );
+  }
+}
 
 
 void                     readNURBSMesh 
@@ -42,11 +60,10 @@ void                     readNURBSMesh
   int             id;
   int             length;
   int             matId;
-  int             elemType, paraElemType;
+  int             elemType;
 
   double          x,y,z(0);
 
-  StrVector       splitLine;
   IntVector       connectivity;
 
   string  line;
@@ -55,27 +72,38 @@ void                     readNURBSMesh
   cout << "Reading nodes...\n";
 
   getline ( file, line );
-  boost::split ( splitLine, line, boost::is_any_of("\t ") );
 
-  int nodeCount  = boost::lexical_cast<int> ( splitLine[1] );
-  int elemCount  = boost::lexical_cast<int> ( splitLine[3] );	
+  // NumberOfNodes n NumberOfElements m
+
+  TextScanner header ( line );
+
+  header.skipWord ();
+  int nodeCount  = header.readInt ();
+  header.skipWord ();
+  int elemCount  = header.readInt ();
 
   getline ( file, line );
 
   for ( int in = 0; in < nodeCount; in++ )
   {
-    file >> id >> x >> y;
+    getline ( file, line );
 
-    globdat.nodeSet.push_back ( NodePointer( new Node(x,y,z,id) ) );
+    TextScanner scanner ( line );
 
-    globdat.nodeId2Position[id] = globdat.nodeSet.size()-1;
+    id = scanner.readInt    ();
+    x  = scanner.readDouble ();
+    y  = scanner.readDouble ();
+
+    globdat.nodeSet.add ( x, y, z, id );
+
+    globdat.nodeId2Position.set ( id, globdat.nodeSet.size()-1 );
   }
 
   // checking two or three dimensional mesh
 
   for ( int in = 0; in < nodeCount; in++ )
   {
-    if ( globdat.nodeSet[in]->getZ() != 0. )
+    if ( globdat.nodeSet.getZ ( in ) != 0. )
     {
       globdat.is3D = true;
       break;
@@ -85,23 +113,15 @@ void                     readNURBSMesh
   cout << "Reading nodes...done!\n\n";
   cout << "Reading elements...\n";
 
-  getline ( file, line );
   getline ( file, line );
 
   for ( int ie = 0; ie < elemCount; ie++ )
   {
     getline ( file, line );
 
-    boost::split ( splitLine, line, boost::is_any_of("\t ") );
-
     // read connectivity 
 
-    connectivity.clear ();
-
-    transform ( splitLine.begin(), 
-	        splitLine.end  ()-1, 
-		back_inserter(connectivity), 
-		Str2IntFunctor() );
+    readIntLine ( connectivity, line );
 
     // define element type using Gmsh format
     // defined only for cases where Gmsh cannot make such meshes:
@@ -115,9 +135,9 @@ void                     readNURBSMesh
        case 6: elemType = 9; break;     // six node triangle elements
     }
 
-    globdat.elemSet.push_back ( ElemPointer ( new Element ( ie, elemType, connectivity, true ) )  );
+    globdat.elemSet.push_back ( globdat.elemArena.create<Element> ( globdat.elemStore, ie, elemType, connectivity, true )  );
 
-    globdat.elemId2Position[ie] = globdat.elemSet.size() - 1;
+    globdat.elemId2Position.set ( ie, globdat.elemSet.size() - 1 );
   }
 
   cout << "Reading elements...done!\n\n";
@@ -132,12 +152,14 @@ void                     readNURBSMesh
   {
     getline ( file, line );
 
-    boost::split ( splitLine, line, boost::is_any_of("\t ") );
+    TextScanner scanner ( line );
+
+    scanner.readInt ();
 
-    matId  = boost::lexical_cast<int> ( splitLine[1] );
+    matId  = scanner.readInt ();
 
     globdat.dom2Elems[matId].push_back ( ie );
-    globdat.elem2Domain[ie] = matId;
+    globdat.elem2Domain.set ( ie, matId );
   }
 
   cout << "Reading materials...done!\n\n";
@@ -146,23 +168,20 @@ void                     readNURBSMesh
 
   getline ( file, line );
 
-  boost::split ( splitLine, line, boost::is_any_of("\t ") );
+  // NODE GROUPS n
 
-  int nodeGroupCount  = boost::lexical_cast<int> ( splitLine[2] );
+  header = TextScanner ( line );
+
+  header.skipWord ();
+  header.skipWord ();
+  int nodeGroupCount  = header.readInt ();
 
   for (int ing = 0; ing < nodeGroupCount; ing++ )
   {
     getline ( file, line );
     getline ( file, line );
       
-    boost::split ( splitLine, line, boost::is_any_of("\t ") );
-
-    connectivity.clear ();
-
-    transform ( splitLine.begin(), 
-                splitLine.end  ()-1, 
-          	back_inserter(connectivity), 
-          	Str2IntFunctor() );
+    readIntLine ( connectivity, line );
     
     for ( int ii = 0; ii < connectivity.size(); ii++)
     {
@@ -248,11 +267,6 @@ void                     readNURBSMesh
       globdat.isQuadratic = true;
       elemTypeStr = "quadratic";
     }
-
-    for ( int ie = 0; ie < globdat.elemSet.size (); ie++ )
-    {
-      globdat.elemSet[ie]->buildFaces ();
-    }
   }
 
 
@@ -0,0 +1,72 @@
+#include "NodeStore.h"
+
+
+// ------------------------------------------------------------
+//    reserve
+// ------------------------------------------------------------
+
+void NodeStore::reserve ( int count )
+{
+  x_        .reserve ( count );
+  y_        .reserve ( count );
+  z_        .reserve ( count );
+  index_    .reserve ( count );
+  duplicity_.reserve ( count );
+  flags_    .reserve ( count );
+}
+
+// ------------------------------------------------------------
+//    resize
+// ------------------------------------------------------------
+
+void NodeStore::resize ( int count )
+{
+  x_        .resize ( count, 0.0 );
+  y_        .resize ( count, 0.0 );
+  z_        .resize ( count, 0.0 );
+  index_    .resize ( count, 0   );
+  duplicity_.resize ( count, 1   );
+  flags_    .resize ( count, 0   );
+}
+
+// ------------------------------------------------------------
+//    clear
+// ------------------------------------------------------------
+
+void NodeStore::clear ()
+{
+  x_        .clear ();
+  y_        .clear ();
+  z_        .clear ();
+  index_    .clear ();
+  duplicity_.clear ();
+  flags_    .clear ();
+}
+
+// ------------------------------------------------------------
+//    swap
+// ------------------------------------------------------------
+
+void NodeStore::swap ( NodeStore& rhs )
+{
+  x_        .swap ( rhs.x_         );
+  y_        .swap ( rhs.y_         );
+  z_        .swap ( rhs.z_         );
+  index_    .swap ( rhs.index_     );
+  duplicity_.swap ( rhs.duplicity_ );
+  flags_    .swap ( rhs.flags_     );
+}
+
+// ------------------------------------------------------------
+//    append
+// ------------------------------------------------------------
+
+void NodeStore::append ( const NodeStore& rhs )
+{
+  x_        .insert ( x_        .end(), rhs.x_        .begin(), rhs.x_        .end() );
+  y_        .insert ( y_        .end(), rhs.y_        .begin(), rhs.y_        .end() );
+  z_        .insert ( z_        .end(), rhs.z_        .begin(), rhs.z_        .end() );
+  index_    .insert ( index_    .end(), rhs.index_    .begin(), rhs.index_    .end() );
+  duplicity_.insert ( duplicity_.end(), rhs.duplicity_.begin(), rhs.duplicity_.end() );
+  flags_    .insert ( flags_    .end(), rhs.flags_    .begin(), rhs.flags_    .end() );
+}
@@ -0,0 +1,255 @@
+#ifndef NODE_STORE_H
+#define NODE_STORE_H
+
+#include "typedefs.h"
+
+// =====================================================================
+//     class NodeStore
+// =====================================================================
+
+/*
+ * The nodes of a mesh stored column wise: one array per coordinate,
+ * one for the ids, one for the duplicity and one byte of flags per
+ * node. A node is referred to by its position in the store; the
+ * accessors mirror the getters and setters of a single node.
+ */
+
+class NodeStore
+{
+  public:
+
+    inline int           size           () const;
+
+    void                 reserve        ( int count );
+    void                 clear          ();
+    void                 swap           ( NodeStore& rhs );
+
+    // adds a node (duplicity 1, no flags set), returns its position
+
+    inline int           add
+
+      ( double             x,
+        double             y,
+        double             z,
+        int                index );
+
+    // new nodes (at position size() on) as added by add, with
+    // coordinates and id given by set
+
+    void                 resize         ( int count );
+
+    inline void          set
+
+      ( int                in,
+        double             x,
+        double             y,
+        double             z,
+        int                index );
+
+    // adds all nodes of rhs
+
+    void                 append
+
+      ( const NodeStore&   rhs );
+
+    inline double        getX           ( int in ) const;
+    inline double        getY           ( int in ) const;
+    inline double        getZ           ( int in ) const;
+    inline int           getIndex       ( int in ) const;
+    inline int           getDuplicity   ( int in ) const;
+    inline bool          getIsInterface ( int in ) const;
+    inline bool          getIsOnBoundary( int in ) const;
+    inline bool          getDone        ( int in ) const;
+    inline bool          getIsRigid     ( int in ) const;
+
+    inline void          setDuplicity   ( int in, int  dupl      );
+    inline void          setIsInterface ( int in, bool interface );
+    inline void          setIsOnBoundary( int in, bool bound     );
+    inline void          setDone        ( int in, bool done      );
+
+    // a node on the interface is never rigid
+
+    inline void          setIsRigid     ( int in, bool rig       );
+
+    // whole columns, for sweeps over all nodes
+
+    inline const vector<double>&
+                         getXs          () const;
+    inline const vector<double>&
+                         getYs          () const;
+    inline const vector<double>&
+                         getZs          () const;
+    inline const IntVector&
+                         getIndices     () const;
+
+  private:
+
+    enum                 Flags
+    {
+                           INTERFACE   = 1,
+                           ON_BOUNDARY = 2,
+                           DONE        = 4,
+                           RIGID       = 8
+    };
+
+    inline void          setFlag_
+
+      ( int                in,
+        unsigned char      flag,
+        bool               value );
+
+  private:
+
+    vector<double>          x_;
+    vector<double>          y_;
+    vector<double>          z_;
+
+    IntVector               index_;
+    vector<unsigned short>  duplicity_;   // number of copies of the node
+    vector<unsigned char>   flags_;
+};
+
+// =====================================================================
+//   implementation of inline functions
+// =====================================================================
+
+inline int NodeStore::size () const
+{
+  return index_.size ();
+}
+
+inline int NodeStore::add
+
+  ( double  x,
+    double  y,
+    double  z,
+    int     index )
+
+{
+  x_        .push_back ( x     );
+  y_        .push_back ( y     );
+  z_        .push_back ( z     );
+  index_    .push_back ( index );
+  duplicity_.push_back ( 1     );
+  flags_    .push_back ( 0     );
+
+  return index_.size () - 1;
+}
+
+inline void NodeStore::set
+
+  ( int     in,
+    double  x,
+    double  y,
+    double  z,
+    int     index )
+
+{
+  x_    [in] = x;
+  y_    [in] = y;
+  z_    [in] = z;
+  index_[in] = index;
+}
+
+inline double NodeStore::getX ( int in ) const
+{
+  return x_[in];
+}
+
+inline double NodeStore::getY ( int in ) const
+{
+  return y_[in];
+}
+
+inline double NodeStore::getZ ( int in ) const
+{
+  return z_[in];
+}
+
+inline int NodeStore::getIndex ( int in ) const
+{
+  return index_[in];
+}
+
+inline int NodeStore::getDuplicity ( int in ) const
+{
+  return duplicity_[in];
+}
+
+inline bool NodeStore::getIsInterface ( int in ) const
+{
+  return flags_[in] & INTERFACE;
+}
+
+inline bool NodeStore::getIsOnBoundary ( int in ) const
+{
+  return flags_[in] & ON_BOUNDARY;
+}
+
+inline bool NodeStore::getDone ( int in ) const
+{
+  return flags_[in] & DONE;
+}
+
+inline bool NodeStore::getIsRigid ( int in ) const
+{
+  return flags_[in] & RIGID;
+}
+
+inline void NodeStore::setDuplicity ( int in, int dupl )
+{
+  duplicity_[in] = dupl;
+}
+
+inline void NodeStore::setIsInterface ( int in, bool interface )
+{
+  setFlag_ ( in, INTERFACE, interface );
+}
+
+inline void NodeStore::setIsOnBoundary ( int in, bool bound )
+{
+  setFlag_ ( in, ON_BOUNDARY, bound );
+}
+
+inline void NodeStore::setDone ( int in, bool done )
+{
+  setFlag_ ( in, DONE, done );
+}
+
+inline void NodeStore::setIsRigid ( int in, bool rig )
+{
+  setFlag_ ( in, RIGID, rig && !getIsInterface ( in ) );
+}
+
+inline const vector<double>& NodeStore::getXs () const
+{
+  return x_;
+}
+
+inline const vector<double>& NodeStore::getYs () const
+{
+  return y_;
+}
+
+inline const vector<double>& NodeStore::getZs () const
+{
+  return z_;
+}
+
+inline const IntVector& NodeStore::getIndices () const
+{
+  return index_;
+}
+
+inline void NodeStore::setFlag_
+
+  ( int            in,
+    unsigned char  flag,
+    bool           value )
+
+{
+  if ( value ) flags_[in] |=  flag;
+  else         flags_[in] &= ~flag;
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include "TaskPool.h"
+
+// =====================================================================
+//     parallelFor
+// =====================================================================
+
+/*
+ * Calls body(i) for i = 0,...,count-1 on at most threadCount threads,
+ * the calling thread included. Indices are handed out one at a time,
+ * so each call of body should carry a decent amount of work (a chunk
+ * of a file, a range of elements). Different indices must not write
+ * to shared data. With threadCount <= 1 the loop runs serially.
+ *
+ * While the program's TaskPool exists the indices become tasks of the
+ * pool (so parallelFor may be called from a task); otherwise threads
+ * are started for the loop.
+ */
+
+template <class Body>
+struct ParallelWorker_
+{
+                   ParallelWorker_
+
+    ( Body&              body,
+      std::atomic<int>&  next,
+      int                count )
+
+    : body(body), next(next), count(count) {}
+
+  void             operator () ()
+  {
+    int i;
+
+    while ( ( i = next++ ) < count )
+    {
+      body ( i );
+    }
+  }
+
+  Body&              body;
+  std::atomic<int>&  next;
+  int                count;
+};
+
+template <class Body>
+void                     parallelFor
+
+  ( int       count,
+    int       threadCount,
+    Body&     body )
+{
+  if ( threadCount <= 1 || count <= 1 )
+  {
+    for ( int i = 0; i < count; i++ )
+    {
+      body ( i );
+    }
+
+    return;
+  }
+
+  TaskPool* pool = TaskPool::getCurrent ();
+
+  if ( pool != 0 && pool->getThreadCount () > 1 )
+  {
+    pool->parallelFor ( count, body );
+
+    return;
+  }
+
+  std::atomic<int>          next ( 0 );
+  std::vector<std::thread>  threads;
+
+  ParallelWorker_<Body>     worker ( body, next, count );
+
+  const int workerCount = std::min ( threadCount, count ) - 1;
+
+  for ( int it = 0; it < workerCount; it++ )
+  {
+    threads.push_back ( std::thread ( worker ) );
+  }
+
+  worker ();
+
+  for ( int it = 0; it < workerCount; it++ )
+  {
+    threads[it].join ();
+  }
+}
+
+// =====================================================================
+//     chunks
+// =====================================================================
+
+/*
+ * Loops over many small items (nodes, elements) hand them to
+ * parallelFor in chunks of CHUNK_SIZE: chunk ic holds the items
+ * ic*CHUNK_SIZE,...,chunkEnd(ic,count)-1.
+ */
+
+static const int         CHUNK_SIZE = 4096;
+
+inline int               chunkCount ( int count )
+{
+  return ( count + CHUNK_SIZE - 1 ) / CHUNK_SIZE;
+}
+
+inline int               chunkEnd
+
+  ( int       ic,
+    int       count )
+{
+  return std::min ( ( ic + 1 ) * CHUNK_SIZE, count );
+}
+
+#endif
@@ -0,0 +1,232 @@
+#include "Profile.h"
+#include "Global.h"
+
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+
+// =====================================================================
+//   class Profile
+// =====================================================================
+
+Profile::Profile ()
+
+  : wallStart_(wallClock_ ()), cpuStart_(cpuClock_ ())
+
+{}
+
+// ---------------------------------------------------------------------
+//   start
+// ---------------------------------------------------------------------
+
+int Profile::start ( const string& name )
+{
+  Phase phase;
+
+  phase.name      = name;
+  phase.wallTime  = wallClock_ ();
+  phase.cpuTime   = cpuClock_  ();
+  phase.itemCount = 0;
+  phase.rss       = 0;
+  phase.peakRss   = 0;
+
+  std::lock_guard<std::mutex> lock ( mutex_ );
+
+  phases_.push_back ( phase );
+
+  return phases_.size () - 1;
+}
+
+// ---------------------------------------------------------------------
+//   stop
+// ---------------------------------------------------------------------
+
+void Profile::stop ( int phase, long itemCount )
+{
+  const double wall = wallClock_ ();
+  const double cpu  = cpuClock_  ();
+  const long   rss  = getRss     ();
+  const long   peak = getPeakRss ();
+
+  std::lock_guard<std::mutex> lock ( mutex_ );
+
+  Phase& p = phases_[phase];
+
+  p.wallTime  = wall - p.wallTime;
+  p.cpuTime   = cpu  - p.cpuTime;
+  p.itemCount = itemCount;
+  p.rss       = rss;
+  p.peakRss   = peak;
+}
+
+// ---------------------------------------------------------------------
+//   getPhases
+// ---------------------------------------------------------------------
+
+vector<Profile::Phase> Profile::getPhases () const
+{
+  std::lock_guard<std::mutex> lock ( mutex_ );
+
+  return phases_;
+}
+
+// ---------------------------------------------------------------------
+//   getWallTime, getCpuTime
+// ---------------------------------------------------------------------
+
+double Profile::getWallTime () const
+{
+  return wallClock_ () - wallStart_;
+}
+
+double Profile::getCpuTime () const
+{
+  return cpuClock_ () - cpuStart_;
+}
+
+// ---------------------------------------------------------------------
+//   getRss, getPeakRss
+// ---------------------------------------------------------------------
+
+// the second number of /proc/self/statm is the resident size in pages
+
+long Profile::getRss ()
+{
+  ifstream  statm ( "/proc/self/statm" );
+  long      size  = 0;
+  long      pages = 0;
+
+  statm >> size >> pages;
+
+  return pages * sysconf ( _SC_PAGESIZE );
+}
+
+// ru_maxrss (kilobytes on Linux) is only updated now and then, so it
+// may lag behind the current size
+
+long Profile::getPeakRss ()
+{
+  struct rusage usage;
+
+  getrusage ( RUSAGE_SELF, &usage );
+
+  return max ( usage.ru_maxrss * 1024L, getRss () );
+}
+
+// ---------------------------------------------------------------------
+//   wallClock_, cpuClock_
+// ---------------------------------------------------------------------
+
+double Profile::wallClock_ ()
+{
+  struct timespec t;
+
+  clock_gettime ( CLOCK_MONOTONIC, &t );
+
+  return t.tv_sec + 1.0e-9 * t.tv_nsec;
+}
+
+double Profile::cpuClock_ ()
+{
+  struct timespec t;
+
+  clock_gettime ( CLOCK_PROCESS_CPUTIME_ID, &t );
+
+  return t.tv_sec + 1.0e-9 * t.tv_nsec;
+}
+
+// =====================================================================
+//     writeProfile
+// =====================================================================
+
+// s as a JSON string
+
+static string            quoted
+
+  ( const string&          s )
+
+{
+  string q ( "\"" );
+
+  for ( size_t i = 0; i < s.size (); i++ )
+  {
+    if      ( s[i] == '"' || s[i] == '\\' ) { q += '\\'; q += s[i]; }
+    else if ( s[i] < ' ' )                  { q += ' ';             }
+    else                                    { q += s[i];            }
+  }
+
+  return q + "\"";
+}
+
+// the mode the program was run in
+
+static const char*       modeOf
+
+  ( const Global&          globdat )
+
+{
+  if      ( globdat.isConverter   ) return "converter";
+  else if ( globdat.isInterface   ) return "interface";
+  else if ( globdat.isDomain      ) return "domain";
+  else if ( globdat.isPolycrystal ) return "polycrystal";
+
+  return "everywhere";
+}
+
+void                     writeProfile
+
+  ( const Global&          globdat,
+    const char*            fileName,
+    const string&          meshFile )
+
+{
+  cout << "Writing profile...\n";
+
+  ofstream file ( fileName, std::ios::out );
+
+  if ( !file )
+  {
+    cerr << "Unable to open the profile file " << fileName << "!!!\n";
+    exit(1);
+  }
+
+  const vector<Profile::Phase> phases = globdat.profile.getPhases ();
+
+  file.precision ( 6 );
+
+  file << "{\n"
+       << "  \"mesh\": "              << quoted ( meshFile )           << ",\n"
+       << "  \"mode\": \""            << modeOf ( globdat )            << "\",\n"
+       << "  \"threads\": "           << globdat.threadCount           << ",\n"
+       << "  \"nodes\": "             << globdat.nodeSet.size ()       << ",\n"
+       << "  \"elements\": "          << globdat.elemSet.size ()       << ",\n"
+       << "  \"newNodes\": "          << globdat.newNodeSet.size ()    << ",\n"
+       << "  \"interfaceElements\": " << globdat.interfaceSet.size ()  << ",\n"
+       << "  \"phases\": [\n";
+
+  for ( size_t ip = 0; ip < phases.size (); ip++ )
+  {
+    const Profile::Phase& p = phases[ip];
+
+    const double rate = p.wallTime > 0.0 ? p.itemCount / p.wallTime : 0.0;
+
+    file << "    { \"name\": "           << quoted ( p.name )
+         << ", \"wallTime\": "           << p.wallTime
+         << ", \"cpuTime\": "            << p.cpuTime
+         << ", \"items\": "              << p.itemCount
+         << ", \"itemsPerSecond\": "     << rate
+         << ", \"rss\": "                << p.rss
+         << ", \"peakRss\": "            << p.peakRss
+         << " }" << ( ip + 1 < phases.size () ? ",\n" : "\n" );
+  }
+
+  file << "  ],\n"
+       << "  \"wallTime\": " << globdat.profile.getWallTime () << ",\n"
+       << "  \"cpuTime\": "  << globdat.profile.getCpuTime  () << ",\n"
+       << "  \"rss\": "      << Profile::getRss     ()         << ",\n"
+       << "  \"peakRss\": "  << Profile::getPeakRss ()         << "\n"
+       << "}\n";
+
+  cout << "Writing profile...done!\n\n";
+}
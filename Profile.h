@@ -0,0 +1,100 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <mutex>
+
+#include "typedefs.h"
+
+class Global;
+
+// =====================================================================
+//     class Profile
+// =====================================================================
+
+/*
+ * Wall time, CPU time, work done and memory of the phases of a run
+ * (reading, tearing, building the interface elements, writing, ...).
+ * A phase is started and stopped by the code that runs it:
+ *
+ *   int phase = globdat.profile.start ( "tearing" );
+ *   ...
+ *   globdat.profile.stop ( phase, elemCount );
+ *
+ * The CPU time is that of the whole process, so it includes the time
+ * of the threads working for the phase (and of any task running next
+ * to it). Phases may be started and stopped by different threads. The
+ * recording costs a few system calls per phase; the report is written
+ * by writeProfile if the program was run with --profile.
+ */
+
+class Profile
+{
+  public:
+
+    struct               Phase
+    {
+      string               name;
+      double               wallTime;    // seconds
+      double               cpuTime;     // seconds
+      long                 itemCount;   // elements, nodes, ... handled
+      long                 rss;         // resident bytes at the end
+      long                 peakRss;     // peak resident bytes so far
+    };
+
+                         Profile ();
+
+    // starts phase name, returns its number
+
+    int                  start
+
+      ( const string&      name );
+
+    // ends phase number phase, which handled itemCount items
+
+    void                 stop
+
+      ( int                phase,
+        long               itemCount );
+
+    // the phases in the order they were started
+
+    vector<Phase>        getPhases    () const;
+
+    // seconds since the profile was created
+
+    double               getWallTime  () const;
+    double               getCpuTime   () const;
+
+    // current and peak resident set size in bytes
+
+    static long          getRss       ();
+    static long          getPeakRss   ();
+
+  private:
+
+    static double        wallClock_   ();
+    static double        cpuClock_    ();
+
+  private:
+
+    mutable std::mutex   mutex_;
+
+    vector<Phase>        phases_;
+
+    double               wallStart_;
+    double               cpuStart_;
+};
+
+// ---------------------------------------------------------------------
+//   writeProfile
+// ---------------------------------------------------------------------
+
+// writes globdat.profile as JSON to fileName
+
+void                     writeProfile
+
+  ( const Global&          globdat,
+    const char*            fileName,
+    const string&          meshFile );
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+// =====================================================================
+//     class Span
+// =====================================================================
+
+/*
+ * A view on a contiguous range of values owned by someone else (a row
+ * of an Adjacency, the connectivity of an element). Nothing is copied;
+ * the view is valid as long as the owner is not modified.
+ */
+
+template <class T>
+class Span
+{
+  public:
+
+    typedef T            value_type;
+    typedef T*           iterator;
+    typedef T*           const_iterator;
+
+                         Span () : first_(0), last_(0) {}
+
+                         Span
+
+      ( T*                 first,
+        T*                 last )
+
+      : first_(first), last_(last) {}
+
+    T*                   begin () const { return first_; }
+    T*                   end   () const { return last_;  }
+
+    int                  size  () const { return int( last_ - first_ ); }
+    bool                 empty () const { return first_ == last_; }
+
+    T&                   operator [] ( int i ) const { return first_[i]; }
+
+  private:
+
+    T*                   first_;
+    T*                   last_;
+};
+
+typedef Span<const int>  IntSpan;
+
+#endif
@@ -0,0 +1,366 @@
+#include "TaskPool.h"
+
+
+TaskPool*  TaskPool::current_ = 0;
+
+// queue of the calling thread: its number for the workers, 0 for all
+// other threads
+
+static thread_local int  threadNumber = 0;
+
+// ------------------------------------------------------------
+//    constructor
+// ------------------------------------------------------------
+
+TaskPool::TaskPool ( int threadCount )
+
+  : threadCount_ ( std::max ( threadCount, 1 ) ),
+    base_        ( 0 ),
+    readyCount_  ( 0 ),
+    waiting_     ( 0 ),
+    quit_        ( false )
+
+{
+  for ( int it = 0; it < threadCount_; it++ )
+  {
+    queues_.push_back ( new Queue_ );
+  }
+
+  for ( int it = 1; it < threadCount_; it++ )
+  {
+    workers_.push_back ( std::thread ( &TaskPool::work_, this, it ) );
+  }
+
+  if ( current_ == 0 ) current_ = this;
+}
+
+// ------------------------------------------------------------
+//    destructor
+// ------------------------------------------------------------
+
+// all tasks must have been waited for
+
+TaskPool::~TaskPool ()
+{
+  {
+    std::lock_guard<std::mutex> lock ( sleepMutex_ );
+
+    quit_ = true;
+  }
+
+  wakeUp_.notify_all ();
+
+  for ( size_t it = 0; it < workers_.size (); it++ )
+  {
+    workers_[it].join ();
+  }
+
+  for ( size_t it = 0; it < queues_.size (); it++ )
+  {
+    delete queues_[it];
+  }
+
+  for ( size_t it = 0; it < records_.size (); it++ )
+  {
+    delete records_[it];
+  }
+
+  for ( size_t it = 0; it < free_.size (); it++ )
+  {
+    delete free_[it];
+  }
+
+  if ( current_ == this ) current_ = 0;
+}
+
+// ------------------------------------------------------------
+//    submit
+// ------------------------------------------------------------
+
+int TaskPool::submit
+
+  ( const Task&  task,
+    int          before )
+
+{
+  IntVector  tasks;
+
+  if ( before != NONE ) tasks.push_back ( before );
+
+  return submit ( task, tasks );
+}
+
+
+int TaskPool::submit
+
+  ( const Task&        task,
+    const IntVector&   before )
+
+{
+  Record_*  rec;
+  int       id;
+  bool      ready;
+
+  {
+    std::lock_guard<std::mutex> lock ( mutex_ );
+
+    if ( free_.empty () )
+    {
+      rec = new Record_;
+    }
+    else
+    {
+      rec = free_.back ();
+      free_.pop_back ();
+
+      rec->next.clear ();
+    }
+
+    rec->task    = task;
+    rec->pending = 0;
+    rec->done    = false;
+
+    id = base_ + records_.size ();
+
+    records_.push_back ( rec );
+
+    for ( size_t ib = 0; ib < before.size (); ib++ )
+    {
+      if ( before[ib] < base_ ) continue;     // recycled, so done
+
+      Record_* prev = record_ ( before[ib] );
+
+      if ( !prev->done )
+      {
+        prev->next.push_back ( id );
+        rec->pending++;
+      }
+    }
+
+    ready = rec->pending == 0;
+  }
+
+  if ( ready ) push_ ( threadNumber, id );
+
+  return id;
+}
+
+// ------------------------------------------------------------
+//    wait
+// ------------------------------------------------------------
+
+void TaskPool::wait ( int task )
+{
+  if ( task == NONE ) return;
+
+  while ( !isDone_ ( task ) )
+  {
+    if ( runOne_ ( threadNumber ) ) continue;
+
+    // nothing to run: sleep until a task is queued or one finishes
+
+    std::unique_lock<std::mutex> lock ( sleepMutex_ );
+
+    waiting_++;
+
+    wakeUp_.wait ( lock, [this,task] ()
+    {
+      return readyCount_ > 0 || isDone_ ( task );
+    } );
+
+    waiting_--;
+  }
+}
+
+// ------------------------------------------------------------
+//    getCurrent
+// ------------------------------------------------------------
+
+TaskPool* TaskPool::getCurrent ()
+{
+  return current_;
+}
+
+// ------------------------------------------------------------
+//    work_
+// ------------------------------------------------------------
+
+// the loop of worker thread number thread
+
+void TaskPool::work_ ( int thread )
+{
+  threadNumber = thread;
+
+  while ( true )
+  {
+    if ( runOne_ ( thread ) ) continue;
+
+    std::unique_lock<std::mutex> lock ( sleepMutex_ );
+
+    wakeUp_.wait ( lock, [this] () { return readyCount_ > 0 || quit_; } );
+
+    if ( quit_ ) return;
+  }
+}
+
+// ------------------------------------------------------------
+//    runOne_
+// ------------------------------------------------------------
+
+bool TaskPool::runOne_ ( int thread )
+{
+  int       task;
+  Record_*  rec;
+
+  if ( !pop_ ( thread, task ) ) return false;
+
+  {
+    std::lock_guard<std::mutex> lock ( mutex_ );
+
+    rec = record_ ( task );
+  }
+
+  rec->task ();
+
+  finish_ ( thread, task );
+
+  return true;
+}
+
+// ------------------------------------------------------------
+//    pop_
+// ------------------------------------------------------------
+
+// the newest task of the own queue, else the oldest of another one
+
+bool TaskPool::pop_
+
+  ( int   thread,
+    int&  task )
+
+{
+  for ( int it = 0; it < threadCount_; it++ )
+  {
+    Queue_& queue = *queues_[( thread + it ) % threadCount_];
+
+    std::lock_guard<std::mutex> lock ( queue.mutex );
+
+    if ( queue.tasks.empty () ) continue;
+
+    if ( it == 0 )
+    {
+      task = queue.tasks.back  ();
+      queue.tasks.pop_back     ();
+    }
+    else
+    {
+      task = queue.tasks.front ();
+      queue.tasks.pop_front    ();
+    }
+
+    readyCount_--;
+
+    return true;
+  }
+
+  return false;
+}
+
+// ------------------------------------------------------------
+//    push_
+// ------------------------------------------------------------
+
+void TaskPool::push_
+
+  ( int  thread,
+    int  task )
+
+{
+  {
+    Queue_& queue = *queues_[thread];
+
+    std::lock_guard<std::mutex> lock ( queue.mutex );
+
+    queue.tasks.push_back ( task );
+  }
+
+  readyCount_++;
+
+  // the lock makes sure a worker going to sleep sees the new task
+
+  {
+    std::lock_guard<std::mutex> lock ( sleepMutex_ );
+  }
+
+  wakeUp_.notify_one ();
+}
+
+// ------------------------------------------------------------
+//    finish_
+// ------------------------------------------------------------
+
+// marks task as done, queues the tasks that were waiting for it and
+// wakes up the waiting threads
+
+void TaskPool::finish_
+
+  ( int  thread,
+    int  task )
+
+{
+  IntVector  ready;
+
+  {
+    std::lock_guard<std::mutex> lock ( mutex_ );
+
+    Record_* rec = record_ ( task );
+
+    rec->task = Task ();    // frees what the task holds
+    rec->done = true;
+
+    for ( size_t in = 0; in < rec->next.size (); in++ )
+    {
+      if ( --record_ ( rec->next[in] )->pending == 0 )
+      {
+        ready.push_back ( rec->next[in] );
+      }
+    }
+
+    // recycle the records of the oldest tasks as far as they are done
+
+    while ( !records_.empty () && records_.front ()->done )
+    {
+      free_.push_back ( records_.front () );
+      records_.pop_front ();
+      base_++;
+    }
+  }
+
+  for ( size_t in = 0; in < ready.size (); in++ )
+  {
+    push_ ( thread, ready[in] );
+  }
+
+  // the lock makes sure a thread going to sleep in wait sees that the
+  // task is done
+
+  if ( waiting_ > 0 )
+  {
+    {
+      std::lock_guard<std::mutex> lock ( sleepMutex_ );
+    }
+
+    wakeUp_.notify_all ();
+  }
+}
+
+// ------------------------------------------------------------
+//    isDone_
+// ------------------------------------------------------------
+
+bool TaskPool::isDone_ ( int task )
+{
+  std::lock_guard<std::mutex> lock ( mutex_ );
+
+  return task < base_ || record_ ( task )->done;
+}
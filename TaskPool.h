@@ -0,0 +1,173 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+#include "typedefs.h"
+
+// =====================================================================
+//     class TaskPool
+// =====================================================================
+
+/*
+ * A small task graph runtime on a work stealing thread pool. Tasks are
+ * submitted with the tasks they must wait for and run as soon as those
+ * have finished. Every thread keeps its own queue of ready tasks, takes
+ * the newest one from it and, when it runs dry, steals the oldest one
+ * from another thread.
+ *
+ * A pool of threadCount threads starts threadCount-1 workers: the
+ * thread that waits for a task (wait, parallelFor) runs tasks as well,
+ * so a task may itself wait for other tasks. With threadCount = 1 there
+ * are no workers and the tasks run, in the order they were submitted,
+ * when they are waited for.
+ *
+ * A thread waiting for a task runs ready tasks meanwhile and sleeps
+ * when there are none. The record of a task is recycled once it and all
+ * tasks submitted before it have finished; ids are never reused, an id
+ * older than the oldest record belongs to a finished task.
+ *
+ * The program creates one pool in main; while it exists parallelFor
+ * (Parallel.h) hands its indices to the pool as tasks.
+ */
+
+class TaskPool
+{
+  public:
+
+    typedef std::function<void ()>   Task;
+
+    static const int     NONE = -1;
+
+    explicit             TaskPool        ( int threadCount );
+                        ~TaskPool        ();
+
+    inline int           getThreadCount  () const;
+
+    // adds a task that runs once the tasks before (NONE for no task)
+    // have finished, returns its id
+
+    int                  submit
+
+      ( const Task&        task,
+        int                before = NONE );
+
+    int                  submit
+
+      ( const Task&        task,
+        const IntVector&   before );
+
+    // runs tasks until task (NONE: nothing) has finished
+
+    void                 wait            ( int task );
+
+    // body(i) for i = 0,...,count-1 as tasks, waits for all of them
+
+    template <class Body>
+    void                 parallelFor
+
+      ( int                count,
+        Body&              body );
+
+    // the pool of the program, 0 if there is none
+
+    static TaskPool*     getCurrent      ();
+
+  private:
+
+    struct               Record_
+    {
+      Task                 task;
+      int                  pending;     // tasks before it still running
+      std::atomic<bool>    done;
+      IntVector            next;        // tasks waiting for it
+    };
+
+    struct               Queue_
+    {
+      std::mutex           mutex;
+      std::deque<int>      tasks;       // ready tasks
+    };
+
+                         TaskPool        ( const TaskPool& );
+    TaskPool&            operator =      ( const TaskPool& );
+
+    void                 work_           ( int thread );
+
+    // runs one ready task if there is any
+
+    bool                 runOne_         ( int thread );
+    bool                 pop_            ( int thread, int& task );
+    void                 push_           ( int thread, int task );
+    void                 finish_         ( int thread, int task );
+    bool                 isDone_         ( int task );
+
+    // with mutex_ locked
+
+    inline Record_*      record_         ( int task );
+
+  private:
+
+    static TaskPool*          current_;
+
+    const int                 threadCount_;
+
+    std::mutex                mutex_;       // guards records_, free_
+    std::deque<Record_*>      records_;     // tasks base_,...
+    std::vector<Record_*>     free_;        // recycled records
+    int                       base_;
+
+    std::vector<Queue_*>      queues_;      // one per thread, 0 = the waiting threads
+    std::vector<std::thread>  workers_;
+
+    std::mutex                sleepMutex_;
+    std::condition_variable   wakeUp_;
+    std::atomic<int>          readyCount_;
+    std::atomic<int>          waiting_;     // threads asleep in wait
+    std::atomic<bool>         quit_;
+};
+
+// =====================================================================
+//   implementation of inline functions
+// =====================================================================
+
+inline int TaskPool::getThreadCount () const
+{
+  return threadCount_;
+}
+
+inline TaskPool::Record_* TaskPool::record_ ( int task )
+{
+  return records_[task - base_];
+}
+
+// ---------------------------------------------------------------------
+//    parallelFor
+// ---------------------------------------------------------------------
+
+template <class Body>
+void TaskPool::parallelFor
+
+  ( int       count,
+    Body&     body )
+
+{
+  IntVector  tasks ( count );
+
+  for ( int i = 0; i < count; i++ )
+  {
+    tasks[i] = submit ( [&body,i] () { body ( i ); } );
+  }
+
+  for ( int i = 0; i < count; i++ )
+  {
+    wait ( tasks[i] );
+  }
+}
+
+#endif
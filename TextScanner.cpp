@@ -0,0 +1,229 @@
+#include <cstdlib>
+#include <cstring>
+
+#include "TextScanner.h"
+#include "typedefs.h"
+
+
+const double TextScanner::POW10_[23] =
+{
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+// ------------------------------------------------------------
+//    findLine
+// ------------------------------------------------------------
+
+bool TextScanner::findLine ( const char* tag )
+{
+  const size_t length = strlen ( tag );
+
+  while ( pos_ < end_ )
+  {
+    if ( size_t( end_ - pos_ ) >= length &&
+         strncmp ( pos_, tag, length ) == 0 )
+    {
+      skipLine ();
+      return true;
+    }
+
+    skipLine ();
+  }
+
+  return false;
+}
+
+// ------------------------------------------------------------
+//    toDouble_
+// ------------------------------------------------------------
+
+// mantissa * 10^exponent for the numbers that the single floating
+// point operation of readDouble cannot handle. With more than 19
+// digits the true value lies between mantissa and mantissa + 1,
+// if both round to the same double that is the answer.
+
+double TextScanner::toDouble_
+
+  ( bool         negative,
+    uint64_t     mantissa,
+    int          exponent,
+    bool         truncated,
+    const char*  first )
+
+{
+  double value;
+  double upper;
+
+  if ( eiselLemire_ ( value, mantissa, exponent ) )
+  {
+    if ( !truncated ||
+         ( eiselLemire_ ( upper, mantissa + 1, exponent ) && upper == value ) )
+    {
+      return negative ? -value : value;
+    }
+  }
+
+  return readDoubleSlow_ ( first );
+}
+
+// ------------------------------------------------------------
+//    eiselLemire_
+// ------------------------------------------------------------
+
+// Correctly rounded w * 10^q following D. Lemire, "Number parsing at
+// a gigabyte per second" (2021): w times the 128 bit approximation of
+// 5^q gives the 53+2 leading bits of the result, the power of two is
+// computed directly. Returns false if the product is too close to a
+// rounding boundary to decide.
+
+bool TextScanner::eiselLemire_
+
+  ( double&   value,
+    uint64_t  w,
+    int       q )
+
+{
+  typedef unsigned __int128 uint128;
+
+  const int MANTISSA_BITS = 52;
+  const int MIN_EXPONENT  = -1023;
+  const int INF_POWER     = 0x7FF;
+
+  uint64_t  mantissa;
+  int       power2;
+
+  if ( w == 0 || q < -342 )
+  {
+    value = 0.;
+    return true;
+  }
+
+  if ( q > 308 )
+  {
+    value = numeric_limits<double>::infinity ();
+    return true;
+  }
+
+  const int lz = __builtin_clzll ( w );
+
+  w <<= lz;
+
+  // w * 5^q, the second word of 5^q is only needed if the bits below
+  // the 55 that matter are all ones
+
+  const uint64_t* pow5    = POW5_ + 2 * ( q + 342 );
+
+  uint128         product = uint128( w ) * pow5[0];
+  uint64_t        high    = uint64_t ( product >> 64 );
+  uint64_t        low     = uint64_t ( product );
+
+  if ( ( high & 0x1FF ) == 0x1FF )
+  {
+    uint64_t second = uint64_t ( ( uint128( w ) * pow5[1] ) >> 64 );
+
+    low += second;
+
+    if ( second > low ) high++;
+  }
+
+  if ( low == 0xFFFFFFFFFFFFFFFFULL && ( q < -27 || q > 55 ) )
+  {
+    return false;
+  }
+
+  const int upperbit = int ( high >> 63 );
+
+  mantissa = high >> ( upperbit + 64 - MANTISSA_BITS - 3 );
+  power2   = ( ( ( 152170 + 65536 ) * q ) >> 16 ) + 63
+             + upperbit - lz - MIN_EXPONENT;
+
+  if ( power2 <= 0 )
+  {
+    // subnormal numbers
+
+    if ( -power2 + 1 >= 64 )
+    {
+      mantissa = 0;
+      power2   = 0;
+    }
+    else
+    {
+      mantissa >>= -power2 + 1;
+      mantissa  += mantissa & 1;
+      mantissa >>= 1;
+      power2     = mantissa < ( uint64_t(1) << MANTISSA_BITS ) ? 0 : 1;
+    }
+  }
+  else
+  {
+    // exactly halfway between two doubles: round to even
+
+    if ( low <= 1 && q >= -4 && q <= 23 && ( mantissa & 3 ) == 1 &&
+         ( mantissa << ( upperbit + 64 - MANTISSA_BITS - 3 ) ) == high )
+    {
+      mantissa &= ~uint64_t(1);
+    }
+
+    mantissa  += mantissa & 1;
+    mantissa >>= 1;
+
+    if ( mantissa >= ( uint64_t(2) << MANTISSA_BITS ) )
+    {
+      mantissa = uint64_t(1) << MANTISSA_BITS;
+      power2++;
+    }
+
+    mantissa &= ~( uint64_t(1) << MANTISSA_BITS );
+
+    if ( power2 >= INF_POWER )
+    {
+      mantissa = 0;
+      power2   = INF_POWER;
+    }
+  }
+
+  const uint64_t bits = mantissa | ( uint64_t( power2 ) << MANTISSA_BITS );
+
+  memcpy ( &value, &bits, sizeof(value) );
+
+  return true;
+}
+
+// ------------------------------------------------------------
+//    readDoubleSlow_
+// ------------------------------------------------------------
+
+// strtod rounds correctly; the token is copied since the mapped
+// range is not terminated.
+
+double TextScanner::readDoubleSlow_ ( const char* first )
+{
+  const size_t length = pos_ - first;
+
+  char         buffer[64];
+
+  if ( length < sizeof(buffer) )
+  {
+    memcpy ( buffer, first, length );
+    buffer[length] = '\0';
+
+    return strtod ( buffer, 0 );
+  }
+
+  string token ( first, length );
+
+  return strtod ( token.c_str(), 0 );
+}
+
+// ------------------------------------------------------------
+//    error_
+// ------------------------------------------------------------
+
+void TextScanner::error_ ( const char* what ) const
+{
+  cerr << "invalid " << what << " in mesh file near \""
+       << string ( pos_, min<ptrdiff_t> ( 20, end_ - pos_ ) ) << "\"\n";
+  exit(1);
+}
@@ -0,0 +1,366 @@
+#ifndef TEXT_SCANNER_H
+#define TEXT_SCANNER_H
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+// =====================================================================
+//     class TextScanner
+// =====================================================================
+
+/*
+ * Tokenizer working directly on a character range (typically a
+ * MappedFile). Numbers are converted in place, no strings are built.
+ *
+ * readInt and readDouble skip any white space before the token, like
+ * operator >> does. atEndOfLine only skips blanks, which allows reading
+ * a line with an unknown number of tokens.
+ *
+ * readDouble returns exactly the value strtod (and thus operator >>)
+ * gives. Digits are scanned eight at a time inside a 64 bit word, the
+ * line breaks are searched with memchr. Up to 19 significant digits
+ * are collected in an integer; short numbers are then converted with
+ * one correctly rounded floating point operation, the others with the
+ * Eisel-Lemire algorithm (128 bit powers of five). Only the very rare
+ * cases this cannot decide go through strtod.
+ *
+ * This is the number parser of all ASCII mesh readers.
+ */
+
+class TextScanner
+{
+  public:
+
+                         TextScanner
+
+      ( const char*  first,
+        const char*  last )
+
+      : pos_(first), end_(last) {}
+
+    explicit             TextScanner
+
+      ( const std::string&  text )
+
+      : pos_(text.data()), end_(text.data() + text.size()) {}
+
+    inline bool          atEnd       () const;
+    inline bool          atEndOfLine ();
+    inline bool          atEndOfData ();
+
+    // skip blanks and the delimiter c, if it is the next character
+
+    inline bool          skipChar    ( char c );
+
+    // skip white space and the following word
+
+    inline void          skipWord    ();
+    inline void          skipLine    ();
+
+    // move to the line following the first line starting with tag
+
+    bool                 findLine    ( const char* tag );
+
+    inline int           readInt     ();
+    inline double        readDouble  ();
+
+    const char*          position    () const { return pos_; }
+
+  private:
+
+    inline void          skipSpace_  ();
+
+    static inline bool   isEightDigits_
+
+      ( uint64_t     chunk );
+
+    static inline uint32_t
+                         parseEightDigits_
+
+      ( uint64_t     chunk );
+
+    double               toDouble_
+
+      ( bool         negative,
+        uint64_t     mantissa,
+        int          exponent,
+        bool         truncated,
+        const char*  first );
+
+    static bool          eiselLemire_
+
+      ( double&      value,
+        uint64_t     mantissa,
+        int          exponent );
+
+    double               readDoubleSlow_
+
+      ( const char*  first );
+
+    void                 error_      ( const char* what ) const;
+
+  private:
+
+    const char*          pos_;
+    const char*          end_;
+
+    static const double    POW10_[23];
+    static const uint64_t  POW5_[2 * ( 308 + 342 + 1 )];
+};
+
+// ==========================================================
+//   implementation of inline functions
+// ==========================================================
+
+inline bool TextScanner::atEnd () const
+{
+  return pos_ >= end_;
+}
+
+inline void TextScanner::skipSpace_ ()
+{
+  while ( pos_ < end_ && ( *pos_ == ' '  || *pos_ == '\t' ||
+                           *pos_ == '\r' || *pos_ == '\n' ) )
+  {
+    pos_++;
+  }
+}
+
+inline bool TextScanner::atEndOfLine ()
+{
+  while ( pos_ < end_ && ( *pos_ == ' ' || *pos_ == '\t' || *pos_ == '\r' ) )
+  {
+    pos_++;
+  }
+
+  return pos_ >= end_ || *pos_ == '\n';
+}
+
+// skips all white space, including line breaks
+
+inline bool TextScanner::atEndOfData ()
+{
+  skipSpace_ ();
+
+  return pos_ >= end_;
+}
+
+inline bool TextScanner::skipChar ( char c )
+{
+  if ( atEndOfLine () || *pos_ != c ) return false;
+
+  pos_++;
+
+  return true;
+}
+
+inline void TextScanner::skipWord ()
+{
+  skipSpace_ ();
+
+  while ( pos_ < end_ && *pos_ != ' '  && *pos_ != '\t' &&
+                         *pos_ != '\r' && *pos_ != '\n' )
+  {
+    pos_++;
+  }
+}
+
+inline void TextScanner::skipLine ()
+{
+  const char* eol = (const char*) memchr ( pos_, '\n', end_ - pos_ );
+
+  pos_ = eol ? eol + 1 : end_;
+}
+
+// SWAR (SIMD within a register) digit handling, eight characters
+// loaded as one little endian 64 bit word
+
+inline bool TextScanner::isEightDigits_ ( uint64_t chunk )
+{
+  return ( ( chunk & 0xF0F0F0F0F0F0F0F0ULL ) |
+           ( ( ( chunk + 0x0606060606060606ULL ) &
+               0xF0F0F0F0F0F0F0F0ULL ) >> 4 ) ) == 0x3333333333333333ULL;
+}
+
+inline uint32_t TextScanner::parseEightDigits_ ( uint64_t chunk )
+{
+  const uint64_t mask = 0x000000FF000000FFULL;
+  const uint64_t mul1 = 0x000F424000000064ULL;   // 100 + (1000000 << 32)
+  const uint64_t mul2 = 0x0000271000000001ULL;   // 1   + (10000   << 32)
+
+  chunk -= 0x3030303030303030ULL;
+  chunk  = ( chunk * 10 ) + ( chunk >> 8 );
+  chunk  = ( ( ( chunk & mask ) * mul1 ) +
+             ( ( ( chunk >> 16 ) & mask ) * mul2 ) ) >> 32;
+
+  return uint32_t ( chunk );
+}
+
+inline int TextScanner::readInt ()
+{
+  skipSpace_ ();
+
+  bool negative = false;
+
+  if ( pos_ < end_ && ( *pos_ == '-' || *pos_ == '+' ) )
+  {
+    negative = *pos_++ == '-';
+  }
+
+  if ( pos_ >= end_ || (unsigned)( *pos_ - '0' ) > 9 )
+  {
+    error_ ( "integer" );
+  }
+
+  int value = 0;
+
+  while ( pos_ < end_ && (unsigned)( *pos_ - '0' ) <= 9 )
+  {
+    value = 10 * value + ( *pos_++ - '0' );
+  }
+
+  return negative ? -value : value;
+}
+
+inline double TextScanner::readDouble ()
+{
+  skipSpace_ ();
+
+  const char* first    = pos_;
+  bool        negative = false;
+
+  if ( pos_ < end_ && ( *pos_ == '-' || *pos_ == '+' ) )
+  {
+    negative = *pos_++ == '-';
+  }
+
+  // collect at most 19 significant digits in an integer mantissa
+
+  uint64_t mantissa  = 0;
+  int      digits    = 0;    // significant digits in mantissa
+  int      exponent  = 0;
+  bool     truncated = false;
+  bool     gotDigit  = false;
+
+  uint64_t chunk;
+
+  while ( pos_ < end_ && (unsigned)( *pos_ - '0' ) <= 9 )
+  {
+    gotDigit = true;
+
+    // eight digits at once, once the leading zeros are passed
+
+    if ( digits > 0 && digits <= 11 && end_ - pos_ >= 8 )
+    {
+      memcpy ( &chunk, pos_, 8 );
+
+      if ( isEightDigits_ ( chunk ) )
+      {
+        mantissa  = 100000000 * mantissa + parseEightDigits_ ( chunk );
+        digits   += 8;
+        pos_     += 8;
+
+        continue;
+      }
+    }
+
+    if      ( digits < 19 )
+    {
+      mantissa = 10 * mantissa + ( *pos_ - '0' );
+      if ( mantissa != 0 ) digits++;
+    }
+    else
+    {
+      truncated = true;
+      exponent++;
+    }
+
+    pos_++;
+  }
+
+  if ( pos_ < end_ && *pos_ == '.' )
+  {
+    pos_++;
+
+    while ( pos_ < end_ && (unsigned)( *pos_ - '0' ) <= 9 )
+    {
+      gotDigit = true;
+
+      if ( digits > 0 && digits <= 11 && end_ - pos_ >= 8 )
+      {
+        memcpy ( &chunk, pos_, 8 );
+
+        if ( isEightDigits_ ( chunk ) )
+        {
+          mantissa  = 100000000 * mantissa + parseEightDigits_ ( chunk );
+          digits   += 8;
+          exponent -= 8;
+          pos_     += 8;
+
+          continue;
+        }
+      }
+
+      if ( digits < 19 )
+      {
+        mantissa = 10 * mantissa + ( *pos_ - '0' );
+        if ( mantissa != 0 ) digits++;
+        exponent--;
+      }
+      else
+      {
+        truncated = true;
+      }
+
+      pos_++;
+    }
+  }
+
+  if ( !gotDigit ) error_ ( "real number" );
+
+  if ( pos_ < end_ && ( *pos_ == 'e' || *pos_ == 'E' ) )
+  {
+    pos_++;
+
+    bool negExp = false;
+
+    if ( pos_ < end_ && ( *pos_ == '-' || *pos_ == '+' ) )
+    {
+      negExp = *pos_++ == '-';
+    }
+
+    if ( pos_ >= end_ || (unsigned)( *pos_ - '0' ) > 9 )
+    {
+      error_ ( "real number" );
+    }
+
+    int e = 0;
+
+    while ( pos_ < end_ && (unsigned)( *pos_ - '0' ) <= 9 )
+    {
+      if ( e < 100000 ) e = 10 * e + ( *pos_ - '0' );
+      pos_++;
+    }
+
+    exponent += negExp ? -e : e;
+  }
+
+  // both mantissa and power of ten are exact doubles: a single
+  // multiplication or division rounds correctly
+
+  if ( !truncated && mantissa <= ( uint64_t(1) << 53 ) &&
+       exponent >= -22 && exponent <= 22 )
+  {
+    double value = double ( mantissa );
+
+    value = exponent < 0 ? value / POW10_[-exponent]
+                         : value * POW10_[ exponent];
+
+    return negative ? -value : value;
+  }
+
+  return toDouble_ ( negative, mantissa, exponent, truncated, first );
+}
+
+#endif
@@ -0,0 +1,572 @@
+#include "MeshGenerator.h"
+#include "../ElementTraits.h"
+
+#include <random>
+
+
+// the element types that can be generated; the midside node of edge
+// k of a quadratic element is the middle of EDGES[k] (the Gmsh order)
+
+struct ElemKind_
+{
+  const char*              name;
+  int                      dim;
+  int                      type;
+  int                      cornerCount;
+  int                      nodeCount;
+  int                      edgeCount;
+  const int              (*edges)[2];
+};
+
+static const ElemKind_   ELEM_KINDS_[] =
+{
+  { "tri3",  2, Tri3Traits ::TYPE, 3, Tri3Traits ::NODE_COUNT,  3, Tri3Traits ::EDGES },
+  { "tri6",  2, Tri6Traits ::TYPE, 3, Tri6Traits ::NODE_COUNT,  3, Tri6Traits ::EDGES },
+  { "quad4", 2, Quad4Traits::TYPE, 4, Quad4Traits::NODE_COUNT,  4, Quad4Traits::EDGES },
+  { "quad8", 2, Quad8Traits::TYPE, 4, Quad8Traits::NODE_COUNT,  4, Quad8Traits::EDGES },
+  { "tet4",  3, Tet4Traits ::TYPE, 4, Tet4Traits ::NODE_COUNT,  6, Tet4Traits ::EDGES },
+  { "tet10", 3, Tet10Traits::TYPE, 4, Tet10Traits::NODE_COUNT,  6, Tet10Traits::EDGES },
+  { "hex8",  3, Hex8Traits ::TYPE, 8, Hex8Traits ::NODE_COUNT, 12, Hex8Traits ::EDGES },
+  { "hex20", 3, Hex20Traits::TYPE, 8, Hex20Traits::NODE_COUNT, 12, Hex20Traits::EDGES }
+};
+
+static const int         ELEM_KIND_COUNT_ = 8;
+
+// Gmsh types of the boundary lines of 2D meshes
+
+static const int         LINE2_ = 1;
+static const int         LINE3_ = 8;
+
+static const ElemKind_*  kindOf_
+
+  ( const string&          elemType )
+
+{
+  for ( int ik = 0; ik < ELEM_KIND_COUNT_; ik++ )
+  {
+    if ( elemType == ELEM_KINDS_[ik].name ) return &ELEM_KINDS_[ik];
+  }
+
+  return 0;
+}
+
+// ---------------------------------------------------------------------
+//   cellShape_
+// ---------------------------------------------------------------------
+
+// the elements of one cell: the corners of each element as offsets
+// (0 or 1) along x, y and z, three per corner
+
+static void              cellShape_
+
+  ( vector<IntVector>&     shape,
+    const ElemKind_&       kind )
+
+{
+  static const int QUAD[4][3] = { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0} };
+  static const int HEX [8][3] = { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0},
+                                  {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1} };
+
+  shape.clear ();
+
+  if      ( kind.cornerCount == 3 )
+  {
+    // two triangles on the diagonal (0,0)-(1,1)
+
+    const int tri[2][3] = { {0,1,2}, {0,2,3} };
+
+    for ( int it = 0; it < 2; it++ )
+    {
+      IntVector e;
+
+      for ( int ic = 0; ic < 3; ic++ )
+      {
+        e.insert ( e.end (), QUAD[tri[it][ic]], QUAD[tri[it][ic]] + 3 );
+      }
+
+      shape.push_back ( e );
+    }
+  }
+  else if ( kind.dim == 2 )
+  {
+    shape.push_back ( IntVector ( QUAD[0], QUAD[0] + 12 ) );
+  }
+  else if ( kind.cornerCount == 8 )
+  {
+    shape.push_back ( IntVector ( HEX[0], HEX[0] + 24 ) );
+  }
+  else
+  {
+    // six tets around the diagonal (0,0,0)-(1,1,1), one per order in
+    // which the path along the edges of the cell takes the axes; all
+    // cells are split alike, so the faces match
+
+    int axes[3] = { 0, 1, 2 };
+
+    do
+    {
+      IntVector e ( 12, 0 );
+
+      for ( int ic = 1; ic < 4; ic++ )
+      {
+        for ( int id = 0; id < 3; id++ ) e[3*ic+id] = e[3*(ic-1)+id];
+
+        e[3*ic+axes[ic-1]] = 1;
+      }
+
+      // positive volume: swap the second and third corner if needed
+
+      int u[3], v[3], w[3];
+
+      for ( int id = 0; id < 3; id++ )
+      {
+        u[id] = e[3+id] - e[id];
+        v[id] = e[6+id] - e[id];
+        w[id] = e[9+id] - e[id];
+      }
+
+      const int vol = u[0] * ( v[1] * w[2] - v[2] * w[1] ) -
+                      u[1] * ( v[0] * w[2] - v[2] * w[0] ) +
+                      u[2] * ( v[0] * w[1] - v[1] * w[0] );
+
+      if ( vol < 0 )
+      {
+        swap_ranges ( e.begin () + 3, e.begin () + 6, e.begin () + 6 );
+      }
+
+      shape.push_back ( e );
+    }
+    while ( next_permutation ( axes, axes + 3 ) );
+  }
+}
+
+// =====================================================================
+//   class Grid_
+// =====================================================================
+
+// The points of a mesh: the corners of the cells and, for quadratic
+// elements, the points halfway in between (a grid twice as fine).
+// Points are numbered along x first; only the points used by an
+// element get a node id.
+
+class Grid_
+{
+  public:
+
+                         Grid_
+
+      ( const MeshSpec&    spec,
+        const ElemKind_&   kind );
+
+    // the grid point of the corner (offset ox, oy, oz) of cell (cx, cy, cz)
+
+    inline int           corner
+
+      ( int cx, int cy, int cz,
+        int ox, int oy, int oz ) const;
+
+    // the point halfway between p and q
+
+    inline int           middle ( int p, int q ) const;
+
+    inline void          use    ( int p ) { ids_[p] = 1; }
+
+    // numbers the used points, returns the number of nodes
+
+    int                  numberNodes ();
+
+    inline int           getId  ( int p ) const { return ids_[p]; }
+
+    void                 getCoords
+
+      ( double             x[3],
+        int                p ) const;
+
+    int                  size () const { return ids_.size (); }
+
+  private:
+
+    double               cornerCoord_
+
+      ( int                axis,
+        int                c[3] ) const;
+
+  private:
+
+    int                  dim_;
+    int                  cells_;      // cells along a side
+    int                  step_;       // grid points per cell side
+    int                  points_;     // grid points along a side
+
+    IntVector            ids_;        // node id of each point, 0 if unused
+    vector<double>       shift_;      // random shift of each corner
+};
+
+Grid_::Grid_ ( const MeshSpec& spec, const ElemKind_& kind )
+
+  : dim_(kind.dim), cells_(spec.size),
+    step_(kind.nodeCount > kind.cornerCount ? 2 : 1),
+    points_(spec.size * step_ + 1)
+
+{
+  const int pointCount  = dim_ == 2 ? points_ * points_
+                                    : points_ * points_ * points_;
+  const int cornerCount = dim_ == 2 ? ( cells_+1 ) * ( cells_+1 )
+                                    : ( cells_+1 ) * ( cells_+1 ) * ( cells_+1 );
+
+  ids_  .assign ( pointCount, 0 );
+  shift_.assign ( 3 * cornerCount, 0.0 );
+
+  if ( spec.jitter > 0.0 )
+  {
+    std::mt19937                           random ( spec.seed );
+    std::uniform_real_distribution<double> uniform ( -spec.jitter, spec.jitter );
+
+    for ( int i = 0; i < 3 * cornerCount; i++ )
+    {
+      shift_[i] = uniform ( random ) / cells_;
+    }
+  }
+}
+
+inline int Grid_::corner ( int cx, int cy, int cz,
+                           int ox, int oy, int oz ) const
+{
+  return step_ * ( cx + ox ) + points_ * ( step_ * ( cy + oy ) +
+                                           points_ * step_ * ( cz + oz ) );
+}
+
+inline int Grid_::middle ( int p, int q ) const
+{
+  // the coordinates of p and q along each axis differ by 0 or 2
+
+  return ( p + q ) / 2;
+}
+
+int Grid_::numberNodes ()
+{
+  int nodeCount = 0;
+
+  for ( int p = 0; p < int( ids_.size () ); p++ )
+  {
+    if ( ids_[p] ) ids_[p] = ++nodeCount;
+  }
+
+  return nodeCount;
+}
+
+// Points between corners lie at the mean of the corners around them,
+// so the midside nodes of straight edges stay in the middle. Corners
+// on the boundary only move along it.
+
+void Grid_::getCoords ( double x[3], int p ) const
+{
+  int       i[3] = { p % points_, ( p / points_ ) % points_,
+                     p / ( points_ * points_ ) };
+  int       lo[3], hi[3];
+
+  for ( int a = 0; a < 3; a++ )
+  {
+    lo[a] = i[a] / step_;
+    hi[a] = ( i[a] + step_ - 1 ) / step_;
+    x[a]  = 0.0;
+  }
+
+  if ( dim_ == 2 ) lo[2] = hi[2] = 0;
+
+  int       count = 0;
+  int       c[3];
+
+  for ( c[2] = lo[2]; c[2] <= hi[2]; c[2]++ )
+  {
+    for ( c[1] = lo[1]; c[1] <= hi[1]; c[1]++ )
+    {
+      for ( c[0] = lo[0]; c[0] <= hi[0]; c[0]++ )
+      {
+        for ( int a = 0; a < 3; a++ ) x[a] += cornerCoord_ ( a, c );
+
+        count++;
+      }
+    }
+  }
+
+  for ( int a = 0; a < 3; a++ ) x[a] /= count;
+}
+
+double Grid_::cornerCoord_ ( int axis, int c[3] ) const
+{
+  if ( axis >= dim_ ) return 0.0;
+
+  const int n = c[0] + ( cells_+1 ) * ( c[1] + ( cells_+1 ) * c[2] );
+  double    x = double( c[axis] ) / cells_;
+
+  if ( c[axis] > 0 && c[axis] < cells_ ) x += shift_[3*n+axis];
+
+  return x;
+}
+
+// =====================================================================
+//     MeshSpec
+// =====================================================================
+
+MeshSpec::MeshSpec ()
+
+  : elemType("tri3"), size(10), domainCount(2), grainCount(0),
+    jitter(0.0), seed(1)
+
+{}
+
+// =====================================================================
+//     elementCountOf
+// =====================================================================
+
+long                     elementCountOf
+
+  ( const MeshSpec&        spec )
+
+{
+  const ElemKind_* kind  = kindOf_ ( spec.elemType );
+
+  if ( !kind ) return 0;
+
+  vector<IntVector> shape;
+
+  cellShape_ ( shape, *kind );
+
+  long cells = long( spec.size ) * spec.size;
+
+  if ( kind->dim == 3 ) cells *= spec.size;
+
+  return cells * shape.size ();
+}
+
+// =====================================================================
+//     isKnownElemType
+// =====================================================================
+
+bool                     isKnownElemType
+
+  ( const string&          elemType )
+
+{
+  return kindOf_ ( elemType ) != 0;
+}
+
+// =====================================================================
+//     generateMesh
+// =====================================================================
+
+void                     generateMesh
+
+  ( const MeshSpec&        spec,
+    const char*            fileName )
+
+{
+  const ElemKind_* kind = kindOf_ ( spec.elemType );
+
+  if ( !kind || spec.size < 1 )
+  {
+    cerr << "Unknown element type or size " << spec.elemType
+         << " " << spec.size << "!!!\n";
+    exit(1);
+  }
+
+  const int        n         = spec.size;
+  const int        nz        = kind->dim == 3 ? n : 1;
+  const int        nodeCount = kind->nodeCount;
+  const int        ncorner   = kind->cornerCount;
+
+  Grid_            grid ( spec, *kind );
+
+  vector<IntVector> shape;
+
+  cellShape_ ( shape, *kind );
+
+  // the grains: random seeds, an element belongs to the nearest one
+
+  vector<double>   seeds;
+
+  if ( spec.grainCount > 0 )
+  {
+    std::mt19937                           random ( spec.seed + 1 );
+    std::uniform_real_distribution<double> uniform ( 0.0, 1.0 );
+
+    seeds.resize ( 3 * spec.grainCount );
+
+    for ( int i = 0; i < 3 * spec.grainCount; i++ )
+    {
+      seeds[i] = ( kind->dim == 2 && i % 3 == 2 ) ? 0.0 : uniform ( random );
+    }
+  }
+
+  // the bulk elements, as grid points
+
+  const long       elemCount = elementCountOf ( spec );
+
+  IntVector        connec   ( elemCount * nodeCount );
+  IntVector        domains  ( elemCount );
+
+  long             ie = 0;
+
+  for ( int cz = 0; cz < nz; cz++ )
+  {
+    for ( int cy = 0; cy < n; cy++ )
+    {
+      for ( int cx = 0; cx < n; cx++ )
+      {
+        for ( size_t is = 0; is < shape.size (); is++, ie++ )
+        {
+          const IntVector& off  = shape[is];
+          int*             conn = &connec[ie * nodeCount];
+          double           c[3] = { 0.0, 0.0, 0.0 };
+
+          for ( int ic = 0; ic < ncorner; ic++ )
+          {
+            conn[ic] = grid.corner ( cx, cy, cz,
+                                     off[3*ic], off[3*ic+1], off[3*ic+2] );
+
+            double x[3];
+
+            grid.getCoords ( x, conn[ic] );
+
+            for ( int a = 0; a < 3; a++ ) c[a] += x[a] / ncorner;
+          }
+
+          for ( int in = ncorner; in < nodeCount; in++ )
+          {
+            const int* edge = kind->edges[in - ncorner];
+
+            conn[in] = grid.middle ( conn[edge[0]], conn[edge[1]] );
+          }
+
+          for ( int in = 0; in < nodeCount; in++ ) grid.use ( conn[in] );
+
+          // the domain of the element, from its centroid
+
+          if ( spec.grainCount > 0 )
+          {
+            int    best  = 0;
+            double bestD = 1.0e30;
+
+            for ( int ig = 0; ig < spec.grainCount; ig++ )
+            {
+              double d = 0.0;
+
+              for ( int a = 0; a < 3; a++ )
+              {
+                d += ( c[a] - seeds[3*ig+a] ) * ( c[a] - seeds[3*ig+a] );
+              }
+
+              if ( d < bestD ) { bestD = d; best = ig; }
+            }
+
+            domains[ie] = best + 1;
+          }
+          else
+          {
+            domains[ie] = 1 + min ( int( c[0] * spec.domainCount ),
+                                    spec.domainCount - 1 );
+          }
+        }
+      }
+    }
+  }
+
+  // the boundary lines of a 2D mesh, anticlockwise, tagged 11 (bottom),
+  // 12 (right), 13 (top) and 14 (left)
+
+  IntVector        lines;
+  IntVector        lineTags;
+
+  const int        lineNodes = nodeCount > ncorner ? 3 : 2;
+
+  if ( kind->dim == 2 )
+  {
+    for ( int side = 0; side < 4; side++ )
+    {
+      for ( int i = 0; i < n; i++ )
+      {
+        int p, q;
+
+        switch ( side )
+        {
+          case 0:  p = grid.corner ( i,   0,   0, 0, 0, 0 );
+                   q = grid.corner ( i+1, 0,   0, 0, 0, 0 ); break;
+          case 1:  p = grid.corner ( n,   i,   0, 0, 0, 0 );
+                   q = grid.corner ( n,   i+1, 0, 0, 0, 0 ); break;
+          case 2:  p = grid.corner ( i+1, n,   0, 0, 0, 0 );
+                   q = grid.corner ( i,   n,   0, 0, 0, 0 ); break;
+          default: p = grid.corner ( 0,   i+1, 0, 0, 0, 0 );
+                   q = grid.corner ( 0,   i,   0, 0, 0, 0 ); break;
+        }
+
+        lines.push_back ( p );
+        lines.push_back ( q );
+
+        if ( lineNodes == 3 ) lines.push_back ( grid.middle ( p, q ) );
+
+        lineTags.push_back ( 11 + side );
+      }
+    }
+  }
+
+  const int        pointCount = grid.numberNodes ();
+
+  // write it all
+
+  ofstream         file ( fileName, std::ios::out );
+
+  if ( !file )
+  {
+    cerr << "Unable to open " << fileName << "!!!\n";
+    exit(1);
+  }
+
+  file.precision ( 12 );
+
+  file << "$MeshFormat\n2.2 0 8\n$EndMeshFormat\n";
+  file << "$Nodes\n" << pointCount << "\n";
+
+  for ( int p = 0; p < grid.size (); p++ )
+  {
+    if ( !grid.getId ( p ) ) continue;
+
+    double x[3];
+
+    grid.getCoords ( x, p );
+
+    file << grid.getId ( p ) << " " << x[0] << " " << x[1] << " " << x[2] << "\n";
+  }
+
+  file << "$EndNodes\n";
+  file << "$Elements\n" << lineTags.size () + elemCount << "\n";
+
+  long             id = 0;
+
+  for ( size_t il = 0; il < lineTags.size (); il++ )
+  {
+    file << ++id << " " << ( lineNodes == 3 ? LINE3_ : LINE2_ )
+         << " 2 " << lineTags[il] << " " << lineTags[il];
+
+    for ( int in = 0; in < lineNodes; in++ )
+    {
+      file << " " << grid.getId ( lines[il * lineNodes + in] );
+    }
+
+    file << "\n";
+  }
+
+  for ( long je = 0; je < elemCount; je++ )
+  {
+    file << ++id << " " << kind->type << " 2 " << domains[je] << " " << domains[je];
+
+    for ( int in = 0; in < nodeCount; in++ )
+    {
+      file << " " << grid.getId ( connec[je * nodeCount + in] );
+    }
+
+    file << "\n";
+  }
+
+  file << "$EndElements\n";
+}
@@ -0,0 +1,51 @@
+#ifndef MESH_GENERATOR_H
+#define MESH_GENERATOR_H
+
+#include "../typedefs.h"
+
+// =====================================================================
+//     struct MeshSpec
+// =====================================================================
+
+/*
+ * A synthetic mesh of the unit square (2D types) or unit cube (3D
+ * types) with size cells along each side. Every cell is one quad or
+ * hex, two triangles or six tets. The elements are tagged with
+ * domainCount slabs along x, or with grainCount Voronoi grains around
+ * random seeds if grainCount > 0 (a polycrystal). With jitter > 0
+ * the inner corners are moved at random by up to jitter cells, so the
+ * elements are no longer all alike.
+ */
+
+struct MeshSpec
+{
+  string                   elemType;     // tri3 tri6 quad4 quad8 tet4 tet10 hex8 hex20
+  int                      size;
+  int                      domainCount;
+  int                      grainCount;
+  double                   jitter;
+  unsigned                 seed;
+
+                           MeshSpec ();
+};
+
+// the number of elements of spec (without boundary elements)
+
+long                     elementCountOf
+
+  ( const MeshSpec&        spec );
+
+// true if elemType is one of the types above
+
+bool                     isKnownElemType
+
+  ( const string&          elemType );
+
+// writes the mesh of spec to fileName (Gmsh 2.2 ASCII)
+
+void                     generateMesh
+
+  ( const MeshSpec&        spec,
+    const char*            fileName );
+
+#endif
@@ -0,0 +1,382 @@
+/**
+ * End-to-end scaling benchmark of the interface element generator.
+ *
+ * For each element type and mesh size a mesh is generated (see
+ * MeshGenerator.h): one tagged with slabs along x for --everywhere,
+ * --interface, --domain and --converter, and one tagged with Voronoi
+ * grains for --polycrystal. The program is then run in every mode with
+ * every thread count, with --profile, and the fastest of a few runs is
+ * reported: wall time, speedup over the first thread count, time per
+ * element and peak memory. The same table is written to scaling.csv in
+ * the work directory. The report starts with the build flags of the
+ * program (--flags), "make benchmark" passes those of its optimized
+ * build.
+ *
+ * Usage (see also "make benchmark"):
+ *
+ *   ./benchmark --program ../interface-elem --types tri3,hex8
+ *               --sizes-2d 32,64,128 --sizes-3d 8,16 --threads 1,2,4
+ */
+
+#include "MeshGenerator.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <sys/wait.h>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
+
+
+// one run of the program (the best of the repetitions)
+
+struct Result_
+{
+  bool                     ok;
+  int                      status;
+  double                   wallTime;
+  long                     peakRss;
+};
+
+// ---------------------------------------------------------------------
+//   helpers
+// ---------------------------------------------------------------------
+
+static IntVector         toInts_
+
+  ( const string&          list )
+
+{
+  StrVector  words;
+  IntVector  ints;
+
+  boost::split ( words, list, boost::is_any_of(",") );
+
+  for ( size_t i = 0; i < words.size (); i++ )
+  {
+    if ( !words[i].empty () ) ints.push_back ( boost::lexical_cast<int> ( words[i] ) );
+  }
+
+  return ints;
+}
+
+static StrVector         toWords_
+
+  ( const string&          list )
+
+{
+  StrVector  words;
+
+  boost::split ( words, list, boost::is_any_of(",") );
+
+  words.erase ( remove ( words.begin (), words.end (), string() ), words.end () );
+
+  return words;
+}
+
+static bool              is3D_
+
+  ( const string&          elemType )
+
+{
+  return elemType.compare ( 0, 3, "tet" ) == 0 ||
+         elemType.compare ( 0, 3, "hex" ) == 0;
+}
+
+// the number after "key": at its last occurrence in text (the totals of
+// a profile come after the phases)
+
+static double            lastValue_
+
+  ( const string&          text,
+    const string&          key )
+
+{
+  const size_t pos = text.rfind ( "\"" + key + "\": " );
+
+  if ( pos == string::npos ) return 0.0;
+
+  return atof ( text.c_str () + pos + key.size () + 4 );
+}
+
+static const char*       modeArgs_
+
+  ( const string&          mode )
+
+{
+  if ( mode == "everywhere"  ) return "--everywhere";
+  if ( mode == "interface"   ) return "--interface";
+  if ( mode == "domain"      ) return "--domain 1";
+  if ( mode == "polycrystal" ) return "--polycrystal";
+  if ( mode == "converter"   ) return "--converter";
+
+  return 0;
+}
+
+// ---------------------------------------------------------------------
+//   runProgram_
+// ---------------------------------------------------------------------
+
+static Result_           runProgram_
+
+  ( const string&          program,
+    const string&          dir,
+    const string&          meshFile,
+    const string&          mode,
+    int                    threadCount,
+    int                    repeatCount )
+
+{
+  const string profile = dir + "/profile.json";
+
+  std::ostringstream cmd;
+
+  cmd << program
+      << " --mesh-file "      << meshFile
+      << " --out-file "       << dir << "/out.mesh"
+      << " --interface-file " << dir << "/out-interface.mesh"
+      << " --paraview-file "  << dir << "/out.vtu"
+      << " "                  << modeArgs_ ( mode )
+      << " --threads "        << threadCount
+      << " --profile "        << profile
+      << " > "                << dir << "/run.log 2>&1";
+
+  Result_ best = { false, 0, 0.0, 0 };
+
+  for ( int ir = 0; ir < repeatCount; ir++ )
+  {
+    remove ( profile.c_str () );
+
+    const int status = system ( cmd.str().c_str() );
+
+    if ( status != 0 )
+    {
+      best.ok     = false;
+      best.status = WIFEXITED ( status ) ? WEXITSTATUS ( status )
+                                         : 128 + WTERMSIG ( status );
+      return best;
+    }
+
+    ifstream           in ( profile.c_str () );
+    std::ostringstream text;
+
+    text << in.rdbuf ();
+
+    const double wall = lastValue_ ( text.str(), "wallTime" );
+
+    if ( !best.ok || wall < best.wallTime )
+    {
+      best.ok       = true;
+      best.wallTime = wall;
+      best.peakRss  = long( lastValue_ ( text.str(), "peakRss" ) );
+    }
+  }
+
+  return best;
+}
+
+// =====================================================================
+//     main program
+// =====================================================================
+
+int main ( int argc, char* argv[] )
+{
+  string     program     ( "../interface-elem" );
+  string     flags       ( "unknown" );
+  string     dir         ( "bench-out" );
+
+  StrVector  types       = toWords_ ( "tri3,tri6,quad4,quad8,tet4,tet10,hex8,hex20" );
+  StrVector  modes       = toWords_ ( "everywhere,interface,domain,polycrystal,converter" );
+  IntVector  sizes2D     = toInts_  ( "32,64,128" );
+  IntVector  sizes3D     = toInts_  ( "6,12,24" );
+  IntVector  threads     = toInts_  ( "1,2,4" );
+
+  MeshSpec   spec;
+
+  int        grainCount  = 12;
+  int        repeatCount = 3;
+  bool       keep        = false;
+
+  spec.domainCount = 3;
+  spec.jitter      = 0.2;
+
+  for ( int i = 1; i < argc; i++ )
+  {
+    const string arg ( argv[i] );
+
+    if ( arg != "--help" && arg != "--keep" && i + 1 >= argc )
+    {
+      cerr << "missing value for " << arg << "!!!\n";
+      return 1;
+    }
+
+    if      ( arg == "--program"  ) program          = argv[++i];
+    else if ( arg == "--flags"    ) flags            = argv[++i];
+    else if ( arg == "--dir"      ) dir              = argv[++i];
+    else if ( arg == "--types"    ) types            = toWords_ ( argv[++i] );
+    else if ( arg == "--modes"    ) modes            = toWords_ ( argv[++i] );
+    else if ( arg == "--sizes-2d" ) sizes2D          = toInts_  ( argv[++i] );
+    else if ( arg == "--sizes-3d" ) sizes3D          = toInts_  ( argv[++i] );
+    else if ( arg == "--threads"  ) threads          = toInts_  ( argv[++i] );
+    else if ( arg == "--domains"  ) spec.domainCount = boost::lexical_cast<int>      ( argv[++i] );
+    else if ( arg == "--grains"   ) grainCount       = boost::lexical_cast<int>      ( argv[++i] );
+    else if ( arg == "--jitter"   ) spec.jitter      = boost::lexical_cast<double>   ( argv[++i] );
+    else if ( arg == "--seed"     ) spec.seed        = boost::lexical_cast<unsigned> ( argv[++i] );
+    else if ( arg == "--repeat"   ) repeatCount      = boost::lexical_cast<int>      ( argv[++i] );
+    else if ( arg == "--keep"     ) keep             = true;
+    else if ( arg == "--help" )
+    {
+      cout << "USAGE:\n";
+      cout << "  * --program  FILE        the interface element generator (../interface-elem)\n";
+      cout << "  * --flags    STR         the build flags of the program, for the report (unknown)\n";
+      cout << "  * --dir      DIR         work directory for meshes and results (bench-out)\n";
+      cout << "  * --types    T1,T2,...   element types (tri3,tri6,quad4,quad8,tet4,tet10,hex8,hex20)\n";
+      cout << "  * --modes    M1,M2,...   modes (everywhere,interface,domain,polycrystal,converter)\n";
+      cout << "  * --sizes-2d N1,N2,...   cells per side of the 2D meshes (32,64,128)\n";
+      cout << "  * --sizes-3d N1,N2,...   cells per side of the 3D meshes (6,12,24)\n";
+      cout << "  * --threads  T1,T2,...   thread counts (1,2,4)\n";
+      cout << "  * --domains  N           domains of the multi-domain meshes (3)\n";
+      cout << "  * --grains   N           grains of the polycrystal meshes (12)\n";
+      cout << "  * --jitter   X           random shift of the inner nodes, in cells (0.2)\n";
+      cout << "  * --seed     N           seed of the random numbers (1)\n";
+      cout << "  * --repeat   N           runs per case, the fastest counts (3)\n";
+      cout << "  * --keep                 keep the generated meshes\n";
+      cout << endl;
+      return 0;
+    }
+    else
+    {
+      cerr << "invalid argument, use \"--help\" for more information\n";
+      return 1;
+    }
+  }
+
+  for ( size_t it = 0; it < types.size (); it++ )
+  {
+    if ( !isKnownElemType ( types[it] ) )
+    {
+      cerr << "unknown element type " << types[it] << "!!!\n";
+      return 1;
+    }
+  }
+
+  for ( size_t im = 0; im < modes.size (); im++ )
+  {
+    if ( !modeArgs_ ( modes[im] ) )
+    {
+      cerr << "unknown mode " << modes[im] << "!!!\n";
+      return 1;
+    }
+  }
+
+  if ( system ( ( "mkdir -p " + dir ).c_str () ) != 0 )
+  {
+    cerr << "Unable to create " << dir << "!!!\n";
+    return 1;
+  }
+
+  ofstream   csv ( ( dir + "/scaling.csv" ).c_str (), std::ios::out );
+
+  csv << "type,mode,size,elements,threads,status,wallTime,speedup,usPerElement,peakRss\n";
+
+  cout << "program " << program << " built with " << flags << "\n\n";
+
+  cout << "type   mode         size  elements threads    wall [s]  speedup  us/elem  peak [MB]\n";
+
+  for ( size_t it = 0; it < types.size (); it++ )
+  {
+    spec.elemType = types[it];
+
+    const IntVector& sizes = is3D_ ( spec.elemType ) ? sizes3D : sizes2D;
+
+    for ( size_t is = 0; is < sizes.size (); is++ )
+    {
+      spec.size = sizes[is];
+
+      const long   elemCount = elementCountOf ( spec );
+      const string stem      = dir + "/" + spec.elemType + "-" +
+                               boost::lexical_cast<string> ( spec.size );
+
+      // the meshes are made when a mode first needs them
+
+      string       domMesh, polyMesh;
+
+      for ( size_t im = 0; im < modes.size (); im++ )
+      {
+        const string& mode = modes[im];
+
+        string*       mesh = mode == "polycrystal" ? &polyMesh : &domMesh;
+
+        if ( mesh->empty () )
+        {
+          MeshSpec s = spec;
+
+          if ( mode == "polycrystal" )
+          {
+            s.grainCount = grainCount;
+            *mesh        = stem + "-poly.msh";
+          }
+          else
+          {
+            *mesh        = stem + "-dom.msh";
+          }
+
+          generateMesh ( s, mesh->c_str () );
+        }
+
+        double baseTime = 0.0;
+
+        for ( size_t ith = 0; ith < threads.size (); ith++ )
+        {
+          const Result_ r = runProgram_ ( program, dir, *mesh, mode,
+                                          threads[ith], repeatCount );
+
+          if ( ith == 0 ) baseTime = r.ok ? r.wallTime : 0.0;
+
+          const double speedup  = r.ok && baseTime > 0.0 ? baseTime / r.wallTime : 0.0;
+          const double perElem  = r.ok ? 1.0e6 * r.wallTime / elemCount : 0.0;
+          const double peakMB   = r.peakRss / ( 1024.0 * 1024.0 );
+
+          char line[256];
+
+          if ( r.ok )
+          {
+            snprintf ( line, sizeof(line),
+                       "%-6s %-12s %4d %9ld %7d %11.4f %8.2f %8.3f %10.1f\n",
+                       spec.elemType.c_str (), mode.c_str (), spec.size, elemCount,
+                       threads[ith], r.wallTime, speedup, perElem, peakMB );
+          }
+          else
+          {
+            snprintf ( line, sizeof(line),
+                       "%-6s %-12s %4d %9ld %7d      failed (exit status %d)\n",
+                       spec.elemType.c_str (), mode.c_str (), spec.size, elemCount,
+                       threads[ith], r.status );
+          }
+
+          cout << line << flush;
+
+          csv << spec.elemType << "," << mode << "," << spec.size << ","
+              << elemCount << "," << threads[ith] << ","
+              << ( r.ok ? 0 : r.status ) << "," << r.wallTime << ","
+              << speedup << "," << perElem << "," << r.peakRss << "\n";
+        }
+      }
+
+      if ( !keep )
+      {
+        if ( !domMesh .empty () ) remove ( domMesh .c_str () );
+        if ( !polyMesh.empty () ) remove ( polyMesh.c_str () );
+      }
+    }
+  }
+
+  const char* outputs[] = { "/out.mesh", "/out-interface.mesh", "/out.vtu",
+                            "/profile.json", "/run.log" };
+
+  for ( int i = 0; i < 5; i++ ) remove ( ( dir + outputs[i] ).c_str () );
+
+  cout << "\nresults written to " << dir << "/scaling.csv\n";
+
+  return 0;
+}
@@ -0,0 +1,541 @@
+/**
+ * Microbenchmarks of the Element and builder primitives.
+ *
+ * For each element type a mesh is generated (MeshGenerator.h), read and
+ * torn as in a --everywhere run, so the kernels see the data of a real
+ * run. The kernels of the material interface builders (isOnInterface,
+ * isInterfaceElement) get the same mesh torn as in a --interface run
+ * instead. Every kernel then sweeps over all elements (or nodes, or edges)
+ * of that mesh. A sample is as many sweeps as fit in --sample-time
+ * seconds; the time and cycle count per call are reported as the
+ * median, minimum and standard deviation over --samples samples, after
+ * one sweep to warm up. The report starts with the build flags
+ * (--flags), "make microbench" passes BENCH_CFLAGS.
+ *
+ * Usage (see also "make microbench"):
+ *
+ *   ./microbench --types tri3,hex20 --kernels isInterfaceElement,findCommonEdge
+ */
+
+#include "MeshGenerator.h"
+
+#include "../Global.h"
+#include "../Element.h"
+#include "../MeshReader.h"
+#include "../MeshModifier.h"
+#include "../InterfaceBuilder.h"
+
+#include <cmath>
+#include <sstream>
+#include <functional>
+
+#include <time.h>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+static inline unsigned long long  cycleCount_ () { return __rdtsc (); }
+#else
+static inline unsigned long long  cycleCount_ () { return 0; }
+#endif
+
+
+// one sweep of a kernel, returns the number of calls made
+
+typedef std::function<long ()>    Sweep;
+
+// the results of a kernel
+
+struct Stats_
+{
+  long                     calls;       // per sweep
+  double                   median;      // ns per call
+  double                   minimum;
+  double                   stdDev;
+  double                   cycles;      // median cycles per call
+};
+
+// keeps the compiler from dropping the work of the kernels
+
+static volatile long       sink_ = 0;
+
+static double            now_ ()
+{
+  struct timespec t;
+
+  clock_gettime ( CLOCK_MONOTONIC, &t );
+
+  return t.tv_sec + 1.0e-9 * t.tv_nsec;
+}
+
+static StrVector         toWords_
+
+  ( const string&          list )
+
+{
+  StrVector  words;
+
+  boost::split ( words, list, boost::is_any_of(",") );
+
+  words.erase ( remove ( words.begin (), words.end (), string() ), words.end () );
+
+  return words;
+}
+
+// ---------------------------------------------------------------------
+//   measure_
+// ---------------------------------------------------------------------
+
+static Stats_            measure_
+
+  ( const Sweep&           sweep,
+    int                    sampleCount,
+    double                 sampleTime )
+
+{
+  Stats_ stats = { 0, 0.0, 0.0, 0.0, 0.0 };
+
+  // warm up and find the number of sweeps per sample
+
+  double t0 = now_ ();
+
+  stats.calls = sweep ();
+
+  const double once   = max ( now_ () - t0, 1.0e-9 );
+  const int    sweeps = max ( 1, int( sampleTime / once ) );
+
+  if ( stats.calls == 0 ) return stats;
+
+  vector<double> times  ( sampleCount );
+  vector<double> cycles ( sampleCount );
+
+  for ( int is = 0; is < sampleCount; is++ )
+  {
+    long                     calls = 0;
+    const unsigned long long c0    = cycleCount_ ();
+
+    t0 = now_ ();
+
+    for ( int iw = 0; iw < sweeps; iw++ ) calls += sweep ();
+
+    const double             t1    = now_ ();
+    const unsigned long long c1    = cycleCount_ ();
+
+    times [is] = 1.0e9 * ( t1 - t0 ) / calls;
+    cycles[is] = double( c1 - c0 ) / calls;
+  }
+
+  double mean = 0.0;
+  double var  = 0.0;
+
+  for ( int is = 0; is < sampleCount; is++ ) mean += times[is] / sampleCount;
+  for ( int is = 0; is < sampleCount; is++ )
+  {
+    var += ( times[is] - mean ) * ( times[is] - mean ) / sampleCount;
+  }
+
+  sort ( times .begin (), times .end () );
+  sort ( cycles.begin (), cycles.end () );
+
+  stats.median  = times [sampleCount / 2];
+  stats.minimum = times [0];
+  stats.stdDev  = sqrt  ( var );
+  stats.cycles  = cycles[sampleCount / 2];
+
+  return stats;
+}
+
+// ---------------------------------------------------------------------
+//   loadMesh_
+// ---------------------------------------------------------------------
+
+// reads and tears fileName as a --everywhere run does, or as a
+// --interface run if interface is true; the progress messages of the
+// program are dropped
+
+static void              loadMesh_
+
+  ( Global&                globdat,
+    const string&          fileName,
+    bool                   interface )
+
+{
+  std::ostringstream  quiet;
+  std::streambuf*     out = cout.rdbuf ( quiet.rdbuf () );
+
+  if ( interface )
+  {
+    globdat.isInterface  = true;
+    globdat.isEveryWhere = false;
+  }
+
+  readMesh           ( globdat, fileName.c_str () );
+  MeshModifier::doIt ( globdat );
+
+  cout.rdbuf ( out );
+}
+
+// ---------------------------------------------------------------------
+//   addKernels_
+// ---------------------------------------------------------------------
+
+// the kernels that apply to the mesh in globdat (torn everywhere) and
+// ifacedat (torn along the material interfaces), by name; they refer
+// to both, which must outlive them
+
+static void              addKernels_
+
+  ( vector<pair<string,Sweep> >&  kernels,
+    Global&                       globdat,
+    Global&                       ifacedat )
+
+{
+  const int        elemCount = globdat.elemSet.size ();
+
+  kernels.clear ();
+
+  if ( globdat.is3D )
+  {
+    kernels.push_back ( make_pair ( string ( "getSortedFaces" ), Sweep ( [&globdat, elemCount] ()
+    {
+      vector<IntVector> faces;
+
+      for ( int ie = 0; ie < elemCount; ie++ )
+      {
+        globdat.elemSet[ie]->getSortedFaces ( faces );
+        sink_ += faces.size ();
+      }
+
+      return long( elemCount );
+    } ) ) );
+
+    kernels.push_back ( make_pair ( string ( "getSortedFaces0" ), Sweep ( [&globdat, elemCount] ()
+    {
+      vector<IntVector> faces;
+
+      for ( int ie = 0; ie < elemCount; ie++ )
+      {
+        globdat.elemSet[ie]->getSortedFaces0 ( faces );
+        sink_ += faces.size ();
+      }
+
+      return long( elemCount );
+    } ) ) );
+  }
+
+  // replaces a node by itself: the search, without changing the mesh
+
+  kernels.push_back ( make_pair ( string ( "changeConnectivity" ), Sweep ( [&globdat, elemCount] ()
+  {
+    for ( int ie = 0; ie < elemCount; ie++ )
+    {
+      const int n = globdat.elemSet[ie]->getNodes ()[globdat.elemSet[ie]->getCornerCount () - 1];
+
+      globdat.elemSet[ie]->changeConnectivity ( n, n );
+    }
+
+    return long( elemCount );
+  } ) ) );
+
+  if ( globdat.is3D )
+  {
+    kernels.push_back ( make_pair ( string ( "isOnInterface" ), Sweep ( [&ifacedat, elemCount] ()
+    {
+      IntVector face;
+      int       oppVertex, fIndex;
+
+      for ( int ie = 0; ie < elemCount; ie++ )
+      {
+        sink_ += ifacedat.elemSet[ie]->isOnInterface ( face, oppVertex, fIndex,
+                                             ifacedat.nodeSet,
+                                             ifacedat.nodeId2Position );
+      }
+
+      return long( elemCount );
+    } ) ) );
+  }
+
+  kernels.push_back ( make_pair ( string ( "isInterfaceElement" ), Sweep ( [&ifacedat, elemCount] ()
+  {
+    for ( int ie = 0; ie < elemCount; ie++ )
+    {
+      sink_ += ifacedat.elemSet[ie]->isInterfaceElement ( ifacedat.nodeSet,
+                                                ifacedat.nodeId2Position );
+    }
+
+    return long( elemCount );
+  } ) ) );
+
+  // the first edge of each element under the ids of a neighbor that
+  // shares it, as torn, so that the search finds that neighbor; edges
+  // on the boundary keep the ids of the element and are not found
+
+  vector<pair<int,int> > edges ( elemCount );
+
+  for ( int ie = 0; ie < elemCount; ie++ )
+  {
+    const IntSpan inodes    = globdat.elemSet[ie]->getNodes0 ();
+    const IntSpan tnodes    = globdat.elemSet[ie]->getNodes  ();
+    const int     sideCount = globdat.elemNeighbors.getSideCount ( ie );
+
+    edges[ie] = make_pair ( tnodes[0], tnodes[1] );
+
+    for ( int is = 0; is < sideCount; is++ )
+    {
+      const int je = globdat.elemNeighbors.getNeighbor ( ie, is );
+
+      if ( je == DualGraph::NONE ) continue;
+
+      const int*  jnodes0 = globdat.elemStore.getConnectivity0 ( je );
+      const int*  jnodes  = globdat.elemStore.getConnectivity  ( je );
+      const int   ncorner = globdat.elemSet[je]->getCornerCount ();
+
+      const int*  p1      = find ( jnodes0, jnodes0 + ncorner, inodes[0] );
+      const int*  p2      = find ( jnodes0, jnodes0 + ncorner, inodes[1] );
+
+      if ( p1 != jnodes0 + ncorner && p2 != jnodes0 + ncorner )
+      {
+        edges[ie] = make_pair ( jnodes[p1 - jnodes0], jnodes[p2 - jnodes0] );
+        break;
+      }
+    }
+  }
+
+  kernels.push_back ( make_pair ( string ( "getIndexElementContainsEdge" ), Sweep ( [&globdat, elemCount, edges] ()
+  {
+    for ( int ie = 0; ie < elemCount; ie++ )
+    {
+      sink_ += globdat.elemSet[ie]->getIndexElementContainsEdge ( globdat, edges[ie].first,
+                                                                  edges[ie].second );
+    }
+
+    return long( elemCount );
+  } ) ) );
+
+  if ( globdat.is3D )
+  {
+    kernels.push_back ( make_pair ( string ( "getIndexElementContainsFace" ), Sweep ( [&globdat, elemCount] ()
+    {
+      vector<IntVector> faces;
+
+      for ( int ie = 0; ie < elemCount; ie++ )
+      {
+        globdat.elemSet[ie]->getSortedFaces ( faces );
+
+        sink_ += globdat.elemSet[ie]->getIndexElementContainsFace ( globdat, faces[0] );
+      }
+
+      return long( elemCount );
+    } ) ) );
+  }
+
+  kernels.push_back ( make_pair ( string ( "Segment::isOn" ), Sweep ( [&globdat, elemCount] ()
+  {
+    static Segment   segment ( Point ( 0.0, 0.5 ), Point ( 1.0, 0.5 ) );
+
+    const NodeStore& nodes     = globdat.nodeSet;
+    const int        nodeCount = nodes.size ();
+
+    for ( int in = 0; in < nodeCount; in++ )
+    {
+      sink_ += segment.isOn ( nodes.getX ( in ), nodes.getY ( in ) );
+    }
+
+    return long( nodeCount );
+  } ) ) );
+
+  if ( !globdat.is3D )
+  {
+    kernels.push_back ( make_pair ( string ( "addInterface" ), Sweep ( [&globdat, elemCount] ()
+    {
+      IntVector        interConnec ( globdat.isQuadratic ? 6 : 4 );
+      long             calls = 0;
+
+      // the edges of which all nodes have a copy
+
+      for ( int ie = 0; ie < elemCount; ie++ )
+      {
+        const IntSpan inodes  = globdat.elemSet[ie]->getNodes0 ();
+        const int     ncorner = globdat.elemSet[ie]->getCornerCount ();
+
+        for ( int in = 0; in < ncorner; in++ )
+        {
+          const int n1  = inodes[in];
+          const int n2  = inodes[( in + 1 ) % ncorner];
+          const int m12 = globdat.isQuadratic ? inodes[ncorner + in] : n1;
+
+          if ( globdat.copiesOf ( n1 ).size () < 2 ||
+               globdat.copiesOf ( n2 ).size () < 2 ||
+               globdat.copiesOf ( m12 ).size () < 2 )
+          {
+            continue;
+          }
+
+          addInterface ( interConnec, n1, n2, m12, false, globdat );
+
+          sink_ += interConnec[0];
+          calls++;
+        }
+      }
+
+      return calls;
+    } ) ) );
+
+    kernels.push_back ( make_pair ( string ( "findCommonEdge" ), Sweep ( [&globdat, elemCount] ()
+    {
+      int  p1, p2, p12;
+      long calls = 0;
+
+      for ( int ie = 0; ie < elemCount; ie++ )
+      {
+        const IntSpan inodes  = globdat.elemSet[ie]->getNodes0 ();
+        const int     ncorner = globdat.elemSet[ie]->getCornerCount ();
+
+        for ( int in = 0; in < ncorner; in++ )
+        {
+          sink_ += findCommonEdge ( p1, p2, p12, inodes[in], ie, in, globdat );
+          calls++;
+        }
+      }
+
+      return calls;
+    } ) ) );
+  }
+}
+
+// =====================================================================
+//     main program
+// =====================================================================
+
+int main ( int argc, char* argv[] )
+{
+  string     dir         ( "bench-out" );
+  string     flags       ( "unknown" );
+
+  StrVector  types       = toWords_ ( "tri3,tri6,quad4,quad8,tet4,tet10,hex8,hex20" );
+  StrVector  only;
+
+  MeshSpec   spec;
+
+  int        size2D      = 64;
+  int        size3D      = 10;
+  int        sampleCount = 15;
+  double     sampleTime  = 0.02;
+
+  spec.domainCount = 3;
+  spec.jitter      = 0.2;
+
+  for ( int i = 1; i < argc; i++ )
+  {
+    const string arg ( argv[i] );
+
+    if ( arg != "--help" && i + 1 >= argc )
+    {
+      cerr << "missing value for " << arg << "!!!\n";
+      return 1;
+    }
+
+    if      ( arg == "--dir"         ) dir         = argv[++i];
+    else if ( arg == "--flags"       ) flags       = argv[++i];
+    else if ( arg == "--types"       ) types       = toWords_ ( argv[++i] );
+    else if ( arg == "--kernels"     ) only        = toWords_ ( argv[++i] );
+    else if ( arg == "--size-2d"     ) size2D      = boost::lexical_cast<int>      ( argv[++i] );
+    else if ( arg == "--size-3d"     ) size3D      = boost::lexical_cast<int>      ( argv[++i] );
+    else if ( arg == "--samples"     ) sampleCount = boost::lexical_cast<int>      ( argv[++i] );
+    else if ( arg == "--sample-time" ) sampleTime  = boost::lexical_cast<double>   ( argv[++i] );
+    else if ( arg == "--seed"        ) spec.seed   = boost::lexical_cast<unsigned> ( argv[++i] );
+    else if ( arg == "--help" )
+    {
+      cout << "USAGE:\n";
+      cout << "  * --dir         DIR        work directory for the meshes (bench-out)\n";
+      cout << "  * --flags       STR        the build flags, for the report (unknown)\n";
+      cout << "  * --types       T1,T2,...  element types (tri3,tri6,quad4,quad8,tet4,tet10,hex8,hex20)\n";
+      cout << "  * --kernels     K1,K2,...  run these kernels only (all)\n";
+      cout << "  * --size-2d     N          cells per side of the 2D meshes (64)\n";
+      cout << "  * --size-3d     N          cells per side of the 3D meshes (10)\n";
+      cout << "  * --samples     N          samples per kernel (15)\n";
+      cout << "  * --sample-time X          seconds per sample (0.02)\n";
+      cout << "  * --seed        N          seed of the random numbers (1)\n";
+      cout << endl;
+      return 0;
+    }
+    else
+    {
+      cerr << "invalid argument, use \"--help\" for more information\n";
+      return 1;
+    }
+  }
+
+  if ( sampleCount < 1 )
+  {
+    cerr << "invalid number of samples!!!\n";
+    return 1;
+  }
+
+  if ( system ( ( "mkdir -p " + dir ).c_str () ) != 0 )
+  {
+    cerr << "Unable to create " << dir << "!!!\n";
+    return 1;
+  }
+
+  cout << "built with " << flags << "\n\n";
+
+  cout << "type   kernel                        calls   median [ns]  min [ns]  stddev  cycles\n" << flush;
+
+  for ( size_t it = 0; it < types.size (); it++ )
+  {
+    if ( !isKnownElemType ( types[it] ) )
+    {
+      cerr << "unknown element type " << types[it] << "!!!\n";
+      return 1;
+    }
+
+    spec.elemType = types[it];
+    spec.size     = types[it].compare ( 0, 3, "tet" ) == 0 ||
+                    types[it].compare ( 0, 3, "hex" ) == 0 ? size3D : size2D;
+
+    const string fileName = dir + "/micro-" + spec.elemType + ".msh";
+
+    generateMesh ( spec, fileName.c_str () );
+
+    // new Globals per mesh; their arenas go with them
+
+    Global* globdat  = new Global;
+    Global* ifacedat = new Global;
+
+    loadMesh_ ( *globdat,  fileName, false );
+    loadMesh_ ( *ifacedat, fileName, true  );
+
+    vector<pair<string,Sweep> > kernels;
+
+    addKernels_ ( kernels, *globdat, *ifacedat );
+
+    for ( size_t ik = 0; ik < kernels.size (); ik++ )
+    {
+      if ( !only.empty () &&
+           find ( only.begin (), only.end (), kernels[ik].first ) == only.end () )
+      {
+        continue;
+      }
+
+      const Stats_ s = measure_ ( kernels[ik].second, sampleCount, sampleTime );
+
+      char line[256];
+
+      snprintf ( line, sizeof(line), "%-6s %-28s %8ld %12.2f %9.2f %7.2f %7.1f\n",
+                 spec.elemType.c_str (), kernels[ik].first.c_str (), s.calls,
+                 s.median, s.minimum, s.stdDev, s.cycles );
+
+      cout << line << flush;
+    }
+
+    delete globdat;
+    delete ifacedat;
+
+    remove ( fileName.c_str () );
+  }
+
+  return 0;
+}
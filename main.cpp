@@ -64,7 +64,7 @@
  */
 
 
-#include "Node.h"
+#include "NodeStore.h"
 #include "Element.h"
 #include "Global.h"
 #include "utilities.h"
@@ -73,6 +73,8 @@
 #include "MeshWriter.h"
 #include "MeshReader.h"
 #include "InterfaceWriter.h"
+#include "TaskPool.h"
+#include "Profile.h"
 
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
@@ -99,6 +101,7 @@ int main ( int argc, char* argv[] )
   bool     gotnMeshFile = false;
   bool     gotiMeshFile = false;
   bool     gotParaFile  = false;
+  bool     useCache     = false;
 
   for ( size_t i = 1; i < argc; i++ )
   {
@@ -206,6 +209,28 @@ int main ( int argc, char* argv[] )
     {
       globdat.isConverter = true;
     }
+    else if  ( string(argv[i]) == string("--mapped-read") )
+    {
+      globdat.isMappedRead = true;
+    }
+    else if  ( string(argv[i]) == string("--threads") )
+    {
+      globdat.threadCount = boost::lexical_cast<int> ( argv[++i] );
+
+      if ( globdat.threadCount < 1 )
+      {
+        cerr << "invalid number of threads!!!\n";
+        return 1;
+      }
+    }
+    else if  ( string(argv[i]) == string("--cache") )
+    {
+      useCache = true;
+    }
+    else if  ( string(argv[i]) == string("--profile") )
+    {
+      globdat.profileFile = argv[++i];
+    }
     else if  ( string(argv[i]) == string("--help") )
     {
       cout << "USAGE:\n";
@@ -222,6 +247,10 @@ int main ( int argc, char* argv[] )
       cout << "  * --notches        x1 y1 x2 y2 x3 y3 ... existing notch(duplicate nodes but no interface there)\n";
       cout << "  * --noInterface    x1 y1 x2 y2  no duplicated nodes, no interface elements along this line\n";
       cout << "  * --converter                   convert Gmsh to jem/jive format (no interface elements)\n";
+      cout << "  * --mapped-read                 read Gmsh (ASCII 2.x) files through a memory map\n";
+      cout << "  * --threads        N            use N threads for the parallel stages\n";
+      cout << "  * --cache                       keep the mesh and its topology in FILE.cache (mesh file FILE)\n";
+      cout << "  * --profile        FILE         write the time and memory of each phase to FILE (JSON)\n";
       cout << "  * --help                        print this help and exit\n";
       cout << endl;
       return 0 ;
@@ -264,14 +293,72 @@ int main ( int argc, char* argv[] )
     paraviewFile = spMeshFile[0] + ".vtu";
   }
 
-  // doing stuff 
+  if ( useCache )
+  {
+    globdat.cacheFile = meshFile + ".cache";
+  }
+
+  // doing stuff; the parallel loops of all stages run on the pool
 
+  TaskPool pool ( globdat.threadCount );
+  Profile& profile = globdat.profile;
+
+  int      phase;
+
+  phase = profile.start  ( "parse" );
   readMesh               ( globdat, meshFile.c_str()   );
+  profile.stop           ( phase, globdat.elemSet.size () );
+
+  // the element sizes overlap with building the support and tearing
+
+  double   smallestSize;
+  int      sizeTask = pool.submit ( [&] ()
+  {
+    int phase = profile.start ( "element size" );
+    smallestSize = computeSmallestSize ( globdat );
+    profile.stop  ( phase, globdat.elemSet.size () );
+  } );
+
   MeshModifier::    doIt ( globdat                     );
+
+  pool.wait              ( sizeTask );
+
+  cout << "Smallest element size......................... " << smallestSize << "\n\n";
+
+  // nodes and bulk elements no longer change: they are formatted for
+  // the jem mesh file while the interface elements are built
+
+  string   bulkText;
+  int      formatTask = TaskPool::NONE;
+
+  if ( globdat.threadCount > 1 && !globdat.outAbaqus )
+  {
+    formatTask = pool.submit ( [&] ()
+    {
+      int phase = profile.start ( "format bulk" );
+      formatJemBulk ( globdat, bulkText );
+      profile.stop  ( phase, globdat.newNodeSet.size () + globdat.elemSet.size () );
+    } );
+  }
+
+  phase = profile.start  ( "interface build" );
   InterfaceBuilder::doIt ( globdat                     );
+  profile.stop           ( phase, globdat.interfaceSet.size () );
+
+  pool.wait              ( formatTask );
 
-  writeMesh              ( globdat, newMeshFile.c_str());
+  phase = profile.start  ( "write mesh" );
+  writeMesh              ( globdat, newMeshFile.c_str(), bulkText );
+  profile.stop           ( phase, globdat.newNodeSet.size () + globdat.elemSet.size () );
+
+  phase = profile.start  ( "write interface" );
   writeInterface         ( globdat, interfaceFile.c_str() );
+  profile.stop           ( phase, globdat.interfaceSet.size () );
+
+  if ( !globdat.profileFile.empty () )
+  {
+    writeProfile ( globdat, globdat.profileFile.c_str(), meshFile );
+  }
 
   return 0;
 }
@@ -11,11 +11,9 @@
 #include <iterator>
 #include <limits>
 #include <math.h>
-#include <boost/shared_ptr.hpp>
 
 using namespace std;
 
-class Node;
 class Element;
 
 typedef vector<string>             StrVector;
@@ -24,9 +22,7 @@ typedef set<int>                   IntSet;
 typedef map<int, IntVector>        Int2IntVectMap;
 typedef map<int,int>               Int2IntMap;
 typedef map<int,IntSet>            Int2IntSetMap;
-typedef boost::shared_ptr<Node>    NodePointer;
-typedef boost::shared_ptr<Element> ElemPointer;
-typedef vector<NodePointer>        NodeSet;
+typedef Element*                   ElemPointer; // owned by Global::elemArena
 typedef vector<ElemPointer>        ElemSet;
 
 #endif